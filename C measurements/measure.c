@@ -7,16 +7,123 @@
 #include <unistd.h>
 #include <sched.h>
 #include <stdint.h>
+#include <string.h>
 #include <cjson/cJSON.h>
 #include <stdatomic.h>
 
 #define NUM_TESTS 100
-#define CREATION_ITERATIONS 10000
-#define CONTEXT_SWITCH_ITERATIONS 10000
-#define MIGRATION_ITERATIONS 10000
 #define NUM_ARRAY_SIZES 8
+#define ITERATION_VALUES_COUNT 5
 
 int ARRAY_SIZES[NUM_ARRAY_SIZES] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
+int ITERATIONS[ITERATION_VALUES_COUNT] = {2, 10, 100, 1000, 10000};
+
+#ifndef KERNEL_SPEC_PATH
+#define KERNEL_SPEC_PATH "../kernel_spec.json"
+#endif
+
+// Build stamp written into every result. The CMake build defines
+// BENCH_PROFILE and BENCH_CFLAGS; other builds fall back to "unspecified".
+#ifndef BENCH_PROFILE
+#define BENCH_PROFILE "unspecified"
+#endif
+#ifndef BENCH_CFLAGS
+#define BENCH_CFLAGS "unspecified"
+#endif
+#if defined(__clang__)
+#define BENCH_COMPILER "clang " __clang_version__
+#elif defined(__GNUC__)
+#define BENCH_COMPILER "gcc " __VERSION__
+#else
+#define BENCH_COMPILER "unknown"
+#endif
+
+// Checksum of the last kernel call. Every sample is compared with the value
+// kernel_spec.json expects for its point, so C, C++ and Java results can only
+// be compared when they provably ran the same workload.
+uint64_t kernelChecksum;
+cJSON *kernelSpec = NULL;
+
+int sweepMatchesSpec(const char *name, const int *values, int count)
+{
+    cJSON *sweep = cJSON_GetObjectItem(kernelSpec, name);
+    if (!cJSON_IsArray(sweep) || cJSON_GetArraySize(sweep) != count)
+    {
+        return 0;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (cJSON_GetArrayItem(sweep, i)->valueint != values[i])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Loads the spec once; KERNEL_SPEC in the environment overrides its path.
+// Returns 0 if it is missing or this harness sweeps different parameters.
+int loadKernelSpec(void)
+{
+    if (kernelSpec != NULL)
+    {
+        return 1;
+    }
+    const char *path = getenv("KERNEL_SPEC");
+    if (path == NULL)
+    {
+        path = KERNEL_SPEC_PATH;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Failed to open kernel spec %s\n", path);
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *content = (char *)malloc(fileSize + 1);
+    if (content == NULL)
+    {
+        fclose(file);
+        return 0;
+    }
+    content[fread(content, 1, fileSize, file)] = '\0';
+    fclose(file);
+
+    kernelSpec = cJSON_Parse(content);
+    free(content);
+    if (kernelSpec == NULL)
+    {
+        fprintf(stderr, "Failed to parse kernel spec %s\n", path);
+        return 0;
+    }
+    if (!sweepMatchesSpec("array_sizes", ARRAY_SIZES, NUM_ARRAY_SIZES) || !sweepMatchesSpec("iterations", ITERATIONS, ITERATION_VALUES_COUNT))
+    {
+        fprintf(stderr, "ARRAY_SIZES or ITERATIONS differ from kernel spec %s\n", path);
+        cJSON_Delete(kernelSpec);
+        kernelSpec = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+uint64_t expectedChecksum(const char *process, int point)
+{
+    cJSON *kernel = NULL;
+    cJSON_ArrayForEach(kernel, cJSON_GetObjectItem(kernelSpec, "kernels"))
+    {
+        cJSON *name = cJSON_GetObjectItem(kernel, "process");
+        if (cJSON_IsString(name) && strcmp(name->valuestring, process) == 0)
+        {
+            cJSON *expected = cJSON_GetArrayItem(cJSON_GetObjectItem(kernel, "expected"), point);
+            return cJSON_IsNumber(expected) ? (uint64_t)expected->valuedouble : UINT64_MAX;
+        }
+    }
+    return UINT64_MAX;
+}
 
 double calculateAverage(double *times, int size)
 {
@@ -67,12 +174,13 @@ double measureStaticMemoryAccess(int size)
 
     struct timespec start, end;
     clock_gettime(CLOCK_MONOTONIC, &start);
-    int sum = 0;
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
         sum += staticArray[i];
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
+    kernelChecksum = sum;
 
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
     return time / size;
@@ -94,12 +202,13 @@ double measureDynamicMemoryAccess(int size)
 
     struct timespec start, end;
     clock_gettime(CLOCK_MONOTONIC, &start);
-    int sum = 0;
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
         sum += dynamicArray[i];
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
+    kernelChecksum = sum;
 
     free(dynamicArray);
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
@@ -128,11 +237,15 @@ double measureMemoryAllocation(int size)
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
 
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
+        *chunks[i] = i;
+        sum += *chunks[i];
         free(chunks[i]);
     }
     free(chunks);
+    kernelChecksum = sum;
 
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
     return time / size;
@@ -141,13 +254,14 @@ double measureMemoryAllocation(int size)
 double measureMemoryDeallocation(int size)
 {
     struct timespec start, end;
-    void **chunks = malloc(size * sizeof(void *));
+    int **chunks = malloc(size * sizeof(int *));
     if (!chunks)
     {
         perror("Failed to allocate memory for chunk pointers");
         exit(EXIT_FAILURE);
     }
 
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
         chunks[i] = (int *)malloc(sizeof(int));
@@ -156,7 +270,10 @@ double measureMemoryDeallocation(int size)
             perror("Failed to allocate memory for a chunk");
             exit(EXIT_FAILURE);
         }
+        *chunks[i] = i;
+        sum += *chunks[i];
     }
+    kernelChecksum = sum;
 
     clock_gettime(CLOCK_MONOTONIC, &start);
     for (int i = 0; i < size; i++)
@@ -178,17 +295,20 @@ void *CreateThreadFunction(void *arg)
     {
         sum += i;
     }
+    *(uint64_t *)arg = sum;
     return NULL;
 }
 
-double measureThreadCreationTime()
+double measureThreadCreationTime(int iterations)
 {
     struct timespec start, end;
+    uint64_t checksum = 0;
     clock_gettime(CLOCK_MONOTONIC, &start);
-    for (int i = 0; i < CREATION_ITERATIONS; i++)
+    for (int i = 0; i < iterations; i++)
     {
         pthread_t thread;
-        if (pthread_create(&thread, NULL, CreateThreadFunction, NULL) != 0)
+        uint64_t result = 0;
+        if (pthread_create(&thread, NULL, CreateThreadFunction, &result) != 0)
         {
             perror("Failed to create thread");
             exit(EXIT_FAILURE);
@@ -198,23 +318,26 @@ double measureThreadCreationTime()
             perror("Failed to join thread");
             exit(EXIT_FAILURE);
         }
+        checksum += result;
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
+    kernelChecksum = checksum;
 
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
-    return time / CREATION_ITERATIONS;
+    return time / iterations;
 }
 
-double measureContextSwitchTime()
+double measureContextSwitchTime(int iterations)
 {
     pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
     pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
     int turn = 1;
+    uint64_t handoffs = 0;
 
     void *switchTask(void *arg)
     {
         int *turnPtr = (int *)arg;
-        for (int i = 0; i < CONTEXT_SWITCH_ITERATIONS / 2; ++i)
+        for (int i = 0; i < iterations / 2; ++i)
         {
             pthread_mutex_lock(&mutex);
             while (turn != *turnPtr)
@@ -222,6 +345,7 @@ double measureContextSwitchTime()
                 pthread_cond_wait(&cond, &mutex);
             }
             turn = (turn == 1) ? 2 : 1;
+            handoffs++;
             pthread_cond_signal(&cond);
             pthread_mutex_unlock(&mutex);
         }
@@ -255,11 +379,12 @@ double measureContextSwitchTime()
     }
 
     clock_gettime(CLOCK_MONOTONIC, &end);
+    kernelChecksum = handoffs;
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
-    return time / CONTEXT_SWITCH_ITERATIONS;
+    return time / iterations;
 }
 
-double measureThreadMigrationTime()
+double measureThreadMigrationTime(int iterations)
 {
     cpu_set_t cpuset;
     CPU_ZERO(&cpuset);
@@ -289,12 +414,14 @@ double measureThreadMigrationTime()
         exit(EXIT_FAILURE);
     }
     struct timespec start, end;
+    uint64_t migrations = 0;
     clock_gettime(CLOCK_MONOTONIC, &start);
-    for (int i = 0; i < MIGRATION_ITERATIONS; i++)
+    for (int i = 0; i < iterations; i++)
     {
         CPU_ZERO(&cpuset);
         CPU_SET(i % 2, &cpuset);
         int s2 = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+        migrations += s2 == 0;
         if (s2 != 0)
         {
             perror("Failed to set affinity in iteration");
@@ -302,6 +429,7 @@ double measureThreadMigrationTime()
         }
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
+    kernelChecksum = migrations;
 
     if (pthread_join(thread, NULL) != 0)
     {
@@ -309,10 +437,10 @@ double measureThreadMigrationTime()
         exit(EXIT_FAILURE);
     }
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
-    return time / MIGRATION_ITERATIONS;
+    return time / iterations;
 }
 
-void saveResultsToJSON(FILE *file, double average, double stdDev, const char *process, int numTests, int passedTests, const char *language, int arraySize, double threshold, int isFirstEntry)
+void saveResultsToJSON(FILE *file, double average, double stdDev, const char *process, int numTests, int passedTests, const char *language, int arraySize, double threshold, int iterations, uint64_t checksum, int mismatches, int isFirstEntry)
 {
     if (!isFirstEntry)
     {
@@ -324,6 +452,10 @@ void saveResultsToJSON(FILE *file, double average, double stdDev, const char *pr
     {
         cJSON_AddNumberToObject(json, "array_size", arraySize);
     }
+    if (iterations > 0)
+    {
+        cJSON_AddNumberToObject(json, "iterations", iterations);
+    }
     cJSON_AddNumberToObject(json, "number_of_tests", numTests);
     cJSON_AddNumberToObject(json, "passed_tests", passedTests);
     cJSON_AddNumberToObject(json, "outlier_threshold", threshold);
@@ -331,6 +463,15 @@ void saveResultsToJSON(FILE *file, double average, double stdDev, const char *pr
     cJSON_AddStringToObject(json, "process_measured", process);
     cJSON_AddNumberToObject(json, "average_time", average);
     cJSON_AddNumberToObject(json, "std_deviation", stdDev);
+    cJSON_AddNumberToObject(json, "checksum", (double)checksum);
+    cJSON_AddBoolToObject(json, "checksum_valid", mismatches == 0);
+    cJSON_AddStringToObject(json, "compiler", BENCH_COMPILER);
+    cJSON_AddStringToObject(json, "compiler_flags", BENCH_CFLAGS);
+    cJSON_AddStringToObject(json, "build_profile", BENCH_PROFILE);
+    if (mismatches > 0)
+    {
+        fprintf(stderr, "%s: %d samples did not match the kernel spec checksum (last %llu)\n", process, mismatches, (unsigned long long)checksum);
+    }
 
     char *jsonString = cJSON_Print(json);
     if (jsonString == NULL)
@@ -434,10 +575,13 @@ void StaticAccessMain(int numTests, double threshold)
     {
         int size = ARRAY_SIZES[j];
         int staticSize = 0;
+        uint64_t expected = expectedChecksum("Static Memory Access", j);
+        int mismatches = 0;
 
         for (int i = 0; i < numTests; i++)
         {
             staticAccessTimes[staticSize++] = measureStaticMemoryAccess(size);
+            mismatches += kernelChecksum != expected;
         }
 
         removeOutliers(staticAccessTimes, &staticSize, threshold);
@@ -446,7 +590,7 @@ void StaticAccessMain(int numTests, double threshold)
         {
             double staticAverage = calculateAverage(staticAccessTimes, staticSize);
             double staticStdDev = calculateStandardDeviation(staticAccessTimes, staticAverage, staticSize);
-            saveResultsToJSON(staticAccessFile, staticAverage, staticStdDev, "Static Memory Access", numTests, staticSize, "C", size, threshold, (j == 0));
+            saveResultsToJSON(staticAccessFile, staticAverage, staticStdDev, "Static Memory Access", numTests, staticSize, "C", size, threshold, 0, kernelChecksum, mismatches, (j == 0));
         }
         else
         {
@@ -473,10 +617,13 @@ void DynamicAccessMain(int numTests, double threshold)
     {
         int size = ARRAY_SIZES[j];
         int dynamicSize = 0;
+        uint64_t expected = expectedChecksum("Dynamic Memory Access", j);
+        int mismatches = 0;
 
         for (int i = 0; i < numTests; i++)
         {
             dynamicAccessTimes[dynamicSize++] = measureDynamicMemoryAccess(size);
+            mismatches += kernelChecksum != expected;
         }
 
         removeOutliers(dynamicAccessTimes, &dynamicSize, threshold);
@@ -485,7 +632,7 @@ void DynamicAccessMain(int numTests, double threshold)
         {
             double dynamicAverage = calculateAverage(dynamicAccessTimes, dynamicSize);
             double dynamicStdDev = calculateStandardDeviation(dynamicAccessTimes, dynamicAverage, dynamicSize);
-            saveResultsToJSON(dynamicAccessFile, dynamicAverage, dynamicStdDev, "Dynamic Memory Access", numTests, dynamicSize, "C", size, threshold, (j == 0));
+            saveResultsToJSON(dynamicAccessFile, dynamicAverage, dynamicStdDev, "Dynamic Memory Access", numTests, dynamicSize, "C", size, threshold, 0, kernelChecksum, mismatches, (j == 0));
         }
         else
         {
@@ -512,10 +659,13 @@ void AllocationMain(int numTests, double threshold)
     {
         int size = ARRAY_SIZES[j];
         int allocSize = 0;
+        uint64_t expected = expectedChecksum("Memory Allocation", j);
+        int mismatches = 0;
 
         for (int i = 0; i < numTests; i++)
         {
             allocTimes[allocSize++] = measureMemoryAllocation(size);
+            mismatches += kernelChecksum != expected;
         }
 
         removeOutliers(allocTimes, &allocSize, threshold);
@@ -524,7 +674,7 @@ void AllocationMain(int numTests, double threshold)
         {
             double allocAverage = calculateAverage(allocTimes, allocSize);
             double allocStdDev = calculateStandardDeviation(allocTimes, allocAverage, allocSize);
-            saveResultsToJSON(allocationFile, allocAverage, allocStdDev, "Memory Allocation", numTests, allocSize, "C", size, threshold, (j == 0));
+            saveResultsToJSON(allocationFile, allocAverage, allocStdDev, "Memory Allocation", numTests, allocSize, "C", size, threshold, 0, kernelChecksum, mismatches, (j == 0));
         }
         else
         {
@@ -551,10 +701,13 @@ void DeallocationMain(int numTests, double threshold)
     {
         int size = ARRAY_SIZES[j];
         int deallocSize = 0;
+        uint64_t expected = expectedChecksum("Memory Deallocation", j);
+        int mismatches = 0;
 
         for (int i = 0; i < numTests; i++)
         {
             deallocTimes[deallocSize++] = measureMemoryDeallocation(size);
+            mismatches += kernelChecksum != expected;
         }
 
         removeOutliers(deallocTimes, &deallocSize, threshold);
@@ -563,7 +716,7 @@ void DeallocationMain(int numTests, double threshold)
         {
             double deallocAverage = calculateAverage(deallocTimes, deallocSize);
             double deallocStdDev = calculateStandardDeviation(deallocTimes, deallocAverage, deallocSize);
-            saveResultsToJSON(deallocationFile, deallocAverage, deallocStdDev, "Memory Deallocation", numTests, deallocSize, "C", size, threshold, (j == 0));
+            saveResultsToJSON(deallocationFile, deallocAverage, deallocStdDev, "Memory Deallocation", numTests, deallocSize, "C", size, threshold, 0, kernelChecksum, mismatches, (j == 0));
         }
         else
         {
@@ -586,22 +739,31 @@ void ThreadCreationMain(int numTests, double threshold)
     }
     fprintf(threadCreationFile, "[\n");
 
-    for (int i = 0; i < numTests; i++)
+    for (int iterIndex = 0; iterIndex < ITERATION_VALUES_COUNT; iterIndex++)
     {
-        threadCreationTimes[i] = measureThreadCreationTime();
-    }
+        int iterations = ITERATIONS[iterIndex];
+        int creationSize = 0;
+        uint64_t expected = expectedChecksum("Thread Creation", iterIndex);
+        int mismatches = 0;
 
-    removeOutliers(threadCreationTimes, &numTests, threshold);
+        for (int i = 0; i < numTests; i++)
+        {
+            threadCreationTimes[creationSize++] = measureThreadCreationTime(iterations);
+            mismatches += kernelChecksum != expected;
+        }
 
-    if (numTests)
-    {
-        double creationAverage = calculateAverage(threadCreationTimes, numTests);
-        double creationStdDev = calculateStandardDeviation(threadCreationTimes, creationAverage, numTests);
-        saveResultsToJSON(threadCreationFile, creationAverage, creationStdDev, "Thread Creation", numTests, numTests, "C", 0, threshold, 1);
-    }
-    else
-    {
-        fprintf(stderr, "All thread creation times were outliers\n");
+        removeOutliers(threadCreationTimes, &creationSize, threshold);
+
+        if (creationSize)
+        {
+            double creationAverage = calculateAverage(threadCreationTimes, creationSize);
+            double creationStdDev = calculateStandardDeviation(threadCreationTimes, creationAverage, creationSize);
+            saveResultsToJSON(threadCreationFile, creationAverage, creationStdDev, "Thread Creation", numTests, creationSize, "C", 0, threshold, iterations, kernelChecksum, mismatches, (iterIndex == 0));
+        }
+        else
+        {
+            fprintf(stderr, "All thread creation times were outliers for %d iterations\n", iterations);
+        }
     }
 
     fprintf(threadCreationFile, "\n]");
@@ -619,22 +781,31 @@ void ContextSwitchMain(int numTests, double threshold)
     }
     fprintf(contextSwitchFile, "[\n");
 
-    for (int i = 0; i < numTests; i++)
+    for (int iterIndex = 0; iterIndex < ITERATION_VALUES_COUNT; iterIndex++)
     {
-        contextSwitchTimes[i] = measureContextSwitchTime();
-    }
+        int iterations = ITERATIONS[iterIndex];
+        int contextSwitchSize = 0;
+        uint64_t expected = expectedChecksum("Context Switch", iterIndex);
+        int mismatches = 0;
 
-    removeOutliers(contextSwitchTimes, &numTests, threshold);
+        for (int i = 0; i < numTests; i++)
+        {
+            contextSwitchTimes[contextSwitchSize++] = measureContextSwitchTime(iterations);
+            mismatches += kernelChecksum != expected;
+        }
 
-    if (numTests)
-    {
-        double switchAverage = calculateAverage(contextSwitchTimes, numTests);
-        double switchStdDev = calculateStandardDeviation(contextSwitchTimes, switchAverage, numTests);
-        saveResultsToJSON(contextSwitchFile, switchAverage, switchStdDev, "Context Switch", numTests, numTests, "C", 0, threshold, 1);
-    }
-    else
-    {
-        fprintf(stderr, "All context switch times were outliers\n");
+        removeOutliers(contextSwitchTimes, &contextSwitchSize, threshold);
+
+        if (contextSwitchSize)
+        {
+            double switchAverage = calculateAverage(contextSwitchTimes, contextSwitchSize);
+            double switchStdDev = calculateStandardDeviation(contextSwitchTimes, switchAverage, contextSwitchSize);
+            saveResultsToJSON(contextSwitchFile, switchAverage, switchStdDev, "Context Switch", numTests, contextSwitchSize, "C", 0, threshold, iterations, kernelChecksum, mismatches, (iterIndex == 0));
+        }
+        else
+        {
+            fprintf(stderr, "All context switch times were outliers for %d iterations\n", iterations);
+        }
     }
 
     fprintf(contextSwitchFile, "\n]");
@@ -652,22 +823,31 @@ void ThreadMigrationMain(int numTests, double threshold)
     }
     fprintf(migrationFile, "[\n");
 
-    for (int i = 0; i < numTests; i++)
+    for (int iterIndex = 0; iterIndex < ITERATION_VALUES_COUNT; iterIndex++)
     {
-        migrationTimes[i] = measureThreadMigrationTime();
-    }
+        int iterations = ITERATIONS[iterIndex];
+        int migrationSize = 0;
+        uint64_t expected = expectedChecksum("Thread Migration", iterIndex);
+        int mismatches = 0;
 
-    removeOutliers(migrationTimes, &numTests, threshold);
+        for (int i = 0; i < numTests; i++)
+        {
+            migrationTimes[migrationSize++] = measureThreadMigrationTime(iterations);
+            mismatches += kernelChecksum != expected;
+        }
 
-    if (numTests)
-    {
-        double migrationAverage = calculateAverage(migrationTimes, numTests);
-        double migrationStdDev = calculateStandardDeviation(migrationTimes, migrationAverage, numTests);
-        saveResultsToJSON(migrationFile, migrationAverage, migrationStdDev, "Thread Migration", numTests, numTests, "C", 0, threshold, 1);
-    }
-    else
-    {
-        fprintf(stderr, "All thread migration times were outliers\n");
+        removeOutliers(migrationTimes, &migrationSize, threshold);
+
+        if (migrationSize)
+        {
+            double migrationAverage = calculateAverage(migrationTimes, migrationSize);
+            double migrationStdDev = calculateStandardDeviation(migrationTimes, migrationAverage, migrationSize);
+            saveResultsToJSON(migrationFile, migrationAverage, migrationStdDev, "Thread Migration", numTests, migrationSize, "C", 0, threshold, iterations, kernelChecksum, mismatches, (iterIndex == 0));
+        }
+        else
+        {
+            fprintf(stderr, "All thread migration times were outliers for %d iterations\n", iterations);
+        }
     }
 
     fprintf(migrationFile, "\n]");
@@ -684,6 +864,10 @@ int main(int argc, char *argv[])
 
     int numTests = atoi(argv[1]);
     double threshold = atof(argv[2]);
+    if (!loadKernelSpec())
+    {
+        return 1;
+    }
 
     StaticAccessMain(numTests, threshold);
     DynamicAccessMain(numTests, threshold);
@@ -0,0 +1,134 @@
+#include <cctype>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <sched.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using ordered_json = nlohmann::ordered_json;
+
+// Compiler comparison driver. Every library it is given is measure.cpp built
+// with -DMEASURE_LIBRARY by a different toolchain (BENCH_COMPILERS in
+// CMakeLists.txt). Each one is loaded with dlopen, runs the whole suite in its
+// own directory under C++_compilers/, and its results are merged into
+// C++_compilers.json tagged with the compiler that built it.
+
+#ifndef KERNEL_SPEC_PATH
+#define KERNEL_SPEC_PATH "../kernel_spec.json"
+#endif
+
+const std::string OUTPUT_DIRECTORY = "C++_compilers";
+const std::string OUTPUT_FILE = "C++_compilers.json";
+const size_t MAX_DIRECTORY_NAME = 48;
+
+typedef int (*BenchmarkMain)(int, char **);
+typedef const char *(*BenchmarkCompiler)();
+
+std::string directoryName(size_t index, const std::string &compiler)
+{
+    std::string name = std::to_string(index) + "-";
+    for (char c : compiler)
+    {
+        if (name.size() >= MAX_DIRECTORY_NAME)
+            break;
+        name += std::isalnum(static_cast<unsigned char>(c)) || c == '.' || c == '-' ? c : '_';
+    }
+    return name;
+}
+
+bool runVariant(const std::string &library, size_t index, std::vector<std::string> args, ordered_json &combined)
+{
+    void *handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr)
+    {
+        std::cerr << "Failed to load " << library << ": " << dlerror() << std::endl;
+        return false;
+    }
+    auto compilerOf = reinterpret_cast<BenchmarkCompiler>(dlsym(handle, "benchmarkCompiler"));
+    auto benchmarkMain = reinterpret_cast<BenchmarkMain>(dlsym(handle, "benchmarkMain"));
+    if (compilerOf == nullptr || benchmarkMain == nullptr)
+    {
+        std::cerr << library << " is not a benchmark library (build it with -DMEASURE_LIBRARY)" << std::endl;
+        dlclose(handle);
+        return false;
+    }
+
+    std::string compiler = compilerOf();
+    std::filesystem::path directory = OUTPUT_DIRECTORY + "/" + directoryName(index, compiler);
+    std::filesystem::create_directories(directory);
+    std::cout << "Running " << library << " built by " << compiler << "\n";
+
+    std::vector<char *> argv;
+    for (std::string &arg : args)
+        argv.push_back(arg.data());
+    argv.push_back(nullptr);
+
+    std::filesystem::path home = std::filesystem::current_path();
+    // A variant may narrow this thread's affinity for its result writer;
+    // every variant has to start from the same set of CPUs.
+    cpu_set_t affinity;
+    bool savedAffinity = sched_getaffinity(0, sizeof(affinity), &affinity) == 0;
+    std::filesystem::current_path(directory);
+    int status = benchmarkMain(static_cast<int>(args.size()), argv.data());
+    std::filesystem::current_path(home);
+    if (savedAffinity)
+        sched_setaffinity(0, sizeof(affinity), &affinity);
+    dlclose(handle);
+    if (status != 0)
+    {
+        std::cerr << compiler << " variant exited with status " << status << std::endl;
+        return false;
+    }
+
+    std::ifstream results(directory / "C++_results.json");
+    ordered_json records = ordered_json::parse(results, nullptr, false);
+    if (!records.is_array())
+    {
+        std::cerr << "No results from the " << compiler << " variant" << std::endl;
+        return false;
+    }
+    for (auto &record : records)
+    {
+        record["compiler"] = compiler;
+        combined.push_back(record);
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << " <number_of_tests> <outlier_threshold> [--force] <libmeasure_cpp.so>...\n";
+        return 1;
+    }
+
+    std::vector<std::string> args = {argv[0], argv[1], argv[2]};
+    std::vector<std::string> libraries;
+    for (int i = 3; i < argc; ++i)
+    {
+        if (std::string(argv[i]) == "--force")
+            args.push_back(argv[i]);
+        else
+            libraries.push_back(std::filesystem::absolute(argv[i]));
+    }
+
+    // The variants run in subdirectories, so pin the spec to an absolute path.
+    if (std::getenv("KERNEL_SPEC") == nullptr)
+        setenv("KERNEL_SPEC", std::filesystem::absolute(KERNEL_SPEC_PATH).c_str(), 1);
+
+    ordered_json combined = ordered_json::array();
+    int failures = 0;
+    for (size_t i = 0; i < libraries.size(); ++i)
+    {
+        failures += !runVariant(libraries[i], i, args, combined);
+    }
+
+    std::ofstream(OUTPUT_FILE) << combined.dump(4);
+    std::cout << "Wrote " << combined.size() << " results from " << libraries.size() - failures << " compiler(s) to " << OUTPUT_FILE << "\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -8,49 +8,138 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include <pthread.h>
 #include <nlohmann/json.hpp>
 #include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <cstdlib>
+#include <map>
+#include <variant>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <random>
+#include <set>
+#include <deque>
+#include <memory>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <sstream>
+#include <sys/utsname.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/statfs.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/magic.h>
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define HAVE_IO_URING 1
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "measure_common.h"
 
 using ordered_json = nlohmann::ordered_json;
 
-const int NUM_TESTS = 100;
 const std::vector<int> ARRAY_SIZES = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
-const int CREATION_ITERATIONS = 10000;
-const int CONTEXT_SWITCH_ITERATIONS = 10000;
-const int MIGRATION_ITERATIONS = 10000;
+const std::vector<int> ITERATIONS = {2, 10, 100, 1000, 10000};
+
+#ifndef KERNEL_SPEC_PATH
+#define KERNEL_SPEC_PATH "../kernel_spec.json"
+#endif
+
+// Build stamp written into every result. The CMake build defines
+// BENCH_PROFILE and BENCH_CFLAGS; other builds fall back to "unspecified".
+#ifndef BENCH_PROFILE
+#define BENCH_PROFILE "unspecified"
+#endif
+#ifndef BENCH_CFLAGS
+#define BENCH_CFLAGS "unspecified"
+#endif
+#if defined(__clang__)
+#define BENCH_COMPILER "clang " __clang_version__
+#elif defined(__GNUC__)
+#define BENCH_COMPILER "gcc " __VERSION__
+#else
+#define BENCH_COMPILER "unknown"
+#endif
+
+// Checksum of the last kernel call. Every sample is compared with the value
+// kernel_spec.json expects for its point, so C, C++ and Java results can only
+// be compared when they provably ran the same workload.
+const uint64_t NO_CHECKSUM = UINT64_MAX;
+uint64_t kernelChecksum = 0;
+ordered_json kernelSpec;
 
-double calculateAverage(const std::vector<double> &times)
+// KERNEL_SPEC in the environment overrides the compiled-in spec path.
+const char *kernelSpecPath()
 {
-    return std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    const char *path = std::getenv("KERNEL_SPEC");
+    return path == nullptr ? KERNEL_SPEC_PATH : path;
 }
 
-double calculateStandardDeviation(const std::vector<double> &times, double mean)
+// Loads the spec once. Returns false if it is missing or this harness sweeps
+// different parameters.
+bool loadKernelSpec()
 {
-    double variance = 0.0;
-    for (const auto &time : times)
+    if (!kernelSpec.is_null())
+        return true;
+    const char *path = kernelSpecPath();
+
+    std::ifstream file(path);
+    ordered_json spec = ordered_json::parse(file, nullptr, false);
+    if (!file.is_open() || spec.is_discarded() || !spec.contains("kernels"))
+    {
+        std::cerr << "Failed to load kernel spec " << path << std::endl;
+        return false;
+    }
+    if (spec["array_sizes"] != ordered_json(ARRAY_SIZES) || spec["iterations"] != ordered_json(ITERATIONS))
     {
-        variance += (time - mean) * (time - mean);
+        std::cerr << "ARRAY_SIZES or ITERATIONS differ from kernel spec " << path << std::endl;
+        return false;
     }
-    return std::sqrt(variance / times.size());
+    kernelSpec = std::move(spec);
+    return true;
 }
 
-void removeOutliers(std::vector<double> &times, double threshold)
+uint64_t expectedChecksum(const std::string &process, int parameter)
 {
-    double mean = calculateAverage(times);
-    double stdDev = calculateStandardDeviation(times, mean);
-
-    double lowerThreshold = mean - threshold * stdDev;
-    double upperThreshold = mean + threshold * stdDev;
-
-    times.erase(std::remove_if(times.begin(), times.end(),
-                               [lowerThreshold, upperThreshold](double time)
-                               {
-                                   return time < lowerThreshold || time > upperThreshold;
-                               }),
-                times.end());
+    for (const auto &kernel : kernelSpec["kernels"])
+    {
+        if (kernel.value("process", "") != process)
+            continue;
+        const auto &sweep = kernelSpec[kernel.value("parameter", "") == "array_size" ? "array_sizes" : "iterations"];
+        for (size_t point = 0; point < sweep.size() && point < kernel["expected"].size(); ++point)
+        {
+            if (sweep[point] == parameter)
+                return kernel["expected"][point].get<uint64_t>();
+        }
+    }
+    return NO_CHECKSUM;
 }
+const std::string HISTORY_FILE = "C++_history.jsonl";
+const std::string CACHE_DIRECTORY = "C++_cache";
+
+std::string runId;
+std::string gitRevision;
+ordered_json environment;
+bool forceRun = false;
+int cacheHits = 0;
 
 double measureStaticMemoryAccess(int size)
 {
@@ -61,12 +150,13 @@ double measureStaticMemoryAccess(int size)
     }
 
     auto start = std::chrono::high_resolution_clock::now();
-    int sum = 0;
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
         sum += staticArray[i];
     }
     auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = sum;
     double time = std::chrono::duration<double, std::nano>(end - start).count();
     return time / size;
 }
@@ -85,12 +175,13 @@ double measureDynamicMemoryAccess(int size)
     }
 
     auto start = std::chrono::high_resolution_clock::now();
-    int sum = 0;
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
         sum += dynamicArray[i];
     }
     auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = sum;
 
     delete[] dynamicArray;
     double time = std::chrono::duration<double, std::nano>(end - start).count();
@@ -112,10 +203,14 @@ double measureMemoryAllocation(int size)
     }
     auto end = std::chrono::high_resolution_clock::now();
 
+    uint64_t sum = 0;
     for (int i = 0; i < size; ++i)
     {
+        *chunks[i] = i;
+        sum += *chunks[i];
         delete chunks[i];
     }
+    kernelChecksum = sum;
     double time = std::chrono::duration<double, std::nano>(end - start).count();
     return time / size;
 }
@@ -124,15 +219,18 @@ double measureMemoryDeallocation(int size)
 {
     std::vector<int *> chunks(size);
 
+    uint64_t sum = 0;
     for (int i = 0; i < size; ++i)
     {
-        chunks[i] = new int;
+        chunks[i] = new int(i);
         if (chunks[i] == nullptr)
         {
             std::cerr << "Failed to allocate memory for a chunk" << std::endl;
             exit(EXIT_FAILURE);
         }
+        sum += *chunks[i];
     }
+    kernelChecksum = sum;
 
     auto start = std::chrono::high_resolution_clock::now();
     for (int i = 0; i < size; ++i)
@@ -145,62 +243,35 @@ double measureMemoryDeallocation(int size)
     return time / size;
 }
 
-void CreateThreadFunction()
+void CreateThreadFunction(uint64_t &result)
 {
     volatile int sum = 0;
     for (int i = 0; i < 1000; ++i)
     {
-        sum += i;
+        sum = sum + i;
     }
+    result = sum;
 }
 
-double measureThreadCreationTime()
+double measureThreadCreationTime(int iterations)
 {
+    uint64_t checksum = 0;
     auto start = std::chrono::high_resolution_clock::now();
-    for (int i = 0; i < CREATION_ITERATIONS; ++i)
+    for (int i = 0; i < iterations; ++i)
     {
-        std::thread t(CreateThreadFunction);
+        uint64_t result = 0;
+        std::thread t(CreateThreadFunction, std::ref(result));
         t.join();
+        checksum += result;
     }
     auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = checksum;
 
     double time = std::chrono::duration<double, std::nano>(end - start).count();
-    return time / CREATION_ITERATIONS;
+    return time / iterations;
 }
 
-double measureContextSwitchTime()
-{
-    std::mutex mtx;
-    std::condition_variable cv;
-    bool turn = true;
-
-    auto threadFunc = [&](bool myTurn)
-    {
-        for (int i = 0; i < CONTEXT_SWITCH_ITERATIONS / 2; ++i)
-        {
-            std::unique_lock<std::mutex> lock(mtx);
-            cv.wait(lock, [&]
-                    { return turn == myTurn; });
-            turn = !myTurn;
-            lock.unlock();
-            cv.notify_one();
-        }
-    };
-
-    auto start = std::chrono::high_resolution_clock::now();
-
-    std::thread t1(threadFunc, true);
-    std::thread t2(threadFunc, false);
-
-    t1.join();
-    t2.join();
-
-    auto end = std::chrono::high_resolution_clock::now();
-    double time = std::chrono::duration<double, std::nano>(end - start).count();
-    return time / CONTEXT_SWITCH_ITERATIONS;
-}
-
-double measureThreadMigrationTime()
+double measureThreadMigrationTime(int iterations)
 {
     cpu_set_t cpuset;
     CPU_ZERO(&cpuset);
@@ -210,7 +281,7 @@ double measureThreadMigrationTime()
         volatile int sum = 0;
         for (int i = 0; i < 1000; ++i)
         {
-            sum += i;
+            sum = sum + i;
         }
     };
 
@@ -223,312 +294,4998 @@ double measureThreadMigrationTime()
         perror("Error setting thread affinity");
     }
 
+    uint64_t migrations = 0;
     auto start = std::chrono::high_resolution_clock::now();
-    for (int i = 0; i < MIGRATION_ITERATIONS; ++i)
+    for (int i = 0; i < iterations; ++i)
     {
         CPU_ZERO(&cpuset);
         CPU_SET(i % 2, &cpuset);
         rc = pthread_setaffinity_np(t.native_handle(), sizeof(cpu_set_t), &cpuset);
+        migrations += rc == 0;
         if (rc != 0)
         {
             perror("Error setting thread affinity in iteration");
         }
     }
     auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = migrations;
 
     t.join();
 
     double time = std::chrono::duration<double, std::nano>(end - start).count();
-    return time / MIGRATION_ITERATIONS;
+    return time / iterations;
 }
 
-void saveResultsToJSON(const std::string &filename, double average, double stdDev, const std::string &process, int numTests, int passedTests, const std::string &language, int arraySize, double threshold)
+// Spin-wait hint for the hand-written locks below.
+inline void cpuRelax()
 {
-    ordered_json json;
-    std::ifstream file_in(filename);
-    if (file_in.is_open())
-    {
-        file_in >> json;
-        file_in.close();
-    }
-    else
-    {
-        json = ordered_json::array();
-    }
-
-    ordered_json result;
-    if (arraySize > 0)
-        result["array_size"] = arraySize;
-    result["number_of_tests"] = numTests;
-    result["passed_tests"] = passedTests;
-    result["outlier_threshold"] = threshold;
-    result["programming_language"] = language;
-    result["process_measured"] = process;
-    result["average_time"] = average;
-    result["std_deviation"] = stdDev;
-
-    json.push_back(result);
-
-    std::ofstream file_out(filename);
-    file_out << json.dump(4);
-    file_out.flush();
-    file_out.close();
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
 }
 
-void combineJSONFiles(const std::vector<std::string> &filenames, const std::string &outputFilename)
+// Queue node of the MCS lock. Each waiter spins on the flag of its own node,
+// so a handover touches one other core instead of every waiting one.
+struct alignas(64) McsNode
 {
-    ordered_json combinedResults = ordered_json::array();
+    std::atomic<McsNode *> next{nullptr};
+    std::atomic<bool> locked{false};
+};
 
-    for (const auto &filename : filenames)
+class McsLock
+{
+public:
+    void lock(McsNode &node)
     {
-        std::ifstream inputFile(filename);
-        if (inputFile.is_open())
-        {
-            ordered_json fileContent;
-            inputFile >> fileContent;
-            inputFile.close();
+        node.next.store(nullptr, std::memory_order_relaxed);
+        node.locked.store(true, std::memory_order_relaxed);
+        McsNode *previous = tail.exchange(&node, std::memory_order_acq_rel);
+        if (previous == nullptr)
+            return;
+        previous->next.store(&node, std::memory_order_release);
+        while (node.locked.load(std::memory_order_acquire))
+            cpuRelax();
+    }
 
-            for (const auto &entry : fileContent)
-            {
-                combinedResults.push_back(entry);
-            }
-        }
-        else
+    void unlock(McsNode &node)
+    {
+        McsNode *successor = node.next.load(std::memory_order_acquire);
+        if (successor == nullptr)
         {
-            std::cerr << "Failed to open file: " << filename << std::endl;
+            McsNode *expected = &node;
+            if (tail.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel))
+                return;
+            // A waiter swapped itself in but has not linked its node yet.
+            while ((successor = node.next.load(std::memory_order_acquire)) == nullptr)
+                cpuRelax();
         }
+        successor->locked.store(false, std::memory_order_release);
     }
 
-    std::ofstream outputFile(outputFilename);
-    if (outputFile.is_open())
+private:
+    alignas(64) std::atomic<McsNode *> tail{nullptr};
+};
+
+// FIFO spinlock: take a ticket, wait until it is served.
+class TicketLock
+{
+public:
+    void lock(McsNode &)
     {
-        outputFile << combinedResults.dump(4);
-        outputFile.close();
+        uint32_t ticket = next.fetch_add(1, std::memory_order_relaxed);
+        while (serving.load(std::memory_order_acquire) != ticket)
+            cpuRelax();
     }
-    else
+
+    void unlock(McsNode &)
     {
-        std::cerr << "Failed to open output file: " << outputFilename << std::endl;
+        serving.store(serving.load(std::memory_order_relaxed) + 1, std::memory_order_release);
     }
-}
 
-void StaticAccessMain(int numTests, double threshold)
-{
-    const char language[] = "C++";
-    std::cout << std::fixed << std::setprecision(6);
+private:
+    alignas(64) std::atomic<uint32_t> next{0};
+    alignas(64) std::atomic<uint32_t> serving{0};
+};
 
-    std::ofstream("C++_static_access.json") << "[]";
+// Give the library locks the lock(node)/unlock(node) shape of McsLock.
+struct StdMutexLock
+{
+    std::mutex mutex;
+    void lock(McsNode &) { mutex.lock(); }
+    void unlock(McsNode &) { mutex.unlock(); }
+};
 
-    for (int size : ARRAY_SIZES)
-    {
-        std::vector<double> staticAccessTimes;
+// Exclusive locking only; SharedReaderCounter covers shared readers.
+struct SharedMutexLock
+{
+    std::shared_mutex mutex;
+    void lock(McsNode &) { mutex.lock(); }
+    void unlock(McsNode &) { mutex.unlock(); }
+};
 
-        for (int i = 0; i < NUM_TESTS; ++i)
-        {
-            staticAccessTimes.push_back(measureStaticMemoryAccess(size));
-        }
+struct PthreadSpinLock
+{
+    pthread_spinlock_t spin;
+    PthreadSpinLock() { pthread_spin_init(&spin, PTHREAD_PROCESS_PRIVATE); }
+    ~PthreadSpinLock() { pthread_spin_destroy(&spin); }
+    void lock(McsNode &) { pthread_spin_lock(&spin); }
+    void unlock(McsNode &) { pthread_spin_unlock(&spin); }
+};
 
-        removeOutliers(staticAccessTimes, threshold);
+// One contending thread: its MCS node, how many operations it completed and
+// a sample of their acquire latencies in ns.
+struct alignas(64) ContentionSlot
+{
+    McsNode node;
+    uint64_t operations = 0;
+    std::vector<double> latencies;
+};
 
-        if (!staticAccessTimes.empty())
-        {
-            double staticAverage = calculateAverage(staticAccessTimes);
-            double staticStdDev = calculateStandardDeviation(staticAccessTimes, staticAverage);
-            saveResultsToJSON("C++_static_access.json", staticAverage, staticStdDev, "Static Memory Access", numTests, staticAccessTimes.size(), language, size, threshold);
-        }
-        else
-        {
-            std::cout << "All static memory access times were outliers for array size " << size << ".\n";
-        }
-    }
+double elapsedNanos(std::chrono::high_resolution_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
 }
 
-void DynamicAccessMain(int numTests, double threshold)
+// The critical section increments data only the lock protects, once plus
+// criticalSection more times, so a lock that lets two threads in loses
+// updates and fails the checksum even with no extra work. Returns the
+// acquire latency when timed.
+template <typename Lock>
+struct LockedCounter
 {
-    const char language[] = "C++";
-    std::cout << std::fixed << std::setprecision(6);
-
-    std::ofstream("C++_dynamic_access.json") << "[]";
+    Lock lock;
+    alignas(64) volatile uint64_t guarded = 0;
 
-    for (int size : ARRAY_SIZES)
+    double operate(ContentionSlot &slot, int criticalSection, bool timed)
     {
-        std::vector<double> dynamicAccessTimes;
-
-        for (int i = 0; i < NUM_TESTS; ++i)
+        auto start = timed ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point();
+        lock.lock(slot.node);
+        double latency = timed ? elapsedNanos(start) : 0.0;
+        for (int i = 0; i <= criticalSection; ++i)
         {
-            dynamicAccessTimes.push_back(measureDynamicMemoryAccess(size));
+            guarded = guarded + 1;
         }
+        lock.unlock(slot.node);
+        return latency;
+    }
 
-        removeOutliers(dynamicAccessTimes, threshold);
+    uint64_t checksum() const { return guarded; }
+    uint64_t expected(uint64_t operations, int criticalSection) const { return operations * (criticalSection + 1); }
+};
 
-        if (!dynamicAccessTimes.empty())
+// Every SHARED_WRITE_INTERVAL-th operation of a thread writes; the interval is
+// odd so the timed operations, every LATENCY_SAMPLE_STRIDE-th, include writes
+// in the same proportion.
+const uint64_t SHARED_WRITE_INTERVAL = 9;
+
+// Read-mostly use of std::shared_mutex. Writers take it exclusively and bump
+// both halves of a pair; readers take it shared and check that the halves
+// match. A torn read or a lost write fails the checksum.
+struct SharedReaderCounter
+{
+    std::shared_mutex mutex;
+    alignas(64) volatile uint64_t first = 0;
+    volatile uint64_t second = 0;
+    alignas(64) std::atomic<uint64_t> writes{0};
+    std::atomic<bool> torn{false};
+
+    double operate(ContentionSlot &slot, int criticalSection, bool timed)
+    {
+        auto start = timed ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point();
+        if (slot.operations % SHARED_WRITE_INTERVAL == 0)
         {
-            double dynamicAverage = calculateAverage(dynamicAccessTimes);
-            double dynamicStdDev = calculateStandardDeviation(dynamicAccessTimes, dynamicAverage);
-            saveResultsToJSON("C++_dynamic_access.json", dynamicAverage, dynamicStdDev, "Dynamic Memory Access", numTests, dynamicAccessTimes.size(), language, size, threshold);
+            mutex.lock();
+            double latency = timed ? elapsedNanos(start) : 0.0;
+            for (int i = 0; i <= criticalSection; ++i)
+            {
+                first = first + 1;
+                second = second + 1;
+            }
+            mutex.unlock();
+            writes.fetch_add(1, std::memory_order_relaxed);
+            return latency;
         }
-        else
+        mutex.lock_shared();
+        double latency = timed ? elapsedNanos(start) : 0.0;
+        bool consistent = true;
+        for (int i = 0; i <= criticalSection; ++i)
         {
-            std::cout << "All dynamic memory access times were outliers for array size " << size << ".\n";
+            consistent = consistent && first == second;
         }
+        mutex.unlock_shared();
+        if (!consistent)
+            torn.store(true, std::memory_order_relaxed);
+        return latency;
     }
-}
 
-void AllocationMain(int numTests, double threshold)
-{
-    const char language[] = "C++";
-    std::cout << std::fixed << std::setprecision(6);
+    uint64_t checksum() const { return torn.load() ? ~uint64_t(0) : second; }
+    uint64_t expected(uint64_t, int criticalSection) const { return writes.load() * (criticalSection + 1); }
+};
 
-    std::ofstream("C++_allocation.json") << "[]";
+// A single atomic increment; there is no critical section to lengthen.
+struct FetchAddCounter
+{
+    alignas(64) std::atomic<uint64_t> counter{0};
 
-    for (int size : ARRAY_SIZES)
+    double operate(ContentionSlot &, int, bool timed)
     {
-        std::vector<double> allocTimes;
+        auto start = timed ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point();
+        counter.fetch_add(1, std::memory_order_acq_rel);
+        return timed ? elapsedNanos(start) : 0.0;
+    }
 
-        for (int i = 0; i < NUM_TESTS; ++i)
-        {
-            allocTimes.push_back(measureMemoryAllocation(size));
-        }
+    uint64_t checksum() const { return counter.load(); }
+    uint64_t expected(uint64_t operations, int) const { return operations; }
+};
 
-        removeOutliers(allocTimes, threshold);
+// Optimistic update: read the counter, spend criticalSection steps before
+// publishing the increment with CAS, and start over if another thread won.
+struct CasLoopCounter
+{
+    alignas(64) std::atomic<uint64_t> counter{0};
 
-        if (!allocTimes.empty())
-        {
-            double allocAverage = calculateAverage(allocTimes);
-            double allocStdDev = calculateStandardDeviation(allocTimes, allocAverage);
-            saveResultsToJSON("C++_allocation.json", allocAverage, allocStdDev, "Memory Allocation", numTests, allocTimes.size(), language, size, threshold);
-        }
-        else
+    double operate(ContentionSlot &, int criticalSection, bool timed)
+    {
+        auto start = timed ? std::chrono::high_resolution_clock::now() : std::chrono::high_resolution_clock::time_point();
+        uint64_t current = counter.load(std::memory_order_relaxed);
+        do
         {
-            std::cout << "All memory allocation times were outliers for array size " << size << ".\n";
-        }
+            volatile uint64_t work = 0;
+            for (int i = 0; i < criticalSection; ++i)
+            {
+                work = work + 1;
+            }
+        } while (!counter.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+        return timed ? elapsedNanos(start) : 0.0;
+    }
+
+    uint64_t checksum() const { return counter.load(); }
+    uint64_t expected(uint64_t operations, int) const { return operations; }
+};
+
+const uint64_t LATENCY_SAMPLE_STRIDE = 16;
+const size_t MAX_LATENCY_SAMPLES = 1 << 16;
+
+struct ContentionRun
+{
+    double seconds;
+    uint64_t operations;
+    double fairness;
+    bool valid;
+};
+
+// Jain's fairness index of the per-thread operation counts: 1 when every
+// thread got through equally often, 1/threads when one thread did all of it.
+double jainFairness(const std::vector<ContentionSlot> &slots)
+{
+    double sum = 0.0, sumOfSquares = 0.0;
+    for (const ContentionSlot &slot : slots)
+    {
+        sum += slot.operations;
+        sumOfSquares += static_cast<double>(slot.operations) * slot.operations;
     }
+    return sumOfSquares > 0.0 ? sum * sum / (slots.size() * sumOfSquares) : 0.0;
 }
 
-void DeallocationMain(int numTests, double threshold)
+// Runs threads against one primitive for durationMs. Every
+// LATENCY_SAMPLE_STRIDE-th operation of each thread is timed and appended to
+// latencies.
+template <typename Primitive>
+ContentionRun runContention(int threads, int criticalSection, int durationMs, std::vector<double> &latencies)
 {
-    const char language[] = "C++";
-    std::cout << std::fixed << std::setprecision(6);
+    auto primitive = std::make_unique<Primitive>();
+    std::vector<ContentionSlot> slots(threads);
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};
 
-    std::ofstream("C++_deallocation.json") << "[]";
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]
+                             {
+            ContentionSlot &slot = slots[t];
+            slot.latencies.reserve(MAX_LATENCY_SAMPLES);
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire))
+            {
+                std::this_thread::yield();
+            }
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                bool timed = slot.operations % LATENCY_SAMPLE_STRIDE == 0 && slot.latencies.size() < MAX_LATENCY_SAMPLES;
+                double latency = primitive->operate(slot, criticalSection, timed);
+                if (timed)
+                    slot.latencies.push_back(latency);
+                ++slot.operations;
+            } });
+    }
+    while (ready.load() < threads)
+    {
+        std::this_thread::yield();
+    }
 
-    for (int size : ARRAY_SIZES)
+    auto start = std::chrono::high_resolution_clock::now();
+    go.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::milliseconds(durationMs));
+    stop.store(true, std::memory_order_relaxed);
+    double seconds = elapsedNanos(start) / 1e9;
+    for (std::thread &worker : workers)
     {
-        std::vector<double> deallocTimes;
+        worker.join();
+    }
 
-        for (int i = 0; i < NUM_TESTS; ++i)
-        {
-            deallocTimes.push_back(measureMemoryDeallocation(size));
-        }
+    uint64_t operations = 0;
+    for (const ContentionSlot &slot : slots)
+    {
+        operations += slot.operations;
+        latencies.insert(latencies.end(), slot.latencies.begin(), slot.latencies.end());
+    }
+    return {seconds, operations, jainFairness(slots), primitive->checksum() == primitive->expected(operations, criticalSection)};
+}
 
-        removeOutliers(deallocTimes, threshold);
+double percentile(std::vector<double> &values, double fraction)
+{
+    if (values.empty())
+        return 0.0;
+    size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
 
-        if (!deallocTimes.empty())
-        {
-            double deallocAverage = calculateAverage(deallocTimes);
-            double deallocStdDev = calculateStandardDeviation(deallocTimes, deallocAverage);
-            saveResultsToJSON("C++_deallocation.json", deallocAverage, deallocStdDev, "Memory Deallocation", numTests, deallocTimes.size(), language, size, threshold);
-        }
-        else
+uint64_t fnv1aHash(const std::string &data, uint64_t hash = 14695981039346656037ULL)
+{
+    for (unsigned char c : data)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::string toHex(uint64_t value)
+{
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(value));
+    return hex;
+}
+
+std::string readCpuModel()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+    {
+        if (line.rfind("model name", 0) == 0)
         {
-            std::cout << "All memory deallocation times were outliers for array size " << size << ".\n";
+            size_t colon = line.find(':');
+            if (colon != std::string::npos)
+                return line.substr(line.find_first_not_of(' ', colon + 1));
         }
     }
+    return "unknown";
 }
 
-void ThreadCreationMain(int numTests, double threshold)
+ordered_json collectEnvironment()
 {
-    const char language[] = "C++";
-    std::cout << std::fixed << std::setprecision(6);
+    ordered_json env;
+    env["compiler"] = BENCH_COMPILER;
+    struct utsname info;
+    if (uname(&info) == 0)
+    {
+        env["kernel"] = std::string(info.sysname) + " " + info.release;
+        env["machine"] = info.machine;
+        env["hostname"] = info.nodename;
+    }
+    env["cpu_model"] = readCpuModel();
+    env["cpu_count"] = std::thread::hardware_concurrency();
 
-    std::ofstream("C++_thread_creation.json") << "[]";
+    env["fingerprint"] = toHex(fnv1aHash(env.dump()));
+    return env;
+}
 
-    std::vector<double> threadCreationTimes;
+std::string detectGitRevision()
+{
+    if (const char *revision = std::getenv("BENCH_GIT_REVISION"))
+        return revision;
 
-    for (int i = 0; i < NUM_TESTS; ++i)
+    std::string revision;
+    FILE *pipe = popen("git rev-parse --short HEAD 2>/dev/null", "r");
+    if (pipe)
     {
-        threadCreationTimes.push_back(measureThreadCreationTime());
+        char buffer[64];
+        if (fgets(buffer, sizeof(buffer), pipe))
+        {
+            revision = buffer;
+            revision.erase(revision.find_last_not_of("\r\n") + 1);
+        }
+        pclose(pipe);
     }
+    return revision.empty() ? "unknown" : revision;
+}
+
+// parameters holds every field of result that tells its point apart from the
+// other points of the same process; compare matches results on them.
+void appendToHistory(const ordered_json &result, const ordered_json &parameters)
+{
+    ordered_json entry;
+    entry["run_id"] = runId;
+    entry["git_revision"] = gitRevision;
+    entry["environment"] = environment;
+    entry["parameters"] = parameters;
+    entry["result"] = result;
 
-    removeOutliers(threadCreationTimes, threshold);
+    // One line per result, only ever appended, so earlier runs stay comparable.
+    std::ofstream history(HISTORY_FILE, std::ios::app);
+    history << entry.dump() << '\n';
+}
 
-    if (!threadCreationTimes.empty())
+void appendResultToJSON(const std::string &filename, const ordered_json &result)
+{
+    ordered_json json;
+    std::ifstream file_in(filename);
+    if (file_in.is_open())
     {
-        double threadCreationAverage = calculateAverage(threadCreationTimes);
-        double threadCreationStdDev = calculateStandardDeviation(threadCreationTimes, threadCreationAverage);
-        saveResultsToJSON("C++_thread_creation.json", threadCreationAverage, threadCreationStdDev, "Thread Creation", numTests, threadCreationTimes.size(), language, 0, threshold);
+        file_in >> json;
+        file_in.close();
     }
     else
     {
-        std::cout << "All thread creation times were outliers.\n";
+        json = ordered_json::array();
     }
+
+    json.push_back(result);
+
+    std::ofstream file_out(filename);
+    file_out << json.dump(4);
+    file_out.flush();
+    file_out.close();
 }
 
-void ContextSwitchMain(int numTests, double threshold)
+std::string readFile(const std::string &path)
 {
-    const char language[] = "C++";
-    std::cout << std::fixed << std::setprecision(6);
+    std::ifstream file(path);
+    if (!file.is_open())
+        return "";
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
 
-    std::ofstream("C++_context_switch.json") << "[]";
+// Path of the binary this code runs from: the executable, or the shared
+// library when built with MEASURE_LIBRARY.
+std::string binaryPath()
+{
+#ifdef MEASURE_LIBRARY
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void *>(&binaryPath), &info) != 0 && info.dli_fname != nullptr)
+        return info.dli_fname;
+    return "";
+#else
+    return "/proc/self/exe";
+#endif
+}
 
-    std::vector<double> contextSwitchTimes;
+// Hash of the whole binary. Used for kernels whose code cannot be located in
+// it, so that any rebuild re-measures them.
+const std::string &buildFingerprint()
+{
+    static const std::string fingerprint = []
+    {
+        std::string binary = readFile(binaryPath());
+        // Without the binary we cannot tell what changed, so key on the build time instead.
+        return toHex(fnv1aHash(binary.empty() ? __DATE__ " " __TIME__ : binary));
+    }();
+    return fingerprint;
+}
 
-    for (int i = 0; i < NUM_TESTS; ++i)
+// Functions, objects and relocations of this binary, read back from its ELF
+// file. Built with -Wl,--emit-relocs the binary keeps the relocations of its
+// code, so a function can be hashed with every relocated field replaced by
+// what it refers to: code that only moved because another function grew
+// hashes the same, and a callee's hash is folded into its callers'.
+struct CodeImage
+{
+    struct Symbol
     {
-        contextSwitchTimes.push_back(measureContextSwitchTime());
-    }
+        uint64_t address;
+        uint64_t size;
+        std::string name;
+        bool function;
+    };
+    struct Relocation
+    {
+        uint64_t offset;
+        unsigned size;
+        std::string target;
+        uint64_t address;
+    };
 
-    removeOutliers(contextSwitchTimes, threshold);
+    std::string file;
+    uintptr_t base = 0;
+    std::vector<Symbol> symbols;
+    std::vector<Relocation> relocations;
+    std::vector<Elf64_Shdr> sections;
+    std::map<uint64_t, std::string> hashes;
 
-    if (!contextSwitchTimes.empty())
+    // File bytes backing [address, address + size), or nullptr.
+    const char *bytesAt(uint64_t address, uint64_t size) const
     {
-        double contextSwitchAverage = calculateAverage(contextSwitchTimes);
-        double contextSwitchStdDev = calculateStandardDeviation(contextSwitchTimes, contextSwitchAverage);
-        saveResultsToJSON("C++_context_switch.json", contextSwitchAverage, contextSwitchStdDev, "Context Switch", numTests, contextSwitchTimes.size(), language, 0, threshold);
+        for (const Elf64_Shdr &section : sections)
+        {
+            if (section.sh_type == SHT_PROGBITS && section.sh_addr != 0 && address >= section.sh_addr && address + size <= section.sh_addr + section.sh_size)
+                return file.data() + section.sh_offset + (address - section.sh_addr);
+        }
+        return nullptr;
     }
-    else
+
+    // The defined symbol that contains address, or nullptr.
+    const Symbol *symbolAt(uint64_t address) const
     {
-        std::cout << "All context switch times were outliers.\n";
+        auto next = std::upper_bound(symbols.begin(), symbols.end(), address, [](uint64_t value, const Symbol &symbol)
+                                     { return value < symbol.address; });
+        if (next == symbols.begin())
+            return nullptr;
+        const Symbol &symbol = *std::prev(next);
+        return address < symbol.address + std::max<uint64_t>(symbol.size, 1) ? &symbol : nullptr;
     }
-}
 
-void ThreadMigrationMain(int numTests, double threshold)
-{
-    const char language[] = "C++";
-    std::cout << std::fixed << std::setprecision(6);
+    // Hash of a function's code and of everything it reaches through its
+    // relocations. Recursion is cut at functions already being hashed.
+    std::string hashFunction(const Symbol &function, std::set<uint64_t> &active)
+    {
+        auto known = hashes.find(function.address);
+        if (known != hashes.end())
+            return known->second;
+        const char *bytes = bytesAt(function.address, function.size);
+        if (bytes == nullptr)
+            return function.name;
+        active.insert(function.address);
 
-    std::ofstream("C++_thread_migration.json") << "[]";
+        std::string code(bytes, function.size);
+        std::string references;
+        auto first = std::lower_bound(relocations.begin(), relocations.end(), function.address, [](const Relocation &relocation, uint64_t value)
+                                      { return relocation.offset < value; });
+        for (auto relocation = first; relocation != relocations.end() && relocation->offset < function.address + function.size; ++relocation)
+        {
+            uint64_t field = relocation->offset - function.address;
+            std::fill_n(code.begin() + field, std::min<uint64_t>(relocation->size, code.size() - field), '\0');
+            references += std::to_string(field) + "=" + relocation->target;
+            const Symbol *callee = relocation->target.empty() ? symbolAt(relocation->address) : nullptr;
+            if (callee == nullptr)
+                references += ";";
+            else if (!callee->function)
+                references += callee->name + "+" + std::to_string(relocation->address - callee->address) + ";";
+            else if (active.count(callee->address) != 0)
+                references += callee->name + ";";
+            else
+                references += hashFunction(*callee, active) + ";";
+            // Unnamed constants, such as floating-point literals, count by value.
+            const char *data = callee == nullptr && relocation->target.empty() ? bytesAt(relocation->address, 16) : nullptr;
+            if (data != nullptr)
+                references += std::string(data, 16);
+        }
 
-    std::vector<double> threadMigrationTimes;
+        active.erase(function.address);
+        std::string hash = toHex(fnv1aHash(references, fnv1aHash(code)));
+        hashes[function.address] = hash;
+        return hash;
+    }
 
-    for (int i = 0; i < NUM_TESTS; ++i)
+    // Loads the ELF file of this binary. Leaves relocations empty unless it is
+    // a 64-bit x86 file linked with --emit-relocs.
+    void load()
     {
-        threadMigrationTimes.push_back(measureThreadMigrationTime());
-    }
+        file = readFile(binaryPath());
+        if (file.size() < sizeof(Elf64_Ehdr))
+            return;
+        Elf64_Ehdr header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_ident[EI_CLASS] != ELFCLASS64 || header.e_machine != EM_X86_64 ||
+            header.e_shoff + header.e_shnum * sizeof(Elf64_Shdr) > file.size())
+            return;
+        sections.resize(header.e_shnum);
+        std::memcpy(sections.data(), file.data() + header.e_shoff, header.e_shnum * sizeof(Elf64_Shdr));
 
-    removeOutliers(threadMigrationTimes, threshold);
+        Dl_info info;
+        if (header.e_type == ET_DYN && dladdr(reinterpret_cast<void *>(&buildFingerprint), &info) != 0)
+            base = reinterpret_cast<uintptr_t>(info.dli_fbase);
 
-    if (!threadMigrationTimes.empty())
-    {
-        double threadMigrationAverage = calculateAverage(threadMigrationTimes);
-        double threadMigrationStdDev = calculateStandardDeviation(threadMigrationTimes, threadMigrationAverage);
-        saveResultsToJSON("C++_thread_migration.json", threadMigrationAverage, threadMigrationStdDev, "Thread Migration", numTests, threadMigrationTimes.size(), language, 0, threshold);
+        std::vector<Elf64_Sym> table;
+        const char *names = nullptr;
+        for (const Elf64_Shdr &section : sections)
+        {
+            if (section.sh_type != SHT_SYMTAB || section.sh_link >= sections.size())
+                continue;
+            table.resize(section.sh_size / sizeof(Elf64_Sym));
+            std::memcpy(table.data(), file.data() + section.sh_offset, table.size() * sizeof(Elf64_Sym));
+            names = file.data() + sections[section.sh_link].sh_offset;
+        }
+        for (const Elf64_Sym &symbol : table)
+        {
+            int type = ELF64_ST_TYPE(symbol.st_info);
+            if (symbol.st_shndx != SHN_UNDEF && symbol.st_shndx < sections.size() && (type == STT_FUNC || type == STT_OBJECT))
+                symbols.push_back({symbol.st_value, symbol.st_size, names + symbol.st_name, type == STT_FUNC});
+        }
+        std::sort(symbols.begin(), symbols.end(), [](const Symbol &a, const Symbol &b)
+                  { return a.address < b.address; });
+
+        for (const Elf64_Shdr &section : sections)
+        {
+            if (section.sh_type != SHT_RELA || section.sh_info >= sections.size() || !(sections[section.sh_info].sh_flags & SHF_EXECINSTR))
+                continue;
+            size_t count = section.sh_size / sizeof(Elf64_Rela);
+            for (size_t i = 0; i < count; ++i)
+            {
+                Elf64_Rela entry;
+                std::memcpy(&entry, file.data() + section.sh_offset + i * sizeof(entry), sizeof(entry));
+                uint32_t type = ELF64_R_TYPE(entry.r_info);
+                uint32_t index = ELF64_R_SYM(entry.r_info);
+                if (type == R_X86_64_NONE || index >= table.size())
+                    continue;
+                const Elf64_Sym &symbol = table[index];
+                unsigned size = type == R_X86_64_64 || type == R_X86_64_PC64 ? 8 : 4;
+                bool relative = type == R_X86_64_PC32 || type == R_X86_64_PLT32 || type == R_X86_64_GOTPCREL || type == R_X86_64_GOTPCRELX || type == R_X86_64_REX_GOTPCRELX;
+                Relocation relocation{entry.r_offset, size, "", 0};
+                if (symbol.st_shndx == SHN_UNDEF)
+                    relocation.target = names + symbol.st_name;
+                else if (ELF64_ST_TYPE(symbol.st_info) == STT_SECTION && symbol.st_shndx < sections.size())
+                    relocation.address = sections[symbol.st_shndx].sh_addr + entry.r_addend + (relative ? size : 0);
+                else
+                    relocation.address = symbol.st_value + entry.r_addend + (relative ? size : 0);
+                relocations.push_back(std::move(relocation));
+            }
+        }
+        std::sort(relocations.begin(), relocations.end(), [](const Relocation &a, const Relocation &b)
+                  { return a.offset < b.offset; });
     }
-    else
+};
+
+// Hash of the machine code of a kernel: its functions and everything they
+// call or reference, compiled as they are in this build. Falls back to the
+// whole binary when a function cannot be found or the binary was linked
+// without --emit-relocs.
+std::string kernelCodeHash(std::initializer_list<const void *> functions)
+{
+    static CodeImage image = []
+    {
+        CodeImage loaded;
+        loaded.load();
+        return loaded;
+    }();
+    std::string hashes;
+    for (const void *function : functions)
     {
-        std::cout << "All thread migration times were outliers.\n";
+        const CodeImage::Symbol *symbol = image.relocations.empty() ? nullptr : image.symbolAt(reinterpret_cast<uintptr_t>(function) - image.base);
+        if (symbol == nullptr || !symbol->function)
+            return buildFingerprint();
+        std::set<uint64_t> active;
+        hashes += image.hashFunction(*symbol, active);
     }
+    return toHex(fnv1aHash(hashes));
 }
 
-int main(int argc, char *argv[])
+template <typename Function>
+const void *codeOf(Function *function)
 {
-    if (argc < 3)
+    return reinterpret_cast<const void *>(function);
+}
+
+// The kernel_spec.json entry of a process, or of the kernel it is a case of
+// ("Context Switch: Coroutine" uses "Context Switch").
+ordered_json kernelSpecEntry(const std::string &process)
+{
+    if (!kernelSpec.contains("kernels"))
+        return nullptr;
+    for (const auto &kernel : kernelSpec["kernels"])
     {
-        std::cerr << "Usage: " << argv[0] << " <number_of_tests> <outlier_threshold>\n";
-        return 1;
+        std::string name = kernel.value("process", "");
+        if (process == name || process.rfind(name + ":", 0) == 0)
+            return kernel;
     }
+    return nullptr;
+}
 
-    int numTests = std::stoi(argv[1]);
+// Content address of one measurement: the code of its kernel, the spec entry
+// that checks it, the toolchain and flags that built it, the statistics
+// applied to it, its parameters and the machine. Changing one kernel only
+// invalidates the points of the kernels whose code changed.
+std::string resultCacheKey(const std::string &process, const std::string &codeHash, const char *parameterName, int parameter, int numTests, double threshold)
+{
+    uint64_t hash = fnv1aHash(process);
+    hash = fnv1aHash(codeHash, hash);
+    hash = fnv1aHash(kernelSpecEntry(process).dump(), hash);
+    hash = fnv1aHash(BENCH_COMPILER, hash);
+    hash = fnv1aHash(BENCH_CFLAGS, hash);
+    hash = fnv1aHash(BENCH_PROFILE, hash);
+    hash = fnv1aHash(environment["fingerprint"].get<std::string>(), hash);
+
+    ordered_json params = {{parameterName, parameter}, {"number_of_tests", numTests}, {"outlier_threshold", threshold}};
+    hash = fnv1aHash(params.dump(), hash);
+    return toHex(hash);
+}
+
+void storeCachedResult(const std::string &key, const ordered_json &result)
+{
+    std::filesystem::create_directories(CACHE_DIRECTORY);
+    std::ofstream(CACHE_DIRECTORY + "/" + key + ".json") << result.dump(4);
+}
+
+void combineJSONFiles(const std::vector<std::string> &filenames, const std::string &outputFilename)
+{
+    ordered_json combinedResults = ordered_json::array();
+
+    for (const auto &filename : filenames)
+    {
+        std::ifstream inputFile(filename);
+        if (inputFile.is_open())
+        {
+            ordered_json fileContent;
+            inputFile >> fileContent;
+            inputFile.close();
+
+            for (const auto &entry : fileContent)
+            {
+                combinedResults.push_back(entry);
+            }
+        }
+        else
+        {
+            std::cerr << "Failed to open file: " << filename << std::endl;
+        }
+    }
+
+    std::ofstream outputFile(outputFilename);
+    if (outputFile.is_open())
+    {
+        outputFile << combinedResults.dump(4);
+        outputFile.close();
+    }
+    else
+    {
+        std::cerr << "Failed to open output file: " << outputFilename << std::endl;
+    }
+}
+
+void stampBuild(ordered_json &result)
+{
+    result["compiler"] = BENCH_COMPILER;
+    result["compiler_flags"] = BENCH_CFLAGS;
+    result["build_profile"] = BENCH_PROFILE;
+}
+
+// A measured sweep point. The strings are literals or interned and the
+// samples live in the sample arena, so queueing one does not allocate.
+// Bandwidth is reported when bytesPerElement is set.
+struct PendingResult
+{
+    int arraySize;
+    int iterations;
+    int numTests;
+    double threshold;
+    const char *language;
+    const char *process;
+    double average;
+    double stdDev;
+    const double *samples;
+    size_t sampleCount;
+    uint64_t checksum;
+    int checksumMismatches;
+    double bytesPerElement;
+};
+
+struct WriteRequest
+{
+    enum Kind
+    {
+        RESET,
+        SAVE,
+        APPEND,
+        REUSE,
+        COMBINE,
+        LOG
+    } kind;
+    const char *filename;
+    PendingResult result;
+    ordered_json cached;
+    std::string cacheKey;
+    std::string message;
+    std::vector<std::string> filenames;
+    ordered_json parameters;
+};
+
+// Runs on the result writer thread: serializes one measured point and appends
+// it to its result file, the history and the cache.
+void writeResult(const WriteRequest &request)
+{
+    const PendingResult &pending = request.result;
+    ordered_json result;
+    if (pending.arraySize > 0)
+        result["array_size"] = pending.arraySize;
+    if (pending.iterations > 0)
+        result["iterations"] = pending.iterations;
+    result["number_of_tests"] = pending.numTests;
+    result["passed_tests"] = pending.sampleCount;
+    result["outlier_threshold"] = pending.threshold;
+    result["programming_language"] = pending.language;
+    result["process_measured"] = pending.process;
+    result["average_time"] = pending.average;
+    result["std_deviation"] = pending.stdDev;
+    if (pending.bytesPerElement > 0.0)
+        result["gigabytes_per_second"] = pending.bytesPerElement / pending.average;
+    result["checksum"] = pending.checksum;
+    result["checksum_valid"] = pending.checksumMismatches == 0;
+    stampBuild(result);
+    sampleArena.release(pending.samples);
+    if (pending.checksumMismatches > 0)
+        std::cerr << pending.process << ": " << pending.checksumMismatches << " samples did not match the kernel spec checksum (last " << pending.checksum << ")" << std::endl;
+
+    ordered_json parameters;
+    if (pending.arraySize > 0)
+        parameters["array_size"] = pending.arraySize;
+    if (pending.iterations > 0)
+        parameters["iterations"] = pending.iterations;
+    parameters["number_of_tests"] = pending.numTests;
+    parameters["outlier_threshold"] = pending.threshold;
+
+    appendResultToJSON(request.filename, result);
+    appendToHistory(result, parameters);
+    // A point that did not run the spec's workload is measured again next time.
+    if (pending.checksumMismatches == 0)
+        storeCachedResult(request.cacheKey, result);
+}
+
+struct ResultHandler
+{
+    void operator()(WriteRequest &request)
+    {
+        switch (request.kind)
+        {
+        case WriteRequest::RESET:
+            std::ofstream(request.filename) << "[]";
+            break;
+        case WriteRequest::SAVE:
+            writeResult(request);
+            break;
+        case WriteRequest::APPEND:
+            appendResultToJSON(request.filename, request.cached);
+            appendToHistory(request.cached, request.parameters);
+            break;
+        case WriteRequest::REUSE:
+            // Already in the history under the run that measured it.
+            appendResultToJSON(request.filename, request.cached);
+            break;
+        case WriteRequest::COMBINE:
+            combineJSONFiles(request.filenames, request.filename);
+            break;
+        case WriteRequest::LOG:
+            std::cout << request.message << std::endl;
+            break;
+        }
+    }
+
+    void idle() {}
+};
+
+ResultWriter<WriteRequest, ResultHandler> resultWriter;
+
+void submitWrite(WriteRequest request)
+{
+    resultWriter.submit(request);
+}
+
+void logMessage(const std::string &message)
+{
+    WriteRequest request{WriteRequest::LOG, nullptr};
+    request.message = message;
+    submitWrite(std::move(request));
+}
+
+void saveResultsToJSON(const char *filename, const SampleBuffer &times, double average, double stdDev, const char *process, int numTests, const char *language, int arraySize, int iterations, double threshold, uint64_t checksum, int mismatches, std::string &cacheKey, double bytesPerElement = 0.0)
+{
+    WriteRequest request{WriteRequest::SAVE, filename};
+    request.result = {arraySize, iterations, numTests, threshold, language, process, average, stdDev, times.data, times.size(), checksum, mismatches, bytesPerElement};
+    request.cacheKey = std::move(cacheKey);
+    submitWrite(std::move(request));
+}
+
+void discardSamples(const SampleBuffer &times)
+{
+    sampleArena.release(times.data);
+}
+
+// Cache state of one sweep point. Every point of a sweep is looked up before
+// the sweep starts, so hashing and parsing cached files never interleaves
+// with measurements.
+struct CachedPoint
+{
+    std::string key;
+    ordered_json result;
+    bool hit;
+};
+
+// code lists the functions that make up the kernel of process; see kernelCodeHash.
+std::vector<CachedPoint> lookupSweep(const std::string &process, std::initializer_list<const void *> code, const char *parameterName, const std::vector<int> &parameters, int numTests, double threshold)
+{
+    std::string codeHash = kernelCodeHash(code);
+    std::vector<CachedPoint> points;
+    for (int parameter : parameters)
+    {
+        CachedPoint point{resultCacheKey(process, codeHash, parameterName, parameter, numTests, threshold), nullptr, false};
+        if (!forceRun)
+        {
+            std::ifstream cached(CACHE_DIRECTORY + "/" + point.key + ".json");
+            if (cached.is_open())
+            {
+                point.result = ordered_json::parse(cached, nullptr, false);
+                point.hit = !point.result.is_discarded();
+            }
+        }
+        points.push_back(std::move(point));
+    }
+    return points;
+}
+
+bool reuseCachedResult(CachedPoint &point, const char *filename)
+{
+    if (!point.hit || !point.result.value("checksum_valid", false))
+        return false;
+
+    WriteRequest request{WriteRequest::REUSE, filename};
+    request.cached = std::move(point.result);
+    submitWrite(std::move(request));
+    ++cacheHits;
+    return true;
+}
+
+// Completes and queues the record of one point of a suite that reports whole
+// runs rather than samples: parameters first, then the mean and standard
+// deviation of the per-run values, then the suite's metrics and the build.
+void recordRunResult(const char *filename, const std::string &process, const ordered_json &parameters, const std::vector<double> &perRun, const ordered_json &metrics, bool valid, const std::string &summary)
+{
+    double average = std::accumulate(perRun.begin(), perRun.end(), 0.0) / perRun.size();
+    double variance = 0.0;
+    for (double value : perRun)
+    {
+        variance += (value - average) * (value - average);
+    }
+
+    ordered_json result = parameters;
+    result["number_of_tests"] = perRun.size();
+    result["passed_tests"] = perRun.size();
+    result["programming_language"] = "C++";
+    result["process_measured"] = process;
+    result["average_time"] = average;
+    result["std_deviation"] = std::sqrt(variance / perRun.size());
+    result.update(metrics);
+    result["checksum_valid"] = valid;
+    stampBuild(result);
+    logMessage(summary);
+
+    WriteRequest request{WriteRequest::APPEND, filename};
+    request.cached = std::move(result);
+    request.parameters = parameters;
+    request.parameters["number_of_tests"] = perRun.size();
+    submitWrite(std::move(request));
+}
+
+// Continued fraction for the regularized incomplete beta function (modified Lentz).
+double incompleteBetaFraction(double a, double b, double x)
+{
+    const double tiny = 1e-300;
+    double c = 1.0;
+    double d = 1.0 - (a + b) * x / (a + 1.0);
+    d = 1.0 / (std::fabs(d) < tiny ? tiny : d);
+    double h = d;
+    for (int m = 1; m <= 200; ++m)
+    {
+        for (int step = 0; step < 2; ++step)
+        {
+            double numerator = step == 0
+                                   ? m * (b - m) * x / ((a + 2 * m - 1) * (a + 2 * m))
+                                   : -(a + m) * (a + b + m) * x / ((a + 2 * m) * (a + 2 * m + 1));
+            d = 1.0 + numerator * d;
+            d = 1.0 / (std::fabs(d) < tiny ? tiny : d);
+            c = 1.0 + numerator / c;
+            c = std::fabs(c) < tiny ? tiny : c;
+            h *= d * c;
+        }
+        if (std::fabs(d * c - 1.0) < 1e-12)
+            break;
+    }
+    return h;
+}
+
+double regularizedIncompleteBeta(double a, double b, double x)
+{
+    if (x <= 0.0)
+        return 0.0;
+    if (x >= 1.0)
+        return 1.0;
+    double front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1.0 - x));
+    if (x < (a + 1.0) / (a + b + 2.0))
+        return front * incompleteBetaFraction(a, b, x) / a;
+    return 1.0 - front * incompleteBetaFraction(b, a, 1.0 - x) / b;
+}
+
+// P(T > t) for Student's t distribution with df degrees of freedom.
+double studentTUpperTail(double t, double df)
+{
+    double tail = 0.5 * regularizedIncompleteBeta(df / 2.0, 0.5, df / (df + t * t));
+    return t > 0 ? tail : 1.0 - tail;
+}
+
+// One-sided Welch's t-test that the candidate mean is larger (slower) than the baseline.
+double regressionPValue(const ordered_json &baseline, const ordered_json &candidate)
+{
+    double meanBase = baseline["average_time"], meanCand = candidate["average_time"];
+    double sdBase = baseline["std_deviation"], sdCand = candidate["std_deviation"];
+    double nBase = baseline["passed_tests"], nCand = candidate["passed_tests"];
+    if (nBase < 2 || nCand < 2)
+        return 1.0;
+
+    double varBase = sdBase * sdBase / nBase;
+    double varCand = sdCand * sdCand / nCand;
+    double standardError = std::sqrt(varBase + varCand);
+    if (standardError == 0.0)
+        return meanCand > meanBase ? 0.0 : 1.0;
+
+    double t = (meanCand - meanBase) / standardError;
+    double df = (varBase + varCand) * (varBase + varCand) /
+                (varBase * varBase / (nBase - 1) + varCand * varCand / (nCand - 1));
+    return studentTUpperTail(t, df);
+}
+
+// The process and every parameter recorded with a history entry. Entries
+// written before parameters were recorded fall back to the sweep fields.
+std::string historyKey(const ordered_json &entry)
+{
+    const ordered_json &result = entry["result"];
+    ordered_json parameters = entry.value("parameters", ordered_json());
+    if (parameters.is_null())
+    {
+        parameters = ordered_json::object();
+        for (const char *param : {"array_size", "iterations", "threads", "critical_section", "number_of_tests", "outlier_threshold"})
+        {
+            if (result.contains(param))
+                parameters[param] = result[param];
+        }
+    }
+    std::string key = result.value("process_measured", "");
+    for (const auto &param : parameters.items())
+    {
+        key += "|" + param.key() + "=" + param.value().dump();
+    }
+    return key;
+}
+
+struct HistoryRun
+{
+    std::string gitRevision;
+    ordered_json environment;
+    std::map<std::string, ordered_json> results;
+};
+
+std::string resolveRun(const std::vector<std::string> &runOrder, const std::map<std::string, HistoryRun> &runs, const std::string &selector)
+{
+    if (selector == "latest")
+        return runOrder.empty() ? "" : runOrder.back();
+    for (auto it = runOrder.rbegin(); it != runOrder.rend(); ++it)
+    {
+        const HistoryRun &run = runs.at(*it);
+        if (*it == selector || run.gitRevision.rfind(selector, 0) == 0)
+            return *it;
+    }
+    return "";
+}
+
+std::vector<int> parseIntList(const std::string &list)
+{
+    std::vector<int> values;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        values.push_back(std::stoi(item));
+    }
+    return values;
+}
+
+// A subcommand option: "--name value" parsed into target, or a bare "--name"
+// flag when target is a bool.
+struct Option
+{
+    const char *name;
+    std::variant<int *, int64_t *, double *, std::string *, std::vector<int> *, bool *> target;
+};
+
+void parseOptionValue(const char *value, int &target) { target = std::stoi(value); }
+void parseOptionValue(const char *value, int64_t &target) { target = std::stoll(value); }
+void parseOptionValue(const char *value, double &target) { target = std::stod(value); }
+void parseOptionValue(const char *value, std::string &target) { target = value; }
+void parseOptionValue(const char *value, std::vector<int> &target) { target = parseIntList(value); }
+// Flags take no value; parseOptions sets them before it looks for one.
+void parseOptionValue(const char *, bool &target) { target = true; }
+
+// Parses argv[first..] against options. Other arguments are collected in
+// positional, or rejected when it is null. Returns false on an unexpected
+// argument or a missing value.
+bool parseOptions(int argc, char *argv[], int first, std::initializer_list<Option> options, std::vector<std::string> *positional = nullptr)
+{
+    for (int i = first; i < argc; ++i)
+    {
+        const Option *option = nullptr;
+        for (const Option &candidate : options)
+        {
+            if (std::strcmp(argv[i], candidate.name) == 0)
+                option = &candidate;
+        }
+        if (option == nullptr)
+        {
+            if (positional == nullptr)
+                return false;
+            positional->push_back(argv[i]);
+            continue;
+        }
+        if (bool *const *flag = std::get_if<bool *>(&option->target))
+        {
+            **flag = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+            return false;
+        const char *value = argv[++i];
+        std::visit([value](auto *target)
+                   { parseOptionValue(value, *target); }, option->target);
+    }
+    return true;
+}
+
+int compareMain(int argc, char *argv[])
+{
+    std::vector<std::string> selectors;
+    double alpha = 0.05;
+    double minChange = 0.05;
+    bool parsed = parseOptions(argc, argv, 2, {{"--alpha", &alpha}, {"--min-change", &minChange}}, &selectors);
+    if (!parsed || selectors.empty() || selectors.size() > 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " compare <baseline_run|git_revision> [candidate_run|git_revision] [--alpha 0.05] [--min-change 0.05]\n";
+        return 2;
+    }
+
+    std::ifstream history(HISTORY_FILE);
+    if (!history.is_open())
+    {
+        std::cerr << "No run history found in " << HISTORY_FILE << std::endl;
+        return 2;
+    }
+
+    std::vector<std::string> runOrder;
+    std::map<std::string, HistoryRun> runs;
+    std::string line;
+    while (std::getline(history, line))
+    {
+        ordered_json entry = ordered_json::parse(line, nullptr, false);
+        if (entry.is_discarded() || !entry.contains("run_id") || !entry.contains("result"))
+        {
+            std::cerr << "Skipping malformed history line" << std::endl;
+            continue;
+        }
+        std::string id = entry["run_id"];
+        if (runs.find(id) == runs.end())
+        {
+            runOrder.push_back(id);
+            runs[id] = {entry.value("git_revision", "unknown"), entry["environment"], {}};
+        }
+        runs[id].results[historyKey(entry)] = entry["result"];
+    }
+
+    std::string baselineId = resolveRun(runOrder, runs, selectors[0]);
+    std::string candidateId = resolveRun(runOrder, runs, selectors.size() > 1 ? selectors[1] : "latest");
+    if (baselineId.empty() || candidateId.empty())
+    {
+        std::cerr << "Could not find run '" << (baselineId.empty() ? selectors[0] : selectors[1]) << "' in history" << std::endl;
+        return 2;
+    }
+
+    const HistoryRun &baseline = runs[baselineId];
+    const HistoryRun &candidate = runs[candidateId];
+    std::cout << "Baseline:  " << baselineId << " (" << baseline.gitRevision << ")\n";
+    std::cout << "Candidate: " << candidateId << " (" << candidate.gitRevision << ")\n";
+    for (const auto &field : candidate.environment.items())
+    {
+        if (field.key() != "fingerprint" && baseline.environment.value(field.key(), ordered_json()) != field.value())
+            std::cout << "  " << field.key() << ": " << baseline.environment.value(field.key(), ordered_json()).dump() << " -> " << field.value().dump() << "\n";
+    }
+
+    int regressions = 0;
+    std::cout << std::fixed << std::setprecision(4);
+    for (const auto &[key, candidateResult] : candidate.results)
+    {
+        auto match = baseline.results.find(key);
+        if (match == baseline.results.end())
+            continue;
+        const ordered_json &baselineResult = match->second;
+
+        double meanBase = baselineResult["average_time"];
+        double meanCand = candidateResult["average_time"];
+        double change = meanBase > 0 ? (meanCand - meanBase) / meanBase : 0.0;
+        double pValue = regressionPValue(baselineResult, candidateResult);
+        bool regressed = pValue < alpha && change > minChange;
+        regressions += regressed;
+
+        std::cout << (regressed ? "REGRESSION " : "ok         ") << key
+                  << "  " << meanBase << " -> " << meanCand << " ns"
+                  << "  (" << std::showpos << change * 100 << std::noshowpos << "%, p=" << pValue << ")\n";
+    }
+
+    std::cout << regressions << " regression(s) at alpha=" << alpha << ", min change " << minChange * 100 << "%\n";
+    return regressions > 0 ? 1 : 0;
+}
+
+void StaticAccessMain(int numTests, double threshold)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, "C++_static_access.json"});
+
+    std::vector<CachedPoint> cache = lookupSweep("Static Memory Access", {codeOf(measureStaticMemoryAccess)}, "array_size", ARRAY_SIZES, numTests, threshold);
+
+    for (size_t point = 0; point < ARRAY_SIZES.size(); ++point)
+    {
+        int size = ARRAY_SIZES[point];
+        if (reuseCachedResult(cache[point], "C++_static_access.json"))
+        {
+            continue;
+        }
+
+        SampleBuffer staticAccessTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Static Memory Access", size);
+        int mismatches = 0;
+
+        for (int i = 0; i < numTests; ++i)
+        {
+            staticAccessTimes.push(measureStaticMemoryAccess(size));
+            mismatches += kernelChecksum != expected;
+        }
+
+        removeOutliers(staticAccessTimes, threshold);
+
+        if (!staticAccessTimes.empty())
+        {
+            double staticAverage = calculateAverage(staticAccessTimes);
+            double staticStdDev = calculateStandardDeviation(staticAccessTimes, staticAverage);
+            saveResultsToJSON("C++_static_access.json", staticAccessTimes, staticAverage, staticStdDev, "Static Memory Access", numTests, language, size, 0, threshold, kernelChecksum, mismatches, cache[point].key);
+        }
+        else
+        {
+            discardSamples(staticAccessTimes);
+            logMessage("All static memory access times were outliers for array size " + std::to_string(size) + ".");
+        }
+    }
+}
+
+void DynamicAccessMain(int numTests, double threshold)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, "C++_dynamic_access.json"});
+
+    std::vector<CachedPoint> cache = lookupSweep("Dynamic Memory Access", {codeOf(measureDynamicMemoryAccess)}, "array_size", ARRAY_SIZES, numTests, threshold);
+
+    for (size_t point = 0; point < ARRAY_SIZES.size(); ++point)
+    {
+        int size = ARRAY_SIZES[point];
+        if (reuseCachedResult(cache[point], "C++_dynamic_access.json"))
+        {
+            continue;
+        }
+
+        SampleBuffer dynamicAccessTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Dynamic Memory Access", size);
+        int mismatches = 0;
+
+        for (int i = 0; i < numTests; ++i)
+        {
+            dynamicAccessTimes.push(measureDynamicMemoryAccess(size));
+            mismatches += kernelChecksum != expected;
+        }
+
+        removeOutliers(dynamicAccessTimes, threshold);
+
+        if (!dynamicAccessTimes.empty())
+        {
+            double dynamicAverage = calculateAverage(dynamicAccessTimes);
+            double dynamicStdDev = calculateStandardDeviation(dynamicAccessTimes, dynamicAverage);
+            saveResultsToJSON("C++_dynamic_access.json", dynamicAccessTimes, dynamicAverage, dynamicStdDev, "Dynamic Memory Access", numTests, language, size, 0, threshold, kernelChecksum, mismatches, cache[point].key);
+        }
+        else
+        {
+            discardSamples(dynamicAccessTimes);
+            logMessage("All dynamic memory access times were outliers for array size " + std::to_string(size) + ".");
+        }
+    }
+}
+
+void AllocationMain(int numTests, double threshold)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, "C++_allocation.json"});
+
+    std::vector<CachedPoint> cache = lookupSweep("Memory Allocation", {codeOf(measureMemoryAllocation)}, "array_size", ARRAY_SIZES, numTests, threshold);
+
+    for (size_t point = 0; point < ARRAY_SIZES.size(); ++point)
+    {
+        int size = ARRAY_SIZES[point];
+        if (reuseCachedResult(cache[point], "C++_allocation.json"))
+        {
+            continue;
+        }
+
+        SampleBuffer allocTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Memory Allocation", size);
+        int mismatches = 0;
+
+        for (int i = 0; i < numTests; ++i)
+        {
+            allocTimes.push(measureMemoryAllocation(size));
+            mismatches += kernelChecksum != expected;
+        }
+
+        removeOutliers(allocTimes, threshold);
+
+        if (!allocTimes.empty())
+        {
+            double allocAverage = calculateAverage(allocTimes);
+            double allocStdDev = calculateStandardDeviation(allocTimes, allocAverage);
+            saveResultsToJSON("C++_allocation.json", allocTimes, allocAverage, allocStdDev, "Memory Allocation", numTests, language, size, 0, threshold, kernelChecksum, mismatches, cache[point].key);
+        }
+        else
+        {
+            discardSamples(allocTimes);
+            logMessage("All memory allocation times were outliers for array size " + std::to_string(size) + ".");
+        }
+    }
+}
+
+void DeallocationMain(int numTests, double threshold)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, "C++_deallocation.json"});
+
+    std::vector<CachedPoint> cache = lookupSweep("Memory Deallocation", {codeOf(measureMemoryDeallocation)}, "array_size", ARRAY_SIZES, numTests, threshold);
+
+    for (size_t point = 0; point < ARRAY_SIZES.size(); ++point)
+    {
+        int size = ARRAY_SIZES[point];
+        if (reuseCachedResult(cache[point], "C++_deallocation.json"))
+        {
+            continue;
+        }
+
+        SampleBuffer deallocTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Memory Deallocation", size);
+        int mismatches = 0;
+
+        for (int i = 0; i < numTests; ++i)
+        {
+            deallocTimes.push(measureMemoryDeallocation(size));
+            mismatches += kernelChecksum != expected;
+        }
+
+        removeOutliers(deallocTimes, threshold);
+
+        if (!deallocTimes.empty())
+        {
+            double deallocAverage = calculateAverage(deallocTimes);
+            double deallocStdDev = calculateStandardDeviation(deallocTimes, deallocAverage);
+            saveResultsToJSON("C++_deallocation.json", deallocTimes, deallocAverage, deallocStdDev, "Memory Deallocation", numTests, language, size, 0, threshold, kernelChecksum, mismatches, cache[point].key);
+        }
+        else
+        {
+            discardSamples(deallocTimes);
+            logMessage("All memory deallocation times were outliers for array size " + std::to_string(size) + ".");
+        }
+    }
+}
+
+void ThreadCreationMain(int numTests, double threshold)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, "C++_thread_creation.json"});
+
+    std::vector<CachedPoint> cache = lookupSweep("Thread Creation", {codeOf(measureThreadCreationTime)}, "iterations", ITERATIONS, numTests, threshold);
+
+    for (size_t point = 0; point < ITERATIONS.size(); ++point)
+    {
+        int iterations = ITERATIONS[point];
+        if (reuseCachedResult(cache[point], "C++_thread_creation.json"))
+        {
+            continue;
+        }
+
+        SampleBuffer threadCreationTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Thread Creation", iterations);
+        int mismatches = 0;
+
+        for (int i = 0; i < numTests; ++i)
+        {
+            threadCreationTimes.push(measureThreadCreationTime(iterations));
+            mismatches += kernelChecksum != expected;
+        }
+
+        removeOutliers(threadCreationTimes, threshold);
+
+        if (!threadCreationTimes.empty())
+        {
+            double threadCreationAverage = calculateAverage(threadCreationTimes);
+            double threadCreationStdDev = calculateStandardDeviation(threadCreationTimes, threadCreationAverage);
+            saveResultsToJSON("C++_thread_creation.json", threadCreationTimes, threadCreationAverage, threadCreationStdDev, "Thread Creation", numTests, language, 0, iterations, threshold, kernelChecksum, mismatches, cache[point].key);
+        }
+        else
+        {
+            discardSamples(threadCreationTimes);
+            logMessage("All thread creation times were outliers for " + std::to_string(iterations) + " iterations.");
+        }
+    }
+}
+
+void ContextSwitchMain(int numTests, double threshold)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, "C++_context_switch.json"});
+
+    for (const ContextSwitchCase &contextSwitch : CONTEXT_SWITCH_CASES)
+    {
+        std::vector<CachedPoint> cache = lookupSweep(contextSwitch.process, {codeOf(contextSwitch.measure)}, "iterations", ITERATIONS, numTests, threshold);
+
+        for (size_t point = 0; point < ITERATIONS.size(); ++point)
+        {
+            int iterations = ITERATIONS[point];
+            if (reuseCachedResult(cache[point], "C++_context_switch.json"))
+            {
+                continue;
+            }
+
+            SampleBuffer contextSwitchTimes = sampleArena.acquire();
+            uint64_t expected = expectedChecksum("Context Switch", iterations);
+            int mismatches = 0;
+
+            for (int i = 0; i < numTests; ++i)
+            {
+                contextSwitchTimes.push(contextSwitch.measure(iterations));
+                mismatches += kernelChecksum != expected;
+            }
+
+            removeOutliers(contextSwitchTimes, threshold);
+
+            if (!contextSwitchTimes.empty())
+            {
+                double contextSwitchAverage = calculateAverage(contextSwitchTimes);
+                double contextSwitchStdDev = calculateStandardDeviation(contextSwitchTimes, contextSwitchAverage);
+                saveResultsToJSON("C++_context_switch.json", contextSwitchTimes, contextSwitchAverage, contextSwitchStdDev, contextSwitch.process, numTests, language, 0, iterations, threshold, kernelChecksum, mismatches, cache[point].key);
+            }
+            else
+            {
+                discardSamples(contextSwitchTimes);
+                logMessage(std::string("All ") + contextSwitch.process + " times were outliers for " + std::to_string(iterations) + " iterations.");
+            }
+        }
+    }
+}
+
+void ThreadMigrationMain(int numTests, double threshold)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, "C++_thread_migration.json"});
+
+    std::vector<CachedPoint> cache = lookupSweep("Thread Migration", {codeOf(measureThreadMigrationTime)}, "iterations", ITERATIONS, numTests, threshold);
+
+    for (size_t point = 0; point < ITERATIONS.size(); ++point)
+    {
+        int iterations = ITERATIONS[point];
+        if (reuseCachedResult(cache[point], "C++_thread_migration.json"))
+        {
+            continue;
+        }
+
+        SampleBuffer threadMigrationTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Thread Migration", iterations);
+        int mismatches = 0;
+
+        for (int i = 0; i < numTests; ++i)
+        {
+            threadMigrationTimes.push(measureThreadMigrationTime(iterations));
+            mismatches += kernelChecksum != expected;
+        }
+
+        removeOutliers(threadMigrationTimes, threshold);
+
+        if (!threadMigrationTimes.empty())
+        {
+            double threadMigrationAverage = calculateAverage(threadMigrationTimes);
+            double threadMigrationStdDev = calculateStandardDeviation(threadMigrationTimes, threadMigrationAverage);
+            saveResultsToJSON("C++_thread_migration.json", threadMigrationTimes, threadMigrationAverage, threadMigrationStdDev, "Thread Migration", numTests, language, 0, iterations, threshold, kernelChecksum, mismatches, cache[point].key);
+        }
+        else
+        {
+            discardSamples(threadMigrationTimes);
+            logMessage("All thread migration times were outliers for " + std::to_string(iterations) + " iterations.");
+        }
+    }
+}
+
+const char *CONTENTION_FILE = "C++_lock_contention.json";
+
+// Each counter layout over 1..N threads. The thread count goes in the
+// iterations column, so the results keep the ns/op schema of the other
+// benchmarks; they are C++ only and stay out of C++_results.json.
+void FalseSharingMain(int numTests, double threshold)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, "C++_false_sharing.json"});
+
+    std::vector<int> threadCounts = threadSweep(std::max(1u, std::thread::hardware_concurrency()));
+    for (const FalseSharingLayout &layout : FALSE_SHARING_LAYOUTS)
+    {
+        std::vector<CachedPoint> cache = lookupSweep(layout.process, {codeOf(measureFalseSharing)}, "threads", threadCounts, numTests, threshold);
+
+        for (size_t point = 0; point < threadCounts.size(); ++point)
+        {
+            int threads = threadCounts[point];
+            if (reuseCachedResult(cache[point], "C++_false_sharing.json"))
+            {
+                continue;
+            }
+
+            SampleBuffer falseSharingTimes = sampleArena.acquire();
+            uint64_t expected = static_cast<uint64_t>(threads) * FALSE_SHARING_INCREMENTS;
+            int mismatches = 0;
+
+            for (int i = 0; i < numTests; ++i)
+            {
+                falseSharingTimes.push(measureFalseSharing(threads, layout.stride, FALSE_SHARING_INCREMENTS));
+                mismatches += kernelChecksum != expected;
+            }
+
+            removeOutliers(falseSharingTimes, threshold);
+
+            if (!falseSharingTimes.empty())
+            {
+                double falseSharingAverage = calculateAverage(falseSharingTimes);
+                double falseSharingStdDev = calculateStandardDeviation(falseSharingTimes, falseSharingAverage);
+                saveResultsToJSON("C++_false_sharing.json", falseSharingTimes, falseSharingAverage, falseSharingStdDev, layout.process, numTests, language, 0, threads, threshold, kernelChecksum, mismatches, cache[point].key);
+                logMessage(std::string(layout.process) + ", " + std::to_string(threads) + " threads: " + std::to_string(1e3 / falseSharingAverage) + " Mops/s");
+            }
+            else
+            {
+                discardSamples(falseSharingTimes);
+                logMessage(std::string("All ") + layout.process + " times were outliers for " + std::to_string(threads) + " threads.");
+            }
+        }
+    }
+}
+
+template <typename Primitive>
+void measureContention(const char *name, const std::vector<int> &threadCounts, const std::vector<int> &criticalSections, int runs, int durationMs)
+{
+    for (int criticalSection : criticalSections)
+    {
+        for (int threads : threadCounts)
+        {
+            std::vector<double> nanosPerOperation, latencies;
+            double throughput = 0.0, fairness = 0.0;
+            bool valid = true;
+            for (int run = 0; run < runs; ++run)
+            {
+                ContentionRun result = runContention<Primitive>(threads, criticalSection, durationMs, latencies);
+                throughput += result.operations / result.seconds / runs;
+                fairness += result.fairness / runs;
+                nanosPerOperation.push_back(result.seconds * 1e9 / std::max<uint64_t>(result.operations, 1));
+                valid = valid && result.valid;
+            }
+            if (!valid)
+                std::cerr << name << ": lost updates with " << threads << " threads" << std::endl;
+
+            double p99 = percentile(latencies, 0.99);
+            std::ostringstream line;
+            line << std::fixed << std::setprecision(2) << name << ", " << threads << " threads, critical section " << criticalSection
+                 << ": " << throughput / 1e6 << " Mops/s, fairness " << fairness << ", p99 acquire " << p99 << " ns";
+            recordRunResult(CONTENTION_FILE, std::string("Lock Contention: ") + name,
+                            {{"lock", name}, {"threads", threads}, {"critical_section", criticalSection}}, nanosPerOperation,
+                            {{"throughput", throughput}, {"fairness", fairness}, {"p50_acquire_ns", percentile(latencies, 0.50)}, {"p99_acquire_ns", p99}}, valid, line.str());
+        }
+    }
+}
+
+void beginRun()
+{
+    char timestamp[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y%m%dT%H%M%S", std::localtime(&now));
+    runId = std::string(timestamp) + "-" + std::to_string(getpid());
+    gitRevision = detectGitRevision();
+    environment = collectEnvironment();
+    std::cout << "Run " << runId << " at revision " << gitRevision << "\n";
+}
+
+// Lock contention suite: every primitive under 1..N threads, for each
+// critical-section length, written to C++_lock_contention.json.
+int contentionMain(int argc, char *argv[])
+{
+    int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<int> criticalSections = {0, 100};
+    int runs = 5;
+    int durationMs = 200;
+    if (!parseOptions(argc, argv, 2, {{"--threads", &maxThreads}, {"--critical-section", &criticalSections}, {"--runs", &runs}, {"--duration", &durationMs}}))
+    {
+        std::cerr << "Usage: " << argv[0] << " contention [--threads N] [--critical-section 0,100] [--runs 5] [--duration 200]\n";
+        return 2;
+    }
+    if (maxThreads <= 0 || runs <= 0 || durationMs <= 0 || criticalSections.empty())
+    {
+        std::cerr << "Threads, runs, duration and critical sections must be positive\n";
+        return 2;
+    }
+
+    beginRun();
+    submitWrite({WriteRequest::RESET, CONTENTION_FILE});
+    std::vector<int> threadCounts = threadSweep(maxThreads);
+    measureContention<LockedCounter<StdMutexLock>>("std::mutex", threadCounts, criticalSections, runs, durationMs);
+    measureContention<LockedCounter<SharedMutexLock>>("std::shared_mutex", threadCounts, criticalSections, runs, durationMs);
+    measureContention<SharedReaderCounter>("std::shared_mutex (readers)", threadCounts, criticalSections, runs, durationMs);
+    measureContention<LockedCounter<PthreadSpinLock>>("pthread_spinlock", threadCounts, criticalSections, runs, durationMs);
+    measureContention<LockedCounter<TicketLock>>("ticket lock", threadCounts, criticalSections, runs, durationMs);
+    measureContention<LockedCounter<McsLock>>("MCS lock", threadCounts, criticalSections, runs, durationMs);
+    measureContention<FetchAddCounter>("atomic fetch_add", threadCounts, {0}, runs, durationMs);
+    measureContention<CasLoopCounter>("atomic CAS loop", threadCounts, criticalSections, runs, durationMs);
+    resultWriter.drain();
+    return 0;
+}
+
+const char *QUEUE_FILE = "C++_queue_throughput.json";
+const size_t QUEUE_CAPACITY = 1024;
+
+// Message of Size bytes. Every LATENCY_SAMPLE_STRIDE-th one carries the time
+// it was handed to the queue so the consumer can take its end-to-end latency.
+template <size_t Size>
+struct QueueMessage
+{
+    static_assert(Size > 2 * sizeof(uint64_t), "Message must have room for a payload");
+    uint64_t sequence;
+    int64_t sentAt;
+    char payload[Size - 2 * sizeof(uint64_t)];
+};
+
+int64_t steadyNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Bounded lock-free multi-producer/multi-consumer ring (Dmitry Vyukov's
+// design). Each cell's sequence number says whether it is ready to be written
+// or read in the current lap, so producers and consumers only contend on
+// their own index.
+template <typename T, size_t Capacity>
+class MpmcQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+public:
+    MpmcQueue()
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(T &item)
+    {
+        size_t position = tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = cells[position & (Capacity - 1)];
+            intptr_t lag = static_cast<intptr_t>(cell.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position);
+            if (lag == 0 && tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                cell.data = std::move(item);
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+            if (lag < 0)
+                return false;
+            if (lag > 0)
+                position = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPop(T &item)
+    {
+        size_t position = head.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = cells[position & (Capacity - 1)];
+            intptr_t lag = static_cast<intptr_t>(cell.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position + 1);
+            if (lag == 0 && head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                item = std::move(cell.data);
+                cell.sequence.store(position + Capacity, std::memory_order_release);
+                return true;
+            }
+            if (lag < 0)
+                return false;
+            if (lag > 0)
+                position = head.load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) Cell cells[Capacity];
+};
+
+// The queues under test share one batch interface: push and pop move up to
+// count messages and return how many they moved. Only the blocking queue
+// waits; the others return 0 when full or empty and the caller yields.
+template <typename Message>
+class MutexDequeQueue
+{
+public:
+    size_t push(Message *items, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t pushed = std::min(count, QUEUE_CAPACITY - messages.size());
+        messages.insert(messages.end(), items, items + pushed);
+        return pushed;
+    }
+
+    size_t pop(Message *items, size_t count)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t popped = std::min(count, messages.size());
+        std::copy(messages.begin(), messages.begin() + popped, items);
+        messages.erase(messages.begin(), messages.begin() + popped);
+        return popped;
+    }
+
+    void close() {}
+
+private:
+    std::mutex mutex;
+    std::deque<Message> messages;
+};
+
+template <typename Message>
+class BlockingQueue
+{
+public:
+    size_t push(Message *items, size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [&]
+                     { return messages.size() < QUEUE_CAPACITY || closed; });
+        size_t pushed = std::min(count, QUEUE_CAPACITY - messages.size());
+        messages.insert(messages.end(), items, items + pushed);
+        lock.unlock();
+        notEmpty.notify_one();
+        return pushed;
+    }
+
+    size_t pop(Message *items, size_t count)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [&]
+                      { return !messages.empty() || closed; });
+        size_t popped = std::min(count, messages.size());
+        std::copy(messages.begin(), messages.begin() + popped, items);
+        messages.erase(messages.begin(), messages.begin() + popped);
+        lock.unlock();
+        notFull.notify_one();
+        return popped;
+    }
+
+    // Wakes consumers still waiting once every message has been received.
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable notEmpty, notFull;
+    std::deque<Message> messages;
+    bool closed = false;
+};
+
+template <typename Ring, typename Message>
+class RingQueue
+{
+public:
+    size_t push(Message *items, size_t count)
+    {
+        size_t pushed = 0;
+        while (pushed < count && ring.tryPush(items[pushed]))
+        {
+            ++pushed;
+        }
+        return pushed;
+    }
+
+    size_t pop(Message *items, size_t count)
+    {
+        size_t popped = 0;
+        while (popped < count && ring.tryPop(items[popped]))
+        {
+            ++popped;
+        }
+        return popped;
+    }
+
+    void close() {}
+
+private:
+    Ring ring;
+};
+
+struct QueueRun
+{
+    double seconds;
+    uint64_t messages;
+    bool valid;
+};
+
+// Each producer sends messagesPerProducer messages in batches of batch; the
+// consumers pop up to batch at a time until all of them have arrived. The
+// sum of the received sequence numbers must match what was sent, so a queue
+// that drops or duplicates a message fails the checksum.
+template <typename Queue, typename Message>
+QueueRun runQueue(int producers, int consumers, int batch, int messagesPerProducer, std::vector<double> &latencies)
+{
+    auto queue = std::make_unique<Queue>();
+    uint64_t total = static_cast<uint64_t>(producers) * messagesPerProducer;
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> checksum{0};
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::mutex latencyMutex;
+
+    auto waitForStart = [&]
+    {
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int p = 0; p < producers; ++p)
+    {
+        workers.emplace_back([&]
+                             {
+            std::vector<Message> buffer(batch);
+            for (Message &message : buffer)
+            {
+                std::memset(message.payload, 0x5a, sizeof(message.payload));
+            }
+            waitForStart();
+            for (int sequence = 0; sequence < messagesPerProducer; sequence += batch)
+            {
+                size_t count = std::min(batch, messagesPerProducer - sequence);
+                for (size_t i = 0; i < count; ++i)
+                {
+                    buffer[i].sequence = sequence + i;
+                    buffer[i].sentAt = (sequence + i) % LATENCY_SAMPLE_STRIDE == 0 ? steadyNanos() : 0;
+                }
+                size_t sent = 0;
+                while (sent < count)
+                {
+                    size_t pushed = queue->push(buffer.data() + sent, count - sent);
+                    if (pushed == 0)
+                        std::this_thread::yield();
+                    sent += pushed;
+                }
+            } });
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        workers.emplace_back([&]
+                             {
+            std::vector<Message> buffer(batch);
+            std::vector<double> samples;
+            samples.reserve(MAX_LATENCY_SAMPLES);
+            uint64_t sum = 0;
+            waitForStart();
+            while (received.load(std::memory_order_relaxed) < total)
+            {
+                size_t count = queue->pop(buffer.data(), batch);
+                if (count == 0)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                int64_t now = steadyNanos();
+                for (size_t i = 0; i < count; ++i)
+                {
+                    sum += buffer[i].sequence;
+                    if (buffer[i].sentAt != 0 && samples.size() < MAX_LATENCY_SAMPLES)
+                        samples.push_back(static_cast<double>(now - buffer[i].sentAt));
+                }
+                if (received.fetch_add(count, std::memory_order_relaxed) + count == total)
+                    queue->close();
+            }
+            checksum.fetch_add(sum);
+            std::lock_guard<std::mutex> lock(latencyMutex);
+            latencies.insert(latencies.end(), samples.begin(), samples.end()); });
+    }
+    while (ready.load() < producers + consumers)
+    {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = elapsedNanos(start) / 1e9;
+
+    uint64_t expected = static_cast<uint64_t>(producers) * messagesPerProducer * (messagesPerProducer - 1ULL) / 2;
+    return {seconds, received.load(), received.load() == total && checksum.load() == expected};
+}
+
+struct QueueSweep
+{
+    std::vector<int> producerCounts;
+    std::vector<int> consumerCounts;
+    std::vector<int> batches;
+    int messagesPerProducer;
+    int runs;
+};
+
+template <typename Queue, typename Message>
+void measureQueue(const char *name, int producers, int consumers, int batch, const QueueSweep &sweep)
+{
+    std::vector<double> nanosPerMessage, latencies;
+    double throughput = 0.0;
+    bool valid = true;
+    for (int run = 0; run < sweep.runs; ++run)
+    {
+        QueueRun result = runQueue<Queue, Message>(producers, consumers, batch, sweep.messagesPerProducer, latencies);
+        throughput += result.messages / result.seconds / sweep.runs;
+        nanosPerMessage.push_back(result.seconds * 1e9 / std::max<uint64_t>(result.messages, 1));
+        valid = valid && result.valid;
+    }
+    if (!valid)
+        std::cerr << name << ": lost or duplicated messages with " << producers << " producer(s) and " << consumers << " consumer(s)" << std::endl;
+
+    double p99 = percentile(latencies, 0.99);
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(2) << name << ", " << producers << "P/" << consumers << "C, " << sizeof(Message) << " B, batch " << batch
+         << ": " << throughput / 1e6 << " Mmsgs/s, p99 latency " << p99 << " ns";
+    recordRunResult(QUEUE_FILE, std::string("Queue Throughput: ") + name,
+                    {{"queue", name}, {"producers", producers}, {"consumers", consumers}, {"message_size", sizeof(Message)}, {"batch", batch}}, nanosPerMessage,
+                    {{"throughput", throughput}, {"p50_latency_ns", percentile(latencies, 0.50)}, {"p99_latency_ns", p99}, {"p999_latency_ns", percentile(latencies, 0.999)}}, valid, line.str());
+}
+
+template <size_t Size>
+void measureQueues(const QueueSweep &sweep)
+{
+    using Message = QueueMessage<Size>;
+    for (int batch : sweep.batches)
+    {
+        for (int producers : sweep.producerCounts)
+        {
+            for (int consumers : sweep.consumerCounts)
+            {
+                measureQueue<MutexDequeQueue<Message>, Message>("std::mutex + std::deque", producers, consumers, batch, sweep);
+                measureQueue<BlockingQueue<Message>, Message>("condition_variable queue", producers, consumers, batch, sweep);
+                if (producers == 1 && consumers == 1)
+                    measureQueue<RingQueue<SpscQueue<Message, QUEUE_CAPACITY>, Message>, Message>("SPSC ring", producers, consumers, batch, sweep);
+                measureQueue<RingQueue<MpmcQueue<Message, QUEUE_CAPACITY>, Message>, Message>("Vyukov MPMC ring", producers, consumers, batch, sweep);
+            }
+        }
+    }
+}
+
+// Queue throughput suite: messages per second and end-to-end latency of each
+// queue over producer/consumer counts, message sizes and batch sizes, written
+// to C++_queue_throughput.json next to the context switch results.
+int queuesMain(int argc, char *argv[])
+{
+    int maxProducers = std::max(1u, std::thread::hardware_concurrency() / 2);
+    int maxConsumers = maxProducers;
+    std::vector<int> sizes = {32, 256, 1024};
+    QueueSweep sweep{{}, {}, {1, 16}, 100000, 3};
+    if (!parseOptions(argc, argv, 2, {{"--producers", &maxProducers}, {"--consumers", &maxConsumers}, {"--sizes", &sizes}, {"--batch", &sweep.batches}, {"--messages", &sweep.messagesPerProducer}, {"--runs", &sweep.runs}}))
+    {
+        std::cerr << "Usage: " << argv[0] << " queues [--producers N] [--consumers N] [--sizes 32,256,1024] [--batch 1,16] [--messages 100000] [--runs 3]\n";
+        return 2;
+    }
+    bool validBatches = !sweep.batches.empty() && *std::min_element(sweep.batches.begin(), sweep.batches.end()) > 0;
+    if (maxProducers <= 0 || maxConsumers <= 0 || sweep.messagesPerProducer <= 0 || sweep.runs <= 0 || !validBatches)
+    {
+        std::cerr << "Producers, consumers, messages, runs and batch sizes must be positive\n";
+        return 2;
+    }
+    for (int size : sizes)
+    {
+        if (size != 32 && size != 64 && size != 256 && size != 1024 && size != 4096)
+        {
+            std::cerr << "Message sizes must be 32, 64, 256, 1024 or 4096 bytes\n";
+            return 2;
+        }
+    }
+
+    beginRun();
+    submitWrite({WriteRequest::RESET, QUEUE_FILE});
+    sweep.producerCounts = threadSweep(maxProducers);
+    sweep.consumerCounts = threadSweep(maxConsumers);
+    for (int size : sizes)
+    {
+        if (size == 32)
+            measureQueues<32>(sweep);
+        else if (size == 64)
+            measureQueues<64>(sweep);
+        else if (size == 256)
+            measureQueues<256>(sweep);
+        else if (size == 1024)
+            measureQueues<1024>(sweep);
+        else
+            measureQueues<4096>(sweep);
+    }
+    resultWriter.drain();
+    return 0;
+}
+
+const char *LAYOUT_FILE = "C++_memory_layout.json";
+const size_t AOSOA_LANES = 8;
+const size_t MAX_LAYOUT_BYTES = size_t(1) << 30;
+
+// Process names built at run time. A queued result points at its process
+// name until the writer is done with it, so they live as long as the program.
+const char *internProcessName(const std::string &name)
+{
+    static std::set<std::string> names;
+    return names.insert(name).first->c_str();
+}
+
+// The three layouts of n records with Fields fields each. Field f of record i
+// holds i + f, and AoSoA pads its last block with zeros.
+template <typename Field, int Fields>
+struct AosLayout
+{
+    struct Record
+    {
+        Field fields[Fields];
+    };
+    std::vector<Record> records;
+
+    void build(size_t n)
+    {
+        records.resize(n);
+        for (size_t i = 0; i < n; ++i)
+            for (int f = 0; f < Fields; ++f)
+                records[i].fields[f] = static_cast<Field>(i + f);
+    }
+};
+
+template <typename Field, int Fields>
+struct SoaLayout
+{
+    std::vector<Field> columns[Fields];
+    size_t size = 0;
+
+    void build(size_t n)
+    {
+        size = n;
+        for (int f = 0; f < Fields; ++f)
+        {
+            columns[f].resize(n);
+            for (size_t i = 0; i < n; ++i)
+                columns[f][i] = static_cast<Field>(i + f);
+        }
+    }
+};
+
+template <typename Field, int Fields>
+struct AosoaLayout
+{
+    struct Block
+    {
+        Field fields[Fields][AOSOA_LANES];
+    };
+    std::vector<Block> blocks;
+
+    void build(size_t n)
+    {
+        blocks.assign((n + AOSOA_LANES - 1) / AOSOA_LANES, Block{});
+        for (size_t i = 0; i < n; ++i)
+            for (int f = 0; f < Fields; ++f)
+                blocks[i / AOSOA_LANES].fields[f][i % AOSOA_LANES] = static_cast<Field>(i + f);
+    }
+};
+
+// The scalar variants force the accumulator through a register after every
+// addition, which keeps the compiler from vectorizing the loop around it.
+template <bool Vectorize>
+inline void scalarStep(uint64_t &sum)
+{
+    if constexpr (!Vectorize)
+        asm volatile("" : "+r"(sum));
+}
+
+template <bool AllFields, bool Vectorize, typename Field, int Fields>
+uint64_t traverseAos(const AosLayout<Field, Fields> &layout)
+{
+    uint64_t sum = 0;
+    for (const auto &record : layout.records)
+    {
+        for (int f = 0; f < (AllFields ? Fields : 1); ++f)
+        {
+            sum += record.fields[f];
+            scalarStep<Vectorize>(sum);
+        }
+    }
+    return sum;
+}
+
+template <bool AllFields, bool Vectorize, typename Field, int Fields>
+uint64_t traverseSoa(const SoaLayout<Field, Fields> &layout)
+{
+    const Field *columns[Fields];
+    for (int f = 0; f < Fields; ++f)
+        columns[f] = layout.columns[f].data();
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < layout.size; ++i)
+    {
+        for (int f = 0; f < (AllFields ? Fields : 1); ++f)
+        {
+            sum += columns[f][i];
+            scalarStep<Vectorize>(sum);
+        }
+    }
+    return sum;
+}
+
+template <bool AllFields, bool Vectorize, typename Field, int Fields>
+uint64_t traverseAosoa(const AosoaLayout<Field, Fields> &layout)
+{
+    uint64_t sum = 0;
+    for (const auto &block : layout.blocks)
+    {
+        for (int f = 0; f < (AllFields ? Fields : 1); ++f)
+        {
+            for (size_t lane = 0; lane < AOSOA_LANES; ++lane)
+            {
+                sum += block.fields[f][lane];
+                scalarStep<Vectorize>(sum);
+            }
+        }
+    }
+    return sum;
+}
+
+// One variant at one array size. Returns ns per record.
+template <bool AllFields, bool Vectorize, typename Layout, typename Traverse>
+double measureLayoutTraversal(const Layout &layout, Traverse traverse, int size)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sum = traverse(layout, std::bool_constant<AllFields>(), std::bool_constant<Vectorize>());
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = sum;
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / size;
+}
+
+template <bool AllFields, bool Vectorize, typename Layout, typename Traverse>
+void measureLayoutPoint(const Layout &layout, Traverse traverse, const char *process, CachedPoint &cached, int size, int fields, int numTests, double threshold)
+{
+    if (reuseCachedResult(cached, LAYOUT_FILE))
+    {
+        return;
+    }
+
+    uint64_t n = size;
+    uint64_t expected = AllFields ? fields * (n * (n - 1) / 2) + n * (fields * (fields - 1) / 2) : n * (n - 1) / 2;
+    SampleBuffer layoutTimes = sampleArena.acquire();
+    int mismatches = 0;
+    for (int i = 0; i < numTests; ++i)
+    {
+        layoutTimes.push(measureLayoutTraversal<AllFields, Vectorize>(layout, traverse, size));
+        mismatches += kernelChecksum != expected;
+    }
+
+    removeOutliers(layoutTimes, threshold);
+
+    if (!layoutTimes.empty())
+    {
+        double layoutAverage = calculateAverage(layoutTimes);
+        double layoutStdDev = calculateStandardDeviation(layoutTimes, layoutAverage);
+        saveResultsToJSON(LAYOUT_FILE, layoutTimes, layoutAverage, layoutStdDev, process, numTests, "C++", size, 0, threshold, kernelChecksum, mismatches, cached.key);
+    }
+    else
+    {
+        discardSamples(layoutTimes);
+        logMessage(std::string("All ") + process + " times were outliers for array size " + std::to_string(size) + ".");
+    }
+}
+
+// Every array size for one layout, touching one field or all of them, in
+// scalar and auto-vectorized form. The records are built once per size.
+template <typename Layout, typename Traverse>
+void measureLayout(const char *layoutName, Traverse traverse, int fields, size_t recordBytes, int numTests, double threshold)
+{
+    std::string shape = std::to_string(fields) + "x" + std::to_string(recordBytes / fields) + "B";
+    const char *processes[4];
+    std::vector<CachedPoint> cache[4];
+    const void *kernels[4] = {codeOf(measureLayoutTraversal<false, false, Layout, Traverse>), codeOf(measureLayoutTraversal<false, true, Layout, Traverse>),
+                              codeOf(measureLayoutTraversal<true, false, Layout, Traverse>), codeOf(measureLayoutTraversal<true, true, Layout, Traverse>)};
+    for (int variant = 0; variant < 4; ++variant)
+    {
+        processes[variant] = internProcessName(std::string("Memory Layout: ") + layoutName + " " + shape + (variant & 2 ? ", All Fields" : ", One Field") + (variant & 1 ? ", Vectorized" : ", Scalar"));
+        cache[variant] = lookupSweep(processes[variant], {kernels[variant]}, "array_size", ARRAY_SIZES, numTests, threshold);
+    }
+
+    for (size_t point = 0; point < ARRAY_SIZES.size(); ++point)
+    {
+        int size = ARRAY_SIZES[point];
+        if (size * recordBytes > MAX_LAYOUT_BYTES)
+        {
+            logMessage(std::string("Skipping ") + layoutName + " " + shape + " at array size " + std::to_string(size) + ": it needs more than 1 GiB.");
+            continue;
+        }
+
+        auto layout = std::make_unique<Layout>();
+        layout->build(size);
+        measureLayoutPoint<false, false>(*layout, traverse, processes[0], cache[0][point], size, fields, numTests, threshold);
+        measureLayoutPoint<false, true>(*layout, traverse, processes[1], cache[1][point], size, fields, numTests, threshold);
+        measureLayoutPoint<true, false>(*layout, traverse, processes[2], cache[2][point], size, fields, numTests, threshold);
+        measureLayoutPoint<true, true>(*layout, traverse, processes[3], cache[3][point], size, fields, numTests, threshold);
+    }
+}
+
+template <typename Field, int Fields>
+void MemoryLayoutMain(int numTests, double threshold)
+{
+    std::cout << std::fixed << std::setprecision(6);
+    submitWrite({WriteRequest::RESET, LAYOUT_FILE});
+
+    size_t recordBytes = sizeof(Field) * Fields;
+    measureLayout<AosLayout<Field, Fields>>("AoS", [](const auto &layout, auto allFields, auto vectorize)
+                                            { return traverseAos<allFields, vectorize>(layout); }, Fields, recordBytes, numTests, threshold);
+    measureLayout<SoaLayout<Field, Fields>>("SoA", [](const auto &layout, auto allFields, auto vectorize)
+                                            { return traverseSoa<allFields, vectorize>(layout); }, Fields, recordBytes, numTests, threshold);
+    measureLayout<AosoaLayout<Field, Fields>>("AoSoA", [](const auto &layout, auto allFields, auto vectorize)
+                                              { return traverseAosoa<allFields, vectorize>(layout); }, Fields, recordBytes, numTests, threshold);
+}
+
+// Memory layout suite: AoS, SoA and AoSoA records over ARRAY_SIZES, written
+// to C++_memory_layout.json. Field count and field size pick the record.
+int layoutMain(int argc, char *argv[])
+{
+    const char *usage = " layout <number_of_tests> <outlier_threshold> [--fields 2|4|8|16] [--field-size 4|8] [--force]\n";
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    int numTests = std::stoi(argv[2]);
+    double threshold = std::stod(argv[3]);
+    int fields = 8;
+    int fieldSize = 4;
+    if (!parseOptions(argc, argv, 4, {{"--fields", &fields}, {"--field-size", &fieldSize}, {"--force", &forceRun}}))
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    if (numTests <= 0 || (fields != 2 && fields != 4 && fields != 8 && fields != 16) || (fieldSize != 4 && fieldSize != 8))
+    {
+        std::cerr << "Number of tests must be positive, fields 2, 4, 8 or 16 and the field size 4 or 8 bytes\n";
+        return 2;
+    }
+    sampleArena.reserve(numTests);
+
+    beginRun();
+    if (fieldSize == 4)
+    {
+        if (fields == 2)
+            MemoryLayoutMain<uint32_t, 2>(numTests, threshold);
+        else if (fields == 4)
+            MemoryLayoutMain<uint32_t, 4>(numTests, threshold);
+        else if (fields == 8)
+            MemoryLayoutMain<uint32_t, 8>(numTests, threshold);
+        else
+            MemoryLayoutMain<uint32_t, 16>(numTests, threshold);
+    }
+    else
+    {
+        if (fields == 2)
+            MemoryLayoutMain<uint64_t, 2>(numTests, threshold);
+        else if (fields == 4)
+            MemoryLayoutMain<uint64_t, 4>(numTests, threshold);
+        else if (fields == 8)
+            MemoryLayoutMain<uint64_t, 8>(numTests, threshold);
+        else
+            MemoryLayoutMain<uint64_t, 16>(numTests, threshold);
+    }
+    resultWriter.drain();
+    return 0;
+}
+
+const char *PATTERN_FILE = "C++_access_patterns.json";
+const size_t TILE_SIDE = 64;
+
+// Access pattern engine over the dynamic access array. Every walk reads each
+// element it covers exactly once, so the sum is always m * (m - 1) / 2 for the
+// m elements visited and ns/element compares directly across patterns. The
+// 2-D walks cover the largest square that fits in the array.
+enum class AccessWalk
+{
+    STRIDED,
+    REVERSE,
+    ROW_MAJOR,
+    COLUMN_MAJOR,
+    TILED,
+    GATHER
+};
+
+struct AccessPattern
+{
+    const char *process;
+    AccessWalk walk;
+    size_t stride;
+};
+
+// stride passes; pass p reads p, p + stride, p + 2 * stride, ...
+uint64_t walkStrided(const int *array, size_t n, size_t stride)
+{
+    uint64_t sum = 0;
+    for (size_t pass = 0; pass < stride; ++pass)
+    {
+        for (size_t i = pass; i < n; i += stride)
+        {
+            sum += array[i];
+        }
+    }
+    return sum;
+}
+
+uint64_t walkReverse(const int *array, size_t n)
+{
+    uint64_t sum = 0;
+    for (size_t i = n; i-- > 0;)
+    {
+        sum += array[i];
+    }
+    return sum;
+}
+
+uint64_t walkRowMajor(const int *matrix, size_t side)
+{
+    uint64_t sum = 0;
+    for (size_t row = 0; row < side; ++row)
+    {
+        for (size_t column = 0; column < side; ++column)
+        {
+            sum += matrix[row * side + column];
+        }
+    }
+    return sum;
+}
+
+uint64_t walkColumnMajor(const int *matrix, size_t side)
+{
+    uint64_t sum = 0;
+    for (size_t column = 0; column < side; ++column)
+    {
+        for (size_t row = 0; row < side; ++row)
+        {
+            sum += matrix[row * side + column];
+        }
+    }
+    return sum;
+}
+
+// Column-major inside TILE_SIDE x TILE_SIDE tiles, so each tile's lines stay
+// cached while its columns are read.
+uint64_t walkTiled(const int *matrix, size_t side)
+{
+    uint64_t sum = 0;
+    for (size_t tileRow = 0; tileRow < side; tileRow += TILE_SIDE)
+    {
+        for (size_t tileColumn = 0; tileColumn < side; tileColumn += TILE_SIDE)
+        {
+            size_t rowEnd = std::min(tileRow + TILE_SIDE, side);
+            size_t columnEnd = std::min(tileColumn + TILE_SIDE, side);
+            for (size_t column = tileColumn; column < columnEnd; ++column)
+            {
+                for (size_t row = tileRow; row < rowEnd; ++row)
+                {
+                    sum += matrix[row * side + column];
+                }
+            }
+        }
+    }
+    return sum;
+}
+
+uint64_t walkGather(const int *array, const uint32_t *indices, size_t n)
+{
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        sum += array[indices[i]];
+    }
+    return sum;
+}
+
+size_t elementsVisited(const AccessPattern &pattern, size_t n)
+{
+    bool square = pattern.walk == AccessWalk::ROW_MAJOR || pattern.walk == AccessWalk::COLUMN_MAJOR || pattern.walk == AccessWalk::TILED;
+    size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(n)));
+    return square ? side * side : n;
+}
+
+// Returns ns per element visited.
+double measureAccessPattern(const AccessPattern &pattern, const int *array, const uint32_t *indices, size_t n)
+{
+    size_t visited = elementsVisited(pattern, n);
+    size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(visited)));
+
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sum = 0;
+    switch (pattern.walk)
+    {
+    case AccessWalk::STRIDED:
+        sum = walkStrided(array, n, pattern.stride);
+        break;
+    case AccessWalk::REVERSE:
+        sum = walkReverse(array, n);
+        break;
+    case AccessWalk::ROW_MAJOR:
+        sum = walkRowMajor(array, side);
+        break;
+    case AccessWalk::COLUMN_MAJOR:
+        sum = walkColumnMajor(array, side);
+        break;
+    case AccessWalk::TILED:
+        sum = walkTiled(array, side);
+        break;
+    case AccessWalk::GATHER:
+        sum = walkGather(array, indices, n);
+        break;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = sum;
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / visited;
+}
+
+void AccessPatternMain(int numTests, double threshold, const std::vector<int> &strides)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, PATTERN_FILE});
+
+    std::vector<AccessPattern> patterns;
+    for (int stride : strides)
+    {
+        patterns.push_back({internProcessName("Access Pattern: Stride " + std::to_string(stride)), AccessWalk::STRIDED, static_cast<size_t>(stride)});
+    }
+    patterns.push_back({"Access Pattern: Reverse", AccessWalk::REVERSE, 1});
+    patterns.push_back({"Access Pattern: Row-Major", AccessWalk::ROW_MAJOR, 1});
+    patterns.push_back({"Access Pattern: Column-Major", AccessWalk::COLUMN_MAJOR, 1});
+    patterns.push_back({"Access Pattern: Tiled", AccessWalk::TILED, 1});
+    patterns.push_back({"Access Pattern: Gather", AccessWalk::GATHER, 1});
+
+    std::vector<std::vector<CachedPoint>> cache;
+    for (const AccessPattern &pattern : patterns)
+    {
+        cache.push_back(lookupSweep(pattern.process, {codeOf(measureAccessPattern)}, "array_size", ARRAY_SIZES, numTests, threshold));
+    }
+
+    for (size_t point = 0; point < ARRAY_SIZES.size(); ++point)
+    {
+        int size = ARRAY_SIZES[point];
+        std::vector<int> array(size);
+        std::iota(array.begin(), array.end(), 0);
+        std::vector<uint32_t> indices(size);
+        std::iota(indices.begin(), indices.end(), 0);
+        std::shuffle(indices.begin(), indices.end(), std::mt19937(42));
+
+        for (size_t p = 0; p < patterns.size(); ++p)
+        {
+            const AccessPattern &pattern = patterns[p];
+            // A stride wider than the array is a series of single reads.
+            if (pattern.stride > static_cast<size_t>(size) || reuseCachedResult(cache[p][point], PATTERN_FILE))
+            {
+                continue;
+            }
+
+            uint64_t visited = elementsVisited(pattern, size);
+            uint64_t expected = visited * (visited - 1) / 2;
+            SampleBuffer patternTimes = sampleArena.acquire();
+            int mismatches = 0;
+            for (int i = 0; i < numTests; ++i)
+            {
+                patternTimes.push(measureAccessPattern(pattern, array.data(), indices.data(), size));
+                mismatches += kernelChecksum != expected;
+            }
+
+            removeOutliers(patternTimes, threshold);
+
+            if (!patternTimes.empty())
+            {
+                double patternAverage = calculateAverage(patternTimes);
+                double patternStdDev = calculateStandardDeviation(patternTimes, patternAverage);
+                saveResultsToJSON(PATTERN_FILE, patternTimes, patternAverage, patternStdDev, pattern.process, numTests, language, size, 0, threshold, kernelChecksum, mismatches, cache[p][point].key, sizeof(int));
+            }
+            else
+            {
+                discardSamples(patternTimes);
+                logMessage(std::string("All ") + pattern.process + " times were outliers for array size " + std::to_string(size) + ".");
+            }
+        }
+    }
+}
+
+// Access pattern suite: strided, reverse, 2-D, tiled and gather walks over
+// ARRAY_SIZES in ns/element and GB/s, written to C++_access_patterns.json.
+int patternsMain(int argc, char *argv[])
+{
+    const char *usage = " patterns <number_of_tests> <outlier_threshold> [--strides 1,2,4,...,4096] [--force]\n";
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    int numTests = std::stoi(argv[2]);
+    double threshold = std::stod(argv[3]);
+    std::vector<int> strides;
+    for (int stride = 1; stride <= 4096; stride *= 2)
+    {
+        strides.push_back(stride);
+    }
+    if (!parseOptions(argc, argv, 4, {{"--strides", &strides}, {"--force", &forceRun}}))
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    if (numTests <= 0 || strides.empty() || *std::min_element(strides.begin(), strides.end()) <= 0)
+    {
+        std::cerr << "Number of tests and strides must be positive\n";
+        return 2;
+    }
+    sampleArena.reserve(numTests);
+
+    beginRun();
+    AccessPatternMain(numTests, threshold, strides);
+    resultWriter.drain();
+    return 0;
+}
+
+const char *BANDWIDTH_FILE = "C++_write_bandwidth.json";
+const int MEMSET_BYTE = 0x01;
+
+// Write, read-modify-write and copy kernels over int arrays. The store and
+// streaming variants run the same 128-bit loop and differ only in the store
+// instruction: _mm_store_si128 goes through the cache, _mm_stream_si128
+// writes around it. Without SSE2 only the plain loops and memset/memcpy run.
+enum class BandwidthKernel
+{
+    WRITE,
+    WRITE_MEMSET,
+    READ_MODIFY_WRITE,
+    COPY,
+    COPY_MEMCPY
+};
+
+struct BandwidthVariant
+{
+    const char *process;
+    BandwidthKernel operation;
+    bool streaming;
+    double bytesPerElement;
+};
+
+const BandwidthVariant BANDWIDTH_VARIANTS[] = {
+    {"Write: Stores", BandwidthKernel::WRITE, false, sizeof(int)},
+    {"Write: Non-Temporal Stores", BandwidthKernel::WRITE, true, sizeof(int)},
+    {"Write: memset", BandwidthKernel::WRITE_MEMSET, false, sizeof(int)},
+    {"Read-Modify-Write: Stores", BandwidthKernel::READ_MODIFY_WRITE, false, 2 * sizeof(int)},
+    {"Read-Modify-Write: Non-Temporal Stores", BandwidthKernel::READ_MODIFY_WRITE, true, 2 * sizeof(int)},
+    {"Copy: Stores", BandwidthKernel::COPY, false, 2 * sizeof(int)},
+    {"Copy: Non-Temporal Stores", BandwidthKernel::COPY, true, 2 * sizeof(int)},
+    {"Copy: memcpy", BandwidthKernel::COPY_MEMCPY, false, 2 * sizeof(int)}};
+
+#if defined(__SSE2__)
+template <bool Streaming>
+inline void storeVector(int *target, __m128i value)
+{
+    if constexpr (Streaming)
+        _mm_stream_si128(reinterpret_cast<__m128i *>(target), value);
+    else
+        _mm_store_si128(reinterpret_cast<__m128i *>(target), value);
+}
+#endif
+
+// array[i] = i. array is 64-byte aligned.
+template <bool Streaming>
+void writeArray(int *array, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    __m128i values = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i step = _mm_set1_epi32(4);
+    for (; i + 4 <= n; i += 4)
+    {
+        storeVector<Streaming>(array + i, values);
+        values = _mm_add_epi32(values, step);
+    }
+    if (Streaming)
+        _mm_sfence();
+#endif
+    for (; i < n; ++i)
+    {
+        array[i] = static_cast<int>(i);
+    }
+}
+
+// array[i] += 1.
+template <bool Streaming>
+void readModifyWriteArray(int *array, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i one = _mm_set1_epi32(1);
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i value = _mm_load_si128(reinterpret_cast<const __m128i *>(array + i));
+        storeVector<Streaming>(array + i, _mm_add_epi32(value, one));
+    }
+    if (Streaming)
+        _mm_sfence();
+#endif
+    for (; i < n; ++i)
+    {
+        array[i] += 1;
+    }
+}
+
+template <bool Streaming>
+void copyArray(int *target, const int *source, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= n; i += 4)
+    {
+        storeVector<Streaming>(target + i, _mm_load_si128(reinterpret_cast<const __m128i *>(source + i)));
+    }
+    if (Streaming)
+        _mm_sfence();
+#endif
+    for (; i < n; ++i)
+    {
+        target[i] = source[i];
+    }
+}
+
+// Twice the last-level cache, or 64 MiB if the size is not reported.
+size_t evictionBytes()
+{
+    long cache = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (cache <= 0)
+        cache = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return cache > 0 ? 2 * static_cast<size_t>(cache) : size_t(64) << 20;
+}
+
+// Writes one byte per cache line of buffer, pushing earlier data out of the caches.
+void evictCaches(std::vector<char> &buffer)
+{
+    for (size_t i = 0; i < buffer.size(); i += 64)
+    {
+        buffer[i] += 1;
+    }
+}
+
+// Returns ns per element. The checksum is the sum of the written array, taken
+// after the timer stops. Every sample starts with cold caches: the untimed
+// setup and the previous checksum would otherwise leave target cached, which
+// favours regular stores over non-temporal ones at cache-resident sizes.
+double measureBandwidth(const BandwidthVariant &variant, int *target, const int *source, size_t n, std::vector<char> &evictionBuffer)
+{
+    if (variant.operation == BandwidthKernel::READ_MODIFY_WRITE)
+    {
+        std::copy(source, source + n, target);
+    }
+    evictCaches(evictionBuffer);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    switch (variant.operation)
+    {
+    case BandwidthKernel::WRITE:
+        variant.streaming ? writeArray<true>(target, n) : writeArray<false>(target, n);
+        break;
+    case BandwidthKernel::WRITE_MEMSET:
+        std::memset(target, MEMSET_BYTE, n * sizeof(int));
+        break;
+    case BandwidthKernel::READ_MODIFY_WRITE:
+        variant.streaming ? readModifyWriteArray<true>(target, n) : readModifyWriteArray<false>(target, n);
+        break;
+    case BandwidthKernel::COPY:
+        variant.streaming ? copyArray<true>(target, source, n) : copyArray<false>(target, source, n);
+        break;
+    case BandwidthKernel::COPY_MEMCPY:
+        std::memcpy(target, source, n * sizeof(int));
+        break;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = std::accumulate(target, target + n, uint64_t(0), [](uint64_t sum, int value)
+                                     { return sum + static_cast<uint32_t>(value); });
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / n;
+}
+
+uint64_t expectedBandwidthChecksum(BandwidthKernel operation, uint64_t n)
+{
+    switch (operation)
+    {
+    case BandwidthKernel::WRITE_MEMSET:
+        return n * 0x01010101ULL;
+    case BandwidthKernel::READ_MODIFY_WRITE:
+        return n * (n - 1) / 2 + n;
+    default:
+        return n * (n - 1) / 2;
+    }
+}
+
+void WriteBandwidthMain(int numTests, double threshold)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, BANDWIDTH_FILE});
+
+    std::vector<std::vector<CachedPoint>> cache;
+    for (const BandwidthVariant &variant : BANDWIDTH_VARIANTS)
+    {
+        cache.push_back(lookupSweep(variant.process, {codeOf(measureBandwidth), codeOf(expectedBandwidthChecksum)}, "array_size", ARRAY_SIZES, numTests, threshold));
+    }
+    std::vector<char> evictionBuffer(evictionBytes(), 1);
+#if !defined(__SSE2__)
+    logMessage("Non-temporal stores need SSE2; skipping those variants.");
+#endif
+
+    for (size_t point = 0; point < ARRAY_SIZES.size(); ++point)
+    {
+        int size = ARRAY_SIZES[point];
+        size_t bytes = (size * sizeof(int) + 63) / 64 * 64;
+        // Both buffers are written once up front so page faults stay out of the timings.
+        std::unique_ptr<int, decltype(&std::free)> source(static_cast<int *>(std::aligned_alloc(64, bytes)), &std::free);
+        std::unique_ptr<int, decltype(&std::free)> target(static_cast<int *>(std::aligned_alloc(64, bytes)), &std::free);
+        std::iota(source.get(), source.get() + size, 0);
+        std::memset(target.get(), 0, bytes);
+
+        for (size_t v = 0; v < std::size(BANDWIDTH_VARIANTS); ++v)
+        {
+            const BandwidthVariant &variant = BANDWIDTH_VARIANTS[v];
+#if !defined(__SSE2__)
+            if (variant.streaming)
+                continue;
+#endif
+            if (reuseCachedResult(cache[v][point], BANDWIDTH_FILE))
+            {
+                continue;
+            }
+
+            uint64_t expected = expectedBandwidthChecksum(variant.operation, size);
+            SampleBuffer bandwidthTimes = sampleArena.acquire();
+            int mismatches = 0;
+            for (int i = 0; i < numTests; ++i)
+            {
+                bandwidthTimes.push(measureBandwidth(variant, target.get(), source.get(), size, evictionBuffer));
+                mismatches += kernelChecksum != expected;
+            }
+
+            removeOutliers(bandwidthTimes, threshold);
+
+            if (!bandwidthTimes.empty())
+            {
+                double bandwidthAverage = calculateAverage(bandwidthTimes);
+                double bandwidthStdDev = calculateStandardDeviation(bandwidthTimes, bandwidthAverage);
+                saveResultsToJSON(BANDWIDTH_FILE, bandwidthTimes, bandwidthAverage, bandwidthStdDev, variant.process, numTests, language, size, 0, threshold, kernelChecksum, mismatches, cache[v][point].key, variant.bytesPerElement);
+            }
+            else
+            {
+                discardSamples(bandwidthTimes);
+                logMessage(std::string("All ") + variant.process + " times were outliers for array size " + std::to_string(size) + ".");
+            }
+        }
+    }
+}
+
+// Write bandwidth suite: stores, non-temporal stores and memset/memcpy for
+// writes, read-modify-writes and copies over ARRAY_SIZES, written to
+// C++_write_bandwidth.json.
+int bandwidthMain(int argc, char *argv[])
+{
+    if (argc < 4 || !parseOptions(argc, argv, 4, {{"--force", &forceRun}}))
+    {
+        std::cerr << "Usage: " << argv[0] << " bandwidth <number_of_tests> <outlier_threshold> [--force]\n";
+        return 2;
+    }
+    int numTests = std::stoi(argv[2]);
+    double threshold = std::stod(argv[3]);
+    if (numTests <= 0)
+    {
+        std::cerr << "Number of tests must be positive\n";
+        return 2;
+    }
+    sampleArena.reserve(numTests);
+
+    beginRun();
+    WriteBandwidthMain(numTests, threshold);
+    resultWriter.drain();
+    return 0;
+}
+
+const char *CONTAINER_FILE = "C++_containers.json";
+// Inserting into or erasing from a sorted vector shifts half of it on
+// average, so the flat map only runs those above this size.
+const size_t FLAT_MAP_MAX_EDIT_SIZE = 10000;
+
+// Sorted vector of key/value pairs: binary-search lookups over contiguous
+// memory, at the price of O(n) inserts and erases.
+class FlatMap
+{
+public:
+    bool insert(uint64_t key, uint64_t value)
+    {
+        auto it = lowerBound(key);
+        if (it != entries.end() && it->first == key)
+            return false;
+        entries.insert(it, {key, value});
+        return true;
+    }
+
+    const uint64_t *find(uint64_t key) const
+    {
+        auto it = std::lower_bound(entries.begin(), entries.end(), key, [](const Entry &entry, uint64_t k)
+                                   { return entry.first < k; });
+        return it != entries.end() && it->first == key ? &it->second : nullptr;
+    }
+
+    bool erase(uint64_t key)
+    {
+        auto it = lowerBound(key);
+        if (it == entries.end() || it->first != key)
+            return false;
+        entries.erase(it);
+        return true;
+    }
+
+    // Bulk build: append everything, then sort once.
+    void assign(const std::vector<uint64_t> &keys)
+    {
+        entries.clear();
+        entries.reserve(keys.size());
+        for (uint64_t key : keys)
+            entries.push_back({key, key / 2});
+        std::sort(entries.begin(), entries.end());
+    }
+
+    template <typename Visit>
+    void forEach(Visit visit) const
+    {
+        for (const Entry &entry : entries)
+            visit(entry.first, entry.second);
+    }
+
+private:
+    typedef std::pair<uint64_t, uint64_t> Entry;
+    std::vector<Entry> entries;
+
+    std::vector<Entry>::iterator lowerBound(uint64_t key)
+    {
+        return std::lower_bound(entries.begin(), entries.end(), key, [](const Entry &entry, uint64_t k)
+                                { return entry.first < k; });
+    }
+};
+
+// Open-addressing hash map with Robin Hood linear probing. An insert takes
+// the slot of any entry that is closer to its home than the one being placed,
+// which keeps probe lengths even and lets a lookup stop as soon as it passes
+// where its key would have been. Erase shifts the following run back instead
+// of leaving tombstones.
+class RobinHoodMap
+{
+public:
+    bool insert(uint64_t key, uint64_t value)
+    {
+        if ((count + 1) * 8 > slots.size() * 7)
+            grow();
+        Slot entry{key, value, 1};
+        size_t index = hash(key) & mask;
+        while (true)
+        {
+            Slot &slot = slots[index];
+            if (slot.distance == 0)
+            {
+                slot = entry;
+                ++count;
+                return true;
+            }
+            if (slot.key == entry.key)
+                return false;
+            if (slot.distance < entry.distance)
+                std::swap(slot, entry);
+            ++entry.distance;
+            index = (index + 1) & mask;
+        }
+    }
+
+    const uint64_t *find(uint64_t key) const
+    {
+        size_t index = locate(key);
+        return index == NOT_FOUND ? nullptr : &slots[index].value;
+    }
+
+    bool erase(uint64_t key)
+    {
+        size_t index = locate(key);
+        if (index == NOT_FOUND)
+            return false;
+        size_t next = (index + 1) & mask;
+        while (slots[next].distance > 1)
+        {
+            slots[index] = slots[next];
+            --slots[index].distance;
+            index = next;
+            next = (next + 1) & mask;
+        }
+        slots[index].distance = 0;
+        --count;
+        return true;
+    }
+
+    template <typename Visit>
+    void forEach(Visit visit) const
+    {
+        for (const Slot &slot : slots)
+            if (slot.distance != 0)
+                visit(slot.key, slot.value);
+    }
+
+private:
+    // distance is 0 for an empty slot, otherwise one more than how far the
+    // entry sits from its home slot.
+    struct Slot
+    {
+        uint64_t key;
+        uint64_t value;
+        uint32_t distance;
+    };
+
+    static const size_t NOT_FOUND = SIZE_MAX;
+    std::vector<Slot> slots;
+    size_t count = 0;
+    size_t mask = 0;
+
+    static uint64_t hash(uint64_t key)
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        return key;
+    }
+
+    size_t locate(uint64_t key) const
+    {
+        if (slots.empty())
+            return NOT_FOUND;
+        size_t index = hash(key) & mask;
+        for (uint32_t distance = 1;; ++distance)
+        {
+            const Slot &slot = slots[index];
+            if (slot.distance < distance)
+                return NOT_FOUND;
+            if (slot.key == key)
+                return index;
+            index = (index + 1) & mask;
+        }
+    }
+
+    void grow()
+    {
+        std::vector<Slot> old(std::max<size_t>(16, slots.size() * 2), Slot{0, 0, 0});
+        old.swap(slots);
+        mask = slots.size() - 1;
+        count = 0;
+        for (const Slot &slot : old)
+            if (slot.distance != 0)
+                insert(slot.key, slot.value);
+    }
+};
+
+enum class ContainerOperation
+{
+    INSERT,
+    LOOKUP_HIT,
+    LOOKUP_MISS,
+    ITERATE,
+    ERASE
+};
+
+const char *CONTAINER_OPERATION_NAMES[] = {"Insert", "Lookup Hit", "Lookup Miss", "Iterate", "Erase"};
+
+// The same four calls over the standard maps and the two in-project ones.
+template <typename Map>
+bool mapInsert(Map &map, uint64_t key, uint64_t value) { return map.emplace(key, value).second; }
+bool mapInsert(FlatMap &map, uint64_t key, uint64_t value) { return map.insert(key, value); }
+bool mapInsert(RobinHoodMap &map, uint64_t key, uint64_t value) { return map.insert(key, value); }
+
+template <typename Map>
+const uint64_t *mapFind(const Map &map, uint64_t key)
+{
+    auto it = map.find(key);
+    return it == map.end() ? nullptr : &it->second;
+}
+const uint64_t *mapFind(const FlatMap &map, uint64_t key) { return map.find(key); }
+const uint64_t *mapFind(const RobinHoodMap &map, uint64_t key) { return map.find(key); }
+
+template <typename Map>
+uint64_t mapSum(const Map &map)
+{
+    uint64_t sum = 0;
+    for (const auto &entry : map)
+        sum += entry.second;
+    return sum;
+}
+uint64_t mapSum(const FlatMap &map)
+{
+    uint64_t sum = 0;
+    map.forEach([&](uint64_t, uint64_t value)
+                { sum += value; });
+    return sum;
+}
+uint64_t mapSum(const RobinHoodMap &map)
+{
+    uint64_t sum = 0;
+    map.forEach([&](uint64_t, uint64_t value)
+                { sum += value; });
+    return sum;
+}
+
+template <typename Map>
+void mapFill(Map &map, const std::vector<uint64_t> &keys)
+{
+    for (uint64_t key : keys)
+        mapInsert(map, key, key / 2);
+}
+void mapFill(FlatMap &map, const std::vector<uint64_t> &keys) { map.assign(keys); }
+
+// Keys are the even numbers below 2n in shuffled order and map to key / 2;
+// misses are the odd ones. Setup is untimed. Returns ns per element, and the
+// checksum is n for insert and erase, 0 for misses and n * (n - 1) / 2 for
+// hits and iteration.
+template <typename Map>
+double measureMapOperation(ContainerOperation operation, const std::vector<uint64_t> &keys, const std::vector<uint64_t> &misses)
+{
+    Map map;
+    if (operation != ContainerOperation::INSERT)
+        mapFill(map, keys);
+
+    uint64_t checksum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    switch (operation)
+    {
+    case ContainerOperation::INSERT:
+        for (uint64_t key : keys)
+            checksum += mapInsert(map, key, key / 2);
+        break;
+    case ContainerOperation::LOOKUP_HIT:
+        for (uint64_t key : keys)
+        {
+            const uint64_t *value = mapFind(map, key);
+            checksum += value != nullptr ? *value : 0;
+        }
+        break;
+    case ContainerOperation::LOOKUP_MISS:
+        for (uint64_t key : misses)
+            checksum += mapFind(map, key) != nullptr;
+        break;
+    case ContainerOperation::ITERATE:
+        checksum = mapSum(map);
+        break;
+    case ContainerOperation::ERASE:
+        for (uint64_t key : keys)
+            checksum += map.erase(key);
+        break;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = checksum;
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / keys.size();
+}
+
+// push_back 0..n-1, sum them, pop_back them all. Sequences have no lookup.
+template <typename Sequence>
+double measureSequenceOperation(ContainerOperation operation, const std::vector<uint64_t> &keys, const std::vector<uint64_t> &)
+{
+    size_t n = keys.size();
+    Sequence sequence;
+    if (operation != ContainerOperation::INSERT)
+        for (size_t i = 0; i < n; ++i)
+            sequence.push_back(i);
+
+    uint64_t checksum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    switch (operation)
+    {
+    case ContainerOperation::INSERT:
+        for (size_t i = 0; i < n; ++i)
+            sequence.push_back(i);
+        checksum = sequence.size();
+        break;
+    case ContainerOperation::ITERATE:
+        for (uint64_t value : sequence)
+            checksum += value;
+        break;
+    case ContainerOperation::ERASE:
+        while (!sequence.empty())
+        {
+            sequence.pop_back();
+            ++checksum;
+        }
+        break;
+    default:
+        break;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = checksum;
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / n;
+}
+
+struct ContainerBenchmark
+{
+    const char *name;
+    double (*measure)(ContainerOperation, const std::vector<uint64_t> &, const std::vector<uint64_t> &);
+    bool associative;
+    size_t maxEditSize;
+};
+
+const ContainerBenchmark CONTAINER_BENCHMARKS[] = {
+    {"std::vector", measureSequenceOperation<std::vector<uint64_t>>, false, SIZE_MAX},
+    {"std::deque", measureSequenceOperation<std::deque<uint64_t>>, false, SIZE_MAX},
+    {"std::list", measureSequenceOperation<std::list<uint64_t>>, false, SIZE_MAX},
+    {"std::map", measureMapOperation<std::map<uint64_t, uint64_t>>, true, SIZE_MAX},
+    {"std::unordered_map", measureMapOperation<std::unordered_map<uint64_t, uint64_t>>, true, SIZE_MAX},
+    {"Sorted Flat Map", measureMapOperation<FlatMap>, true, FLAT_MAP_MAX_EDIT_SIZE},
+    {"Robin Hood Map", measureMapOperation<RobinHoodMap>, true, SIZE_MAX}};
+
+uint64_t expectedContainerChecksum(ContainerOperation operation, uint64_t n)
+{
+    switch (operation)
+    {
+    case ContainerOperation::INSERT:
+    case ContainerOperation::ERASE:
+        return n;
+    case ContainerOperation::LOOKUP_MISS:
+        return 0;
+    default:
+        return n * (n - 1) / 2;
+    }
+}
+
+void ContainerMain(int numTests, double threshold, int maxSize)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, CONTAINER_FILE});
+
+    struct ContainerPoint
+    {
+        const ContainerBenchmark *benchmark;
+        ContainerOperation operation;
+        const char *process;
+        std::vector<CachedPoint> cache;
+    };
+    std::vector<ContainerPoint> points;
+    for (const ContainerBenchmark &benchmark : CONTAINER_BENCHMARKS)
+    {
+        for (int op = 0; op < static_cast<int>(std::size(CONTAINER_OPERATION_NAMES)); ++op)
+        {
+            ContainerOperation operation = static_cast<ContainerOperation>(op);
+            bool lookup = operation == ContainerOperation::LOOKUP_HIT || operation == ContainerOperation::LOOKUP_MISS;
+            if (lookup && !benchmark.associative)
+                continue;
+            const char *process = internProcessName(std::string("Container: ") + benchmark.name + ", " + CONTAINER_OPERATION_NAMES[op]);
+            points.push_back({&benchmark, operation, process, lookupSweep(process, {codeOf(benchmark.measure), codeOf(expectedContainerChecksum)}, "array_size", ARRAY_SIZES, numTests, threshold)});
+        }
+    }
+
+    std::mt19937_64 random(42);
+    for (size_t point = 0; point < ARRAY_SIZES.size() && ARRAY_SIZES[point] <= maxSize; ++point)
+    {
+        int size = ARRAY_SIZES[point];
+        std::vector<uint64_t> keys(size), misses(size);
+        for (int i = 0; i < size; ++i)
+        {
+            keys[i] = 2 * static_cast<uint64_t>(i);
+            misses[i] = keys[i] + 1;
+        }
+        std::shuffle(keys.begin(), keys.end(), random);
+        std::shuffle(misses.begin(), misses.end(), random);
+
+        for (ContainerPoint &container : points)
+        {
+            bool edit = container.operation == ContainerOperation::INSERT || container.operation == ContainerOperation::ERASE;
+            if ((edit && static_cast<size_t>(size) > container.benchmark->maxEditSize) || reuseCachedResult(container.cache[point], CONTAINER_FILE))
+            {
+                continue;
+            }
+
+            uint64_t expected = expectedContainerChecksum(container.operation, size);
+            SampleBuffer containerTimes = sampleArena.acquire();
+            int mismatches = 0;
+            for (int i = 0; i < numTests; ++i)
+            {
+                containerTimes.push(container.benchmark->measure(container.operation, keys, misses));
+                mismatches += kernelChecksum != expected;
+            }
+
+            removeOutliers(containerTimes, threshold);
+
+            if (!containerTimes.empty())
+            {
+                double containerAverage = calculateAverage(containerTimes);
+                double containerStdDev = calculateStandardDeviation(containerTimes, containerAverage);
+                saveResultsToJSON(CONTAINER_FILE, containerTimes, containerAverage, containerStdDev, container.process, numTests, language, size, 0, threshold, kernelChecksum, mismatches, container.cache[point].key);
+            }
+            else
+            {
+                discardSamples(containerTimes);
+                logMessage(std::string("All ") + container.process + " times were outliers for array size " + std::to_string(size) + ".");
+            }
+        }
+    }
+}
+
+// Container suite: insert, hit and miss lookups, iteration and erase over the
+// standard containers, a sorted flat map and the Robin Hood map, swept over
+// ARRAY_SIZES up to --max-size and written to C++_containers.json.
+int containersMain(int argc, char *argv[])
+{
+    const char *usage = " containers <number_of_tests> <outlier_threshold> [--max-size 10000000] [--force]\n";
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    int numTests = std::stoi(argv[2]);
+    double threshold = std::stod(argv[3]);
+    int maxSize = ARRAY_SIZES.back();
+    if (!parseOptions(argc, argv, 4, {{"--max-size", &maxSize}, {"--force", &forceRun}}))
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    if (numTests <= 0 || maxSize <= 0)
+    {
+        std::cerr << "Number of tests and the maximum size must be positive\n";
+        return 2;
+    }
+    sampleArena.reserve(numTests);
+
+    beginRun();
+    ContainerMain(numTests, threshold, maxSize);
+    resultWriter.drain();
+    return 0;
+}
+
+const char *LIFECYCLE_FILE = "C++_lifecycle.json";
+const size_t MAX_LIFECYCLE_BYTES = size_t(1) << 30;
+const size_t SSO_STRING_LENGTH = 8;
+const size_t HEAP_STRING_LENGTH = 64;
+
+// An object owning objectSize heap bytes, so a copy allocates and copies them
+// and a move only takes the pointer. With NoexceptMove false the move
+// constructor may throw, and vector has to copy on reallocation instead.
+template <bool NoexceptMove>
+struct LifecycleObject
+{
+    std::vector<char> bytes;
+
+    LifecycleObject(size_t size, char fill) : bytes(size, fill) {}
+    LifecycleObject(const LifecycleObject &) = default;
+    LifecycleObject(LifecycleObject &&other) noexcept(NoexceptMove) : bytes(std::move(other.bytes)) {}
+    LifecycleObject &operator=(const LifecycleObject &) = default;
+    LifecycleObject &operator=(LifecycleObject &&other) noexcept(NoexceptMove)
+    {
+        bytes = std::move(other.bytes);
+        return *this;
+    }
+};
+
+typedef LifecycleObject<true> MovableObject;
+
+struct LifecycleOperation
+{
+    virtual ~LifecycleOperation() = default;
+    virtual uint64_t apply(uint64_t value) const = 0;
+};
+
+struct ScaleAndIncrement final : LifecycleOperation
+{
+    uint64_t apply(uint64_t value) const override { return value * 3 + 1; }
+};
+
+// Hides where a pointer came from, so the compiler cannot see the dynamic
+// type behind it and devirtualize or inline the call.
+template <typename T>
+T *opaque(T *pointer)
+{
+    asm volatile("" : "+r"(pointer));
+    return pointer;
+}
+
+uint64_t objectBytes(const std::vector<MovableObject> &objects)
+{
+    uint64_t total = 0;
+    for (const MovableObject &object : objects)
+        total += object.bytes.size();
+    return total;
+}
+
+// Each measure function performs n operations and returns ns per operation.
+// Setup and the checksum walk are untimed.
+double measureObjectCopy(int n, size_t objectSize)
+{
+    std::vector<MovableObject> source(n, MovableObject(objectSize, 1));
+    std::vector<MovableObject> target;
+    target.reserve(n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const MovableObject &object : source)
+        target.push_back(object);
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = objectBytes(target);
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / n;
+}
+
+double measureObjectMove(int n, size_t objectSize)
+{
+    std::vector<MovableObject> source(n, MovableObject(objectSize, 1));
+    std::vector<MovableObject> target;
+    target.reserve(n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (MovableObject &object : source)
+        target.push_back(std::move(object));
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = objectBytes(target);
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / n;
+}
+
+// Strings of SSO_STRING_LENGTH fit in the object itself with every standard
+// library; HEAP_STRING_LENGTH ones need an allocation per copy.
+double measureStringCopy(int n, size_t length)
+{
+    std::vector<std::string> source(n, std::string(length, 'x'));
+    std::vector<std::string> target;
+    target.reserve(n);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const std::string &text : source)
+        target.push_back(text);
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = 0;
+    for (const std::string &text : target)
+        kernelChecksum += text.size();
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / n;
+}
+
+template <typename Operation>
+uint64_t applyToAll(const std::vector<uint64_t> &values, Operation operation)
+{
+    uint64_t sum = 0;
+    for (uint64_t value : values)
+        sum += operation(value);
+    return sum;
+}
+
+double measureTemplateCall(int n, size_t)
+{
+    std::vector<uint64_t> values(n);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sum = applyToAll(values, [](uint64_t value)
+                              { return value * 3 + 1; });
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = sum;
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / n;
+}
+
+double measureStdFunctionCall(int n, size_t)
+{
+    std::vector<uint64_t> values(n);
+    std::iota(values.begin(), values.end(), 0);
+    std::function<uint64_t(uint64_t)> function = [](uint64_t value)
+    { return value * 3 + 1; };
+    const std::function<uint64_t(uint64_t)> &operation = *opaque(&function);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sum = 0;
+    for (uint64_t value : values)
+        sum += operation(value);
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = sum;
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / n;
+}
+
+double measureVirtualCall(int n, size_t)
+{
+    std::vector<uint64_t> values(n);
+    std::iota(values.begin(), values.end(), 0);
+    ScaleAndIncrement concrete;
+    const LifecycleOperation *operation = opaque<const LifecycleOperation>(&concrete);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sum = 0;
+    for (uint64_t value : values)
+        sum += operation->apply(value);
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = sum;
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / n;
+}
+
+// push_back into a vector that starts empty, so it reallocates log2(n) times.
+// Each reallocation moves the elements if the move constructor is noexcept
+// and copies them otherwise.
+template <bool NoexceptMove>
+double measureVectorGrowth(int n, size_t objectSize)
+{
+    LifecycleObject<NoexceptMove> prototype(objectSize, 1);
+    std::vector<LifecycleObject<NoexceptMove>> objects;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < n; ++i)
+        objects.push_back(prototype);
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = 0;
+    for (const auto &object : objects)
+        kernelChecksum += object.bytes.size();
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / n;
+}
+
+struct LifecycleCase
+{
+    std::string name;
+    double (*measure)(int, size_t);
+    size_t parameter;
+    size_t bytesPerElement;
+    uint64_t (*expected)(uint64_t n, size_t parameter);
+};
+
+uint64_t expectedBytes(uint64_t n, size_t size) { return n * size; }
+uint64_t expectedScaledSum(uint64_t n, size_t) { return 3 * (n * (n - 1) / 2) + n; }
+
+void LifecycleMain(int numTests, double threshold, size_t objectSize)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, LIFECYCLE_FILE});
+
+    std::string object = std::to_string(objectSize) + "B";
+    size_t objectFootprint = 2 * (objectSize + sizeof(MovableObject));
+    size_t stringFootprint = 2 * (HEAP_STRING_LENGTH + sizeof(std::string));
+    const LifecycleCase cases[] = {
+        {"Copy " + object + " Object", measureObjectCopy, objectSize, objectFootprint, expectedBytes},
+        {"Move " + object + " Object", measureObjectMove, objectSize, objectFootprint, expectedBytes},
+        {"Copy SSO String", measureStringCopy, SSO_STRING_LENGTH, stringFootprint, expectedBytes},
+        {"Copy Heap String", measureStringCopy, HEAP_STRING_LENGTH, stringFootprint, expectedBytes},
+        {"Template Call", measureTemplateCall, 0, sizeof(uint64_t), expectedScaledSum},
+        {"std::function Call", measureStdFunctionCall, 0, sizeof(uint64_t), expectedScaledSum},
+        {"Virtual Call", measureVirtualCall, 0, sizeof(uint64_t), expectedScaledSum},
+        {"Vector Growth " + object + ", noexcept Move", measureVectorGrowth<true>, objectSize, objectFootprint, expectedBytes},
+        {"Vector Growth " + object + ", Throwing Move", measureVectorGrowth<false>, objectSize, objectFootprint, expectedBytes}};
+
+    for (const LifecycleCase &lifecycle : cases)
+    {
+        const char *process = internProcessName("Lifecycle: " + lifecycle.name);
+        std::vector<CachedPoint> cache = lookupSweep(process, {codeOf(lifecycle.measure), codeOf(lifecycle.expected)}, "array_size", ARRAY_SIZES, numTests, threshold);
+
+        for (size_t point = 0; point < ARRAY_SIZES.size(); ++point)
+        {
+            int size = ARRAY_SIZES[point];
+            if (size * lifecycle.bytesPerElement > MAX_LIFECYCLE_BYTES || reuseCachedResult(cache[point], LIFECYCLE_FILE))
+            {
+                continue;
+            }
+
+            uint64_t expected = lifecycle.expected(size, lifecycle.parameter);
+            SampleBuffer lifecycleTimes = sampleArena.acquire();
+            int mismatches = 0;
+            for (int i = 0; i < numTests; ++i)
+            {
+                lifecycleTimes.push(lifecycle.measure(size, lifecycle.parameter));
+                mismatches += kernelChecksum != expected;
+            }
+
+            removeOutliers(lifecycleTimes, threshold);
+
+            if (!lifecycleTimes.empty())
+            {
+                double lifecycleAverage = calculateAverage(lifecycleTimes);
+                double lifecycleStdDev = calculateStandardDeviation(lifecycleTimes, lifecycleAverage);
+                saveResultsToJSON(LIFECYCLE_FILE, lifecycleTimes, lifecycleAverage, lifecycleStdDev, process, numTests, language, size, 0, threshold, kernelChecksum, mismatches, cache[point].key);
+            }
+            else
+            {
+                discardSamples(lifecycleTimes);
+                logMessage(std::string("All ") + process + " times were outliers for array size " + std::to_string(size) + ".");
+            }
+        }
+    }
+}
+
+// C++ lifecycle suite: copies vs moves of objects owning --object-size bytes,
+// SSO vs heap strings, template vs std::function vs virtual calls and vector
+// growth with and without noexcept moves, over ARRAY_SIZES. Points that would
+// need more than 1 GiB are skipped. Written to C++_lifecycle.json.
+int lifecycleMain(int argc, char *argv[])
+{
+    const char *usage = " lifecycle <number_of_tests> <outlier_threshold> [--object-size 64] [--force]\n";
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    int numTests = std::stoi(argv[2]);
+    double threshold = std::stod(argv[3]);
+    int objectSize = 64;
+    if (!parseOptions(argc, argv, 4, {{"--object-size", &objectSize}, {"--force", &forceRun}}))
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    if (numTests <= 0 || objectSize <= 0)
+    {
+        std::cerr << "Number of tests and the object size must be positive\n";
+        return 2;
+    }
+    sampleArena.reserve(numTests);
+
+    beginRun();
+    LifecycleMain(numTests, threshold, objectSize);
+    resultWriter.drain();
+    return 0;
+}
+
+const char *DISPATCH_FILE = "C++_dispatch.json";
+const int MAX_DISPATCH_TYPES = 8;
+
+// Item kinds of the dispatch benchmark. Kind K maps its value to
+// value * (K + 1) + K; every strategy below reaches the same code.
+template <int K>
+struct DispatchKind
+{
+    uint64_t value;
+    uint64_t apply() const { return value * (K + 1) + K; }
+};
+
+struct DispatchBase
+{
+    virtual ~DispatchBase() = default;
+    virtual uint64_t apply() const = 0;
+};
+
+template <int K>
+struct VirtualKind final : DispatchBase
+{
+    uint64_t value;
+    explicit VirtualKind(uint64_t v) : value(v) {}
+    uint64_t apply() const override { return DispatchKind<K>{value}.apply(); }
+};
+
+template <typename Derived>
+struct CrtpShape
+{
+    uint64_t apply(uint64_t value) const { return static_cast<const Derived *>(this)->compute(value); }
+};
+
+template <int K>
+struct CrtpKind : CrtpShape<CrtpKind<K>>
+{
+    uint64_t compute(uint64_t value) const { return DispatchKind<K>{value}.apply(); }
+};
+
+typedef std::variant<DispatchKind<0>, DispatchKind<1>, DispatchKind<2>, DispatchKind<3>,
+                     DispatchKind<4>, DispatchKind<5>, DispatchKind<6>, DispatchKind<7>>
+    DispatchVariant;
+
+typedef uint64_t (*DispatchFunction)(uint64_t);
+
+template <int K>
+uint64_t applyKind(uint64_t value)
+{
+    return DispatchKind<K>{value}.apply();
+}
+
+const DispatchFunction DISPATCH_TABLE[MAX_DISPATCH_TYPES] = {applyKind<0>, applyKind<1>, applyKind<2>, applyKind<3>,
+                                                            applyKind<4>, applyKind<5>, applyKind<6>, applyKind<7>};
+
+// Calls visit with std::integral_constant<int, type>, turning a run-time
+// type into a compile-time one.
+template <typename Visit>
+auto withKind(int type, Visit visit)
+{
+    switch (type)
+    {
+    case 0:
+        return visit(std::integral_constant<int, 0>());
+    case 1:
+        return visit(std::integral_constant<int, 1>());
+    case 2:
+        return visit(std::integral_constant<int, 2>());
+    case 3:
+        return visit(std::integral_constant<int, 3>());
+    case 4:
+        return visit(std::integral_constant<int, 4>());
+    case 5:
+        return visit(std::integral_constant<int, 5>());
+    case 6:
+        return visit(std::integral_constant<int, 6>());
+    default:
+        return visit(std::integral_constant<int, 7>());
+    }
+}
+
+struct TaggedItem
+{
+    uint32_t type;
+    uint64_t value;
+};
+
+// The same items in every representation the strategies need. Item i has
+// value i. Types start out in one contiguous run each, then shuffle percent
+// of the positions are swapped with random others.
+struct DispatchItems
+{
+    std::vector<std::unique_ptr<DispatchBase>> objects;
+    std::vector<TaggedItem> tagged;
+    std::vector<DispatchVariant> variants;
+    std::vector<uint64_t> batches[MAX_DISPATCH_TYPES];
+    uint64_t expected = 0;
+
+    DispatchItems(int n, int types, int shuffle)
+    {
+        std::vector<uint32_t> kinds(n);
+        for (int i = 0; i < n; ++i)
+            kinds[i] = static_cast<uint32_t>(static_cast<uint64_t>(i) * types / n);
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> position(0, n - 1);
+        for (int swap = 0; swap < static_cast<int>(static_cast<int64_t>(n) * shuffle / 100); ++swap)
+            std::swap(kinds[position(random)], kinds[position(random)]);
+
+        objects.reserve(n);
+        tagged.reserve(n);
+        variants.reserve(n);
+        for (int i = 0; i < n; ++i)
+        {
+            uint64_t value = i;
+            withKind(kinds[i], [&](auto kind)
+                     {
+                objects.push_back(std::make_unique<VirtualKind<kind>>(value));
+                variants.push_back(DispatchKind<kind>{value});
+                expected += DispatchKind<kind>{value}.apply(); });
+            tagged.push_back({kinds[i], value});
+            batches[kinds[i]].push_back(value);
+        }
+    }
+};
+
+uint64_t dispatchVirtual(const DispatchItems &items)
+{
+    uint64_t sum = 0;
+    for (const auto &object : items.objects)
+        sum += object->apply();
+    return sum;
+}
+
+uint64_t dispatchCrtp(const DispatchItems &items)
+{
+    uint64_t sum = 0;
+    for (const TaggedItem &item : items.tagged)
+        sum += withKind(item.type, [&](auto kind)
+                        { return CrtpKind<kind>().apply(item.value); });
+    return sum;
+}
+
+uint64_t dispatchVariant(const DispatchItems &items)
+{
+    uint64_t sum = 0;
+    for (const DispatchVariant &variant : items.variants)
+        sum += std::visit([](const auto &kind)
+                          { return kind.apply(); },
+                          variant);
+    return sum;
+}
+
+uint64_t dispatchFunctionTable(const DispatchItems &items)
+{
+    uint64_t sum = 0;
+    for (const TaggedItem &item : items.tagged)
+        sum += DISPATCH_TABLE[item.type](item.value);
+    return sum;
+}
+
+// One homogeneous loop per type: no per-item dispatch at all.
+uint64_t dispatchBatches(const DispatchItems &items)
+{
+    uint64_t sum = 0;
+    for (int type = 0; type < MAX_DISPATCH_TYPES; ++type)
+    {
+        sum += withKind(type, [&](auto kind)
+                        {
+            uint64_t batchSum = 0;
+            for (uint64_t value : items.batches[type])
+                batchSum += DispatchKind<kind>{value}.apply();
+            return batchSum; });
+    }
+    return sum;
+}
+
+struct DispatchStrategy
+{
+    const char *name;
+    uint64_t (*run)(const DispatchItems &);
+};
+
+const DispatchStrategy DISPATCH_STRATEGIES[] = {
+    {"Virtual", dispatchVirtual},
+    {"CRTP", dispatchCrtp},
+    {"std::variant", dispatchVariant},
+    {"Function Pointer Table", dispatchFunctionTable},
+    {"Type-Sorted Batches", dispatchBatches}};
+
+// Returns ns per item.
+double measureDispatch(const DispatchStrategy &strategy, const DispatchItems &items, int n)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    uint64_t sum = strategy.run(items);
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = sum;
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / n;
+}
+
+void DispatchMain(int numTests, double threshold, const std::vector<int> &typeCounts, const std::vector<int> &shuffles, int maxSize)
+{
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    submitWrite({WriteRequest::RESET, DISPATCH_FILE});
+
+    for (int types : typeCounts)
+    {
+        for (int shuffle : shuffles)
+        {
+            const char *processes[std::size(DISPATCH_STRATEGIES)];
+            std::vector<CachedPoint> cache[std::size(DISPATCH_STRATEGIES)];
+            for (size_t s = 0; s < std::size(DISPATCH_STRATEGIES); ++s)
+            {
+                processes[s] = internProcessName(std::string("Dispatch: ") + DISPATCH_STRATEGIES[s].name + ", " + std::to_string(types) + " Types, " + std::to_string(shuffle) + "% Shuffled");
+                cache[s] = lookupSweep(processes[s], {codeOf(measureDispatch), codeOf(DISPATCH_STRATEGIES[s].run)}, "array_size", ARRAY_SIZES, numTests, threshold);
+            }
+
+            for (size_t point = 0; point < ARRAY_SIZES.size() && ARRAY_SIZES[point] <= maxSize; ++point)
+            {
+                int size = ARRAY_SIZES[point];
+                DispatchItems items(size, types, shuffle);
+                for (size_t s = 0; s < std::size(DISPATCH_STRATEGIES); ++s)
+                {
+                    if (reuseCachedResult(cache[s][point], DISPATCH_FILE))
+                    {
+                        continue;
+                    }
+
+                    SampleBuffer dispatchTimes = sampleArena.acquire();
+                    int mismatches = 0;
+                    for (int i = 0; i < numTests; ++i)
+                    {
+                        dispatchTimes.push(measureDispatch(DISPATCH_STRATEGIES[s], items, size));
+                        mismatches += kernelChecksum != items.expected;
+                    }
+
+                    removeOutliers(dispatchTimes, threshold);
+
+                    if (!dispatchTimes.empty())
+                    {
+                        double dispatchAverage = calculateAverage(dispatchTimes);
+                        double dispatchStdDev = calculateStandardDeviation(dispatchTimes, dispatchAverage);
+                        saveResultsToJSON(DISPATCH_FILE, dispatchTimes, dispatchAverage, dispatchStdDev, processes[s], numTests, language, size, 0, threshold, kernelChecksum, mismatches, cache[s][point].key);
+                    }
+                    else
+                    {
+                        discardSamples(dispatchTimes);
+                        logMessage(std::string("All ") + processes[s] + " times were outliers for array size " + std::to_string(size) + ".");
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Dispatch suite: virtual calls, CRTP behind a tag switch, std::visit, a
+// function-pointer table and type-sorted batches over heterogeneous items,
+// for each type count and shuffle percentage, over ARRAY_SIZES up to
+// --max-size. Written to C++_dispatch.json.
+int dispatchMain(int argc, char *argv[])
+{
+    const char *usage = " dispatch <number_of_tests> <outlier_threshold> [--types 2,4,8] [--shuffle 0,10,100] [--max-size 10000000] [--force]\n";
+    if (argc < 4)
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    int numTests = std::stoi(argv[2]);
+    double threshold = std::stod(argv[3]);
+    std::vector<int> typeCounts = {2, 4, 8};
+    std::vector<int> shuffles = {0, 10, 100};
+    int maxSize = ARRAY_SIZES.back();
+    if (!parseOptions(argc, argv, 4, {{"--types", &typeCounts}, {"--shuffle", &shuffles}, {"--max-size", &maxSize}, {"--force", &forceRun}}))
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    bool validTypes = !typeCounts.empty() && std::all_of(typeCounts.begin(), typeCounts.end(), [](int types)
+                                                         { return types >= 1 && types <= MAX_DISPATCH_TYPES; });
+    bool validShuffles = !shuffles.empty() && std::all_of(shuffles.begin(), shuffles.end(), [](int shuffle)
+                                                          { return shuffle >= 0 && shuffle <= 100; });
+    if (numTests <= 0 || maxSize <= 0 || !validTypes || !validShuffles)
+    {
+        std::cerr << "Number of tests and the maximum size must be positive, types 1 to 8 and shuffles 0 to 100\n";
+        return 2;
+    }
+    sampleArena.reserve(numTests);
+
+    beginRun();
+    DispatchMain(numTests, threshold, typeCounts, shuffles, maxSize);
+    resultWriter.drain();
+    return 0;
+}
+
+const char *IO_FILE = "C++_io.json";
+const int64_t IO_BYTES_PER_RUN = int64_t(64) << 20;
+const size_t MIN_IO_OPERATIONS = 64;
+const size_t IO_ALIGNMENT = 4096;
+const int MAX_IO_QUEUE_DEPTH = 1024;
+
+// error is the errno that kept a method from running at all, 0 otherwise.
+struct IoRun
+{
+    double seconds;
+    uint64_t operations;
+    bool valid;
+    int error;
+};
+
+// One point of the I/O sweep. Every 8-byte word of the data file holds its
+// own index, so the first word of a block at offset o is o / 8 and the sum of
+// the first words read must equal expected. Writes go to a separate scratch
+// file of the same size and report o / 8 when the whole block was written.
+struct IoWorkload
+{
+    std::string path;
+    std::string scratchPath;
+    int blockSize;
+    int depth;
+    std::vector<int64_t> offsets;
+    uint64_t expected;
+    int64_t fileSize;
+};
+
+typedef std::unique_ptr<char, decltype(&std::free)> IoBuffer;
+
+IoBuffer ioBuffer(size_t bytes)
+{
+    IoBuffer buffer(static_cast<char *>(std::aligned_alloc(IO_ALIGNMENT, bytes)), &std::free);
+    std::memset(buffer.get(), 0x5a, bytes);
+    return buffer;
+}
+
+int64_t firstWord(const char *block)
+{
+    int64_t word;
+    std::memcpy(&word, block, sizeof(word));
+    return word;
+}
+
+// Times one call of operation per offset; it returns the block's first word,
+// or -1 if the transfer came up short.
+template <typename Operation>
+IoRun runBlockingIo(const IoWorkload &workload, std::vector<double> &latencies, Operation operation)
+{
+    uint64_t sum = 0;
+    bool valid = true;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < workload.offsets.size(); ++i)
+    {
+        int64_t issued = i % LATENCY_SAMPLE_STRIDE == 0 ? steadyNanos() : 0;
+        int64_t word = operation(workload.offsets[i]);
+        valid = valid && word >= 0;
+        sum += word;
+        if (issued != 0 && latencies.size() < MAX_LATENCY_SAMPLES)
+            latencies.push_back(static_cast<double>(steadyNanos() - issued));
+    }
+    double seconds = elapsedNanos(start) / 1e9;
+    return {seconds, workload.offsets.size(), valid && sum == workload.expected, 0};
+}
+
+IoRun readBlocking(const IoWorkload &workload, std::vector<double> &latencies)
+{
+    int fd = open(workload.path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return {0.0, 0, false, errno};
+    IoBuffer buffer = ioBuffer(workload.blockSize);
+    IoRun run = runBlockingIo(workload, latencies, [&](int64_t offset)
+                              { return pread(fd, buffer.get(), workload.blockSize, offset) == workload.blockSize ? firstWord(buffer.get()) : -1; });
+    close(fd);
+    return run;
+}
+
+IoRun writeFile(const IoWorkload &workload, std::vector<double> &latencies, int flags)
+{
+    int fd = open(workload.scratchPath.c_str(), O_WRONLY | flags);
+    if (fd < 0)
+        return {0.0, 0, false, errno};
+    IoBuffer buffer = ioBuffer(workload.blockSize);
+    IoRun run = runBlockingIo(workload, latencies, [&](int64_t offset)
+                              { return pwrite(fd, buffer.get(), workload.blockSize, offset) == workload.blockSize ? offset / 8 : -1; });
+    close(fd);
+    return run;
+}
+
+// Returns once the block is in the page cache.
+IoRun writeBlocking(const IoWorkload &workload, std::vector<double> &latencies)
+{
+    return writeFile(workload, latencies, 0);
+}
+
+// Returns once the block is on the device, like a write followed by fdatasync.
+IoRun writeSynchronous(const IoWorkload &workload, std::vector<double> &latencies)
+{
+    return writeFile(workload, latencies, O_DSYNC);
+}
+
+// Bypasses the page cache. Filesystems without O_DIRECT (tmpfs) refuse the
+// open or the first read with EINVAL.
+IoRun readDirect(const IoWorkload &workload, std::vector<double> &latencies)
+{
+    int fd = open(workload.path.c_str(), O_RDONLY | O_DIRECT);
+    if (fd < 0)
+        return {0.0, 0, false, errno};
+    IoBuffer buffer = ioBuffer(workload.blockSize);
+    if (pread(fd, buffer.get(), workload.blockSize, 0) < 0)
+    {
+        int error = errno;
+        close(fd);
+        return {0.0, 0, false, error};
+    }
+    IoRun run = runBlockingIo(workload, latencies, [&](int64_t offset)
+                              { return pread(fd, buffer.get(), workload.blockSize, offset) == workload.blockSize ? firstWord(buffer.get()) : -1; });
+    close(fd);
+    return run;
+}
+
+// Copies each block out of a read-only mapping of the whole file.
+IoRun readMapped(const IoWorkload &workload, std::vector<double> &latencies)
+{
+    int fd = open(workload.path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return {0.0, 0, false, errno};
+    off_t size = lseek(fd, 0, SEEK_END);
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return {0.0, 0, false, errno};
+    const char *data = static_cast<const char *>(mapping);
+    IoBuffer buffer = ioBuffer(workload.blockSize);
+    IoRun run = runBlockingIo(workload, latencies, [&](int64_t offset)
+                              {
+        std::memcpy(buffer.get(), data + offset, workload.blockSize);
+        return firstWord(buffer.get()); });
+    munmap(mapping, size);
+    return run;
+}
+
+// A writer thread sends one block per offset round-robin over depth pipes or
+// AF_UNIX socketpairs; this thread waits on all of them with epoll and drains
+// whatever is ready. Latency runs from the write call to the block's last
+// byte arriving.
+IoRun runEpoll(const IoWorkload &workload, std::vector<double> &latencies, bool sockets)
+{
+    int depth = workload.depth;
+    std::vector<int> readEnds, writeEnds;
+    int epollFd = epoll_create1(0);
+    int error = epollFd < 0 ? errno : 0;
+    for (int channel = 0; channel < depth && error == 0; ++channel)
+    {
+        int fds[2];
+        if ((sockets ? socketpair(AF_UNIX, SOCK_STREAM, 0, fds) : pipe(fds)) != 0)
+        {
+            error = errno;
+            break;
+        }
+        readEnds.push_back(fds[0]);
+        writeEnds.push_back(fds[1]);
+        fcntl(fds[0], F_SETFL, O_NONBLOCK);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = channel;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fds[0], &event);
+    }
+    auto closeAll = [&]
+    {
+        for (int fd : readEnds)
+            close(fd);
+        for (int fd : writeEnds)
+            close(fd);
+        if (epollFd >= 0)
+            close(epollFd);
+    };
+    if (error != 0)
+    {
+        closeAll();
+        return {0.0, 0, false, error};
+    }
+
+    size_t blocks = workload.offsets.size();
+    size_t blockSize = workload.blockSize;
+    std::unique_ptr<std::atomic<int64_t>[]> sentAt(new std::atomic<int64_t>[blocks]());
+    std::vector<uint64_t> receivedOn(depth, 0);
+    std::vector<epoll_event> events(depth);
+    IoBuffer buffer = ioBuffer(blockSize);
+    uint64_t received = 0;
+    uint64_t total = blocks * blockSize;
+    bool valid = true;
+    std::atomic<bool> writerFailed{false};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::thread writer([&]
+                       {
+        IoBuffer payload = ioBuffer(blockSize);
+        for (size_t block = 0; block < blocks; ++block)
+        {
+            if (block % LATENCY_SAMPLE_STRIDE == 0)
+                sentAt[block].store(steadyNanos(), std::memory_order_relaxed);
+            size_t sent = 0;
+            while (sent < blockSize)
+            {
+                ssize_t written = write(writeEnds[block % depth], payload.get() + sent, blockSize - sent);
+                if (written <= 0)
+                {
+                    writerFailed.store(true);
+                    return;
+                }
+                sent += written;
+            }
+        } });
+    while (received < total && !writerFailed.load())
+    {
+        int ready = epoll_wait(epollFd, events.data(), depth, 100);
+        if (ready < 0 && errno != EINTR)
+            break;
+        for (int e = 0; e < ready; ++e)
+        {
+            int channel = events[e].data.u32;
+            ssize_t count;
+            while ((count = read(readEnds[channel], buffer.get(), blockSize)) > 0)
+            {
+                int64_t now = steadyNanos();
+                for (uint64_t block = receivedOn[channel] / blockSize; block < (receivedOn[channel] + count) / blockSize; ++block)
+                {
+                    size_t index = block * depth + channel;
+                    if (index % LATENCY_SAMPLE_STRIDE == 0 && latencies.size() < MAX_LATENCY_SAMPLES)
+                        latencies.push_back(static_cast<double>(now - sentAt[index].load(std::memory_order_relaxed)));
+                }
+                receivedOn[channel] += count;
+                received += count;
+            }
+        }
+    }
+    writer.join();
+    double seconds = elapsedNanos(start) / 1e9;
+    closeAll();
+
+    for (int channel = 0; channel < depth; ++channel)
+    {
+        valid = valid && receivedOn[channel] == (blocks / depth + (static_cast<size_t>(channel) < blocks % depth)) * blockSize;
+    }
+    return {seconds, blocks, valid && received == total, 0};
+}
+
+IoRun epollPipes(const IoWorkload &workload, std::vector<double> &latencies)
+{
+    return runEpoll(workload, latencies, false);
+}
+
+IoRun epollSockets(const IoWorkload &workload, std::vector<double> &latencies)
+{
+    return runEpoll(workload, latencies, true);
+}
+
+#if HAVE_IO_URING
+// Minimal io_uring over the raw system calls, so the suite does not need
+// liburing: the submission and completion rings plus the SQE array, each
+// mapped from the ring descriptor.
+class IoUring
+{
+public:
+    explicit IoUring(unsigned entries)
+    {
+        io_uring_params params{};
+        fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0)
+        {
+            error = errno;
+            return;
+        }
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        void *sqeMapping = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqeMapping == MAP_FAILED)
+        {
+            error = errno;
+            return;
+        }
+        char *sq = static_cast<char *>(sqRing);
+        char *cq = static_cast<char *>(cqRing);
+        sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+        sqes = static_cast<io_uring_sqe *>(sqeMapping);
+    }
+
+    ~IoUring()
+    {
+        if (sqes != nullptr)
+            munmap(sqes, sqesSize);
+        if (cqRing != nullptr && cqRing != MAP_FAILED)
+            munmap(cqRing, cqRingSize);
+        if (sqRing != nullptr && sqRing != MAP_FAILED)
+            munmap(sqRing, sqRingSize);
+        if (fd >= 0)
+            close(fd);
+    }
+
+    IoUring(const IoUring &) = delete;
+    IoUring &operator=(const IoUring &) = delete;
+
+    // errno of a failed setup, 0 once the ring is usable.
+    int status() const { return fd < 0 || sqes == nullptr ? (error != 0 ? error : EINVAL) : 0; }
+
+    void queueRead(int file, iovec *vector, int64_t offset, uint64_t tag)
+    {
+        unsigned tail = *sqTail;
+        unsigned index = tail & sqMask;
+        io_uring_sqe &sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READV;
+        sqe.fd = file;
+        sqe.addr = reinterpret_cast<uint64_t>(vector);
+        sqe.len = 1;
+        sqe.off = offset;
+        sqe.user_data = tag;
+        sqArray[index] = index;
+        __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+    }
+
+    // Submits count queued requests without waiting for them.
+    bool submit(unsigned count)
+    {
+        return syscall(__NR_io_uring_enter, fd, count, 0, 0, nullptr, 0) >= 0;
+    }
+
+    // Blocks until at least count completions are waiting to be reaped.
+    bool wait(unsigned count)
+    {
+        return syscall(__NR_io_uring_enter, fd, 0, count, IORING_ENTER_GETEVENTS, nullptr, 0) >= 0;
+    }
+
+    template <typename Complete>
+    void reap(Complete complete)
+    {
+        unsigned head = *cqHead;
+        while (head != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+        {
+            const io_uring_cqe &cqe = cqes[head & cqMask];
+            complete(cqe.user_data, cqe.res);
+            ++head;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    int fd = -1;
+    int error = 0;
+    void *sqRing = nullptr;
+    void *cqRing = nullptr;
+    size_t sqRingSize = 0, cqRingSize = 0, sqesSize = 0;
+    unsigned *sqTail = nullptr, *sqArray = nullptr;
+    unsigned *cqHead = nullptr, *cqTail = nullptr;
+    unsigned sqMask = 0, cqMask = 0;
+    io_uring_sqe *sqes = nullptr;
+    io_uring_cqe *cqes = nullptr;
+};
+
+// Reads depth blocks per batch: the whole batch is queued and submitted with
+// one system call, then completions are reaped as they arrive. Latency runs
+// from the submission to the reap of each completion, so it is per request,
+// not per batch.
+IoRun readIoUring(const IoWorkload &workload, std::vector<double> &latencies)
+{
+    IoUring ring(workload.depth);
+    if (ring.status() != 0)
+        return {0.0, 0, false, ring.status()};
+    int fd = open(workload.path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return {0.0, 0, false, errno};
+
+    std::vector<IoBuffer> buffers;
+    std::vector<iovec> vectors(workload.depth);
+    for (int slot = 0; slot < workload.depth; ++slot)
+    {
+        buffers.push_back(ioBuffer(workload.blockSize));
+        vectors[slot] = {buffers[slot].get(), static_cast<size_t>(workload.blockSize)};
+    }
+
+    uint64_t sum = 0;
+    bool valid = true;
+    size_t operations = workload.offsets.size();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t first = 0; first < operations && valid; first += workload.depth)
+    {
+        unsigned batch = static_cast<unsigned>(std::min<size_t>(workload.depth, operations - first));
+        for (unsigned slot = 0; slot < batch; ++slot)
+        {
+            ring.queueRead(fd, &vectors[slot], workload.offsets[first + slot], slot);
+        }
+        int64_t issued = steadyNanos();
+        valid = ring.submit(batch);
+        for (unsigned reaped = 0; valid && reaped < batch;)
+        {
+            valid = ring.wait(1);
+            int64_t now = steadyNanos();
+            ring.reap([&](uint64_t slot, int result)
+                      {
+                ++reaped;
+                valid = valid && result == workload.blockSize;
+                sum += firstWord(buffers[slot].get());
+                if ((first + slot) % LATENCY_SAMPLE_STRIDE == 0 && latencies.size() < MAX_LATENCY_SAMPLES)
+                    latencies.push_back(static_cast<double>(now - issued)); });
+        }
+    }
+    double seconds = elapsedNanos(start) / 1e9;
+    close(fd);
+    return {seconds, operations, valid && sum == workload.expected, 0};
+}
+#endif
+
+struct IoMethod
+{
+    const char *name;
+    bool queued;
+    IoRun (*run)(const IoWorkload &, std::vector<double> &);
+};
+
+// Methods with queued set are swept over queue depths: the number of
+// channels for epoll and the batch size for io_uring. The rest run one
+// request at a time.
+const IoMethod IO_METHODS[] = {
+    {"Blocking read", false, readBlocking},
+    {"Blocking write", false, writeBlocking},
+    {"O_DSYNC write", false, writeSynchronous},
+    {"O_DIRECT pread", false, readDirect},
+    {"mmap", false, readMapped},
+    {"epoll (pipes)", true, epollPipes},
+    {"epoll (socketpairs)", true, epollSockets},
+#if HAVE_IO_URING
+    {"io_uring", true, readIoUring},
+#endif
+};
+
+// Returns false if the method cannot run here, so the caller can skip its
+// other points.
+bool measureIo(const IoMethod &method, const IoWorkload &workload, int runs)
+{
+    std::vector<double> nanosPerOperation, latencies;
+    double iops = 0.0;
+    bool valid = true;
+    for (int run = 0; run < runs; ++run)
+    {
+        IoRun result = method.run(workload, latencies);
+        if (result.error != 0)
+        {
+            logMessage(std::string("I/O: ") + method.name + " is not available: " + std::strerror(result.error) + ".");
+            return false;
+        }
+        iops += result.operations / result.seconds / runs;
+        nanosPerOperation.push_back(result.seconds * 1e9 / std::max<uint64_t>(result.operations, 1));
+        valid = valid && result.valid;
+    }
+    if (!valid)
+        std::cerr << method.name << ": short or corrupt transfers with " << workload.blockSize << " B blocks at depth " << workload.depth << std::endl;
+
+    double megabytesPerSecond = iops * workload.blockSize / 1e6;
+    double p99 = percentile(latencies, 0.99);
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(2) << method.name << ", " << workload.blockSize << " B, depth " << workload.depth
+         << ": " << iops / 1e3 << " kIOPS, " << megabytesPerSecond << " MB/s, p99 latency " << p99 << " ns";
+    recordRunResult(IO_FILE, std::string("I/O: ") + method.name,
+                    {{"method", method.name}, {"block_size", workload.blockSize}, {"queue_depth", workload.depth}, {"file_size", workload.fileSize},
+                     {"directory", std::filesystem::path(workload.path).parent_path().string()}},
+                    nanosPerOperation,
+                    {{"iops", iops}, {"megabytes_per_second", megabytesPerSecond}, {"p50_latency_ns", percentile(latencies, 0.50)}, {"p99_latency_ns", p99}, {"p999_latency_ns", percentile(latencies, 0.999)}}, valid, line.str());
+    return true;
+}
+
+// tmpfs has no O_DIRECT and never writes to a device, so the uncached
+// methods would measure memory copies or not run at all.
+void warnIfTmpfs(const std::string &directory)
+{
+    struct statfs info;
+    if (statfs(directory.c_str(), &info) == 0 && info.f_type == TMPFS_MAGIC)
+        logMessage(directory + " is on tmpfs; pass --directory on a disk-backed filesystem to measure the device.");
+}
+
+// Creates an empty file from a mkstemp template in directory; returns its
+// path and open descriptor, or an empty path on failure.
+std::pair<std::string, int> createIoFile(const std::string &directory)
+{
+    std::string path = directory + "/measure_io_XXXXXX";
+    int fd = mkstemp(path.data());
+    return {fd < 0 ? "" : path, fd};
+}
+
+// I/O suite: random block reads and writes against files in a temporary
+// directory and block transfers over pipes and socketpairs, with IOPS, MB/s
+// and latency percentiles per block size and queue depth, written to
+// C++_io.json. Reads other than O_DIRECT are served from the page cache, and
+// only O_DSYNC writes wait for the device.
+int ioMain(int argc, char *argv[])
+{
+    const char *usage = " io [--block-sizes 4096,65536,1048576] [--queue-depths 1,8,32] [--file-size 256] [--directory DIR] [--runs 3]\n";
+    std::vector<int> blockSizes = {4096, 65536, 1048576};
+    std::vector<int> depths = {1, 8, 32};
+    int64_t fileSizeMiB = 256;
+    std::string directory = std::filesystem::temp_directory_path().string();
+    int runs = 3;
+    if (!parseOptions(argc, argv, 2, {{"--block-sizes", &blockSizes}, {"--queue-depths", &depths}, {"--file-size", &fileSizeMiB}, {"--directory", &directory}, {"--runs", &runs}}))
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    int64_t fileSize = fileSizeMiB << 20;
+    bool validBlocks = !blockSizes.empty() && std::all_of(blockSizes.begin(), blockSizes.end(), [&](int size)
+                                                          { return size > 0 && size % IO_ALIGNMENT == 0 && size <= fileSize; });
+    bool validDepths = !depths.empty() && std::all_of(depths.begin(), depths.end(), [](int depth)
+                                                      { return depth > 0 && depth <= MAX_IO_QUEUE_DEPTH; });
+    if (runs <= 0 || !validBlocks || !validDepths)
+    {
+        std::cerr << "Runs must be positive, block sizes multiples of 4096 no larger than the file and queue depths 1 to 1024\n";
+        return 2;
+    }
+    warnIfTmpfs(directory);
+
+    auto [path, fd] = createIoFile(directory);
+    auto [scratchPath, scratchFd] = createIoFile(directory);
+    bool created = fd >= 0 && scratchFd >= 0 && ftruncate(scratchFd, fileSize) == 0;
+    std::vector<int64_t> chunk((1 << 20) / sizeof(int64_t));
+    for (int64_t offset = 0; created && offset < fileSize; offset += chunk.size() * sizeof(int64_t))
+    {
+        std::iota(chunk.begin(), chunk.end(), offset / 8);
+        size_t bytes = std::min<int64_t>(chunk.size() * sizeof(int64_t), fileSize - offset);
+        created = write(fd, chunk.data(), bytes) == static_cast<ssize_t>(bytes);
+    }
+    created = created && fsync(fd) == 0 && fsync(scratchFd) == 0;
+    if (fd >= 0)
+        close(fd);
+    if (scratchFd >= 0)
+        close(scratchFd);
+    if (!created)
+    {
+        std::cerr << "Could not create the test files in " << directory << ": " << std::strerror(errno) << "\n";
+        if (!path.empty())
+            unlink(path.c_str());
+        if (!scratchPath.empty())
+            unlink(scratchPath.c_str());
+        return 1;
+    }
+
+    beginRun();
+    submitWrite({WriteRequest::RESET, IO_FILE});
+    std::vector<bool> available(std::size(IO_METHODS), true);
+    for (int blockSize : blockSizes)
+    {
+        IoWorkload workload{path, scratchPath, blockSize, 1, {}, 0, fileSize};
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int64_t> block(0, fileSize / blockSize - 1);
+        size_t operations = std::max<size_t>(MIN_IO_OPERATIONS, IO_BYTES_PER_RUN / blockSize);
+        for (size_t i = 0; i < operations; ++i)
+        {
+            workload.offsets.push_back(block(random) * blockSize);
+            workload.expected += workload.offsets.back() / 8;
+        }
+
+        for (size_t m = 0; m < std::size(IO_METHODS); ++m)
+        {
+            const IoMethod &method = IO_METHODS[m];
+            for (int depth : method.queued ? depths : std::vector<int>{1})
+            {
+                if (!available[m])
+                    break;
+                workload.depth = depth;
+                available[m] = measureIo(method, workload, runs);
+            }
+        }
+    }
+    resultWriter.drain();
+    unlink(path.c_str());
+    unlink(scratchPath.c_str());
+    return 0;
+}
+
+const char *TRANSFER_FILE = "C++_zero_copy.json";
+const size_t TRANSFER_CHUNK = 1 << 20;
+const size_t MIN_TRANSFER_BYTES = size_t(64) << 20;
+
+enum class TransferEndpoint
+{
+    File,
+    Pipe,
+    Socket
+};
+
+const char *endpointName(TransferEndpoint endpoint)
+{
+    switch (endpoint)
+    {
+    case TransferEndpoint::File:
+        return "File";
+    case TransferEndpoint::Pipe:
+        return "Pipe";
+    default:
+        return "Socket";
+    }
+}
+
+// Per-destination state prepared before timing starts, so every method pays
+// only for its own system calls.
+struct TransferContext
+{
+    std::vector<char> buffer = std::vector<char>(TRANSFER_CHUNK);
+    int relay[2] = {-1, -1};
+    bool destinationIsPipe = false;
+};
+
+bool writeAll(int fd, const char *data, size_t bytes)
+{
+    while (bytes > 0)
+    {
+        ssize_t written = write(fd, data, bytes);
+        if (written <= 0)
+            return false;
+        data += written;
+        bytes -= written;
+    }
+    return true;
+}
+
+bool copyReadWrite(TransferContext &context, int source, int destination, size_t bytes)
+{
+    while (bytes > 0)
+    {
+        ssize_t count = read(source, context.buffer.data(), std::min(bytes, TRANSFER_CHUNK));
+        if (count <= 0 || !writeAll(destination, context.buffer.data(), count))
+            return false;
+        bytes -= count;
+    }
+    return true;
+}
+
+bool copySendfile(TransferContext &, int source, int destination, size_t bytes)
+{
+    while (bytes > 0)
+    {
+        ssize_t sent = sendfile(destination, source, nullptr, bytes);
+        if (sent <= 0)
+            return false;
+        bytes -= sent;
+    }
+    return true;
+}
+
+bool copyFileRange(TransferContext &, int source, int destination, size_t bytes)
+{
+    while (bytes > 0)
+    {
+        ssize_t copied = copy_file_range(source, nullptr, destination, nullptr, bytes, 0);
+        if (copied <= 0)
+            return false;
+        bytes -= copied;
+    }
+    return true;
+}
+
+// splice needs a pipe on one side, so unless the destination is one the data
+// goes through the context's relay pipe.
+bool copySplice(TransferContext &context, int source, int destination, size_t bytes)
+{
+    while (bytes > 0)
+    {
+        int target = context.destinationIsPipe ? destination : context.relay[1];
+        ssize_t moved = splice(source, nullptr, target, nullptr, std::min(bytes, TRANSFER_CHUNK), SPLICE_F_MOVE);
+        if (moved <= 0)
+            return false;
+        bytes -= moved;
+        for (ssize_t left = context.destinationIsPipe ? 0 : moved; left > 0;)
+        {
+            ssize_t drained = splice(context.relay[0], nullptr, destination, nullptr, left, SPLICE_F_MOVE);
+            if (drained <= 0)
+                return false;
+            left -= drained;
+        }
+    }
+    return true;
+}
+
+bool copyMmapWrite(TransferContext &, int source, int destination, size_t bytes)
+{
+    void *mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, source, 0);
+    if (mapping == MAP_FAILED)
+        return false;
+    bool written = writeAll(destination, static_cast<const char *>(mapping), bytes);
+    munmap(mapping, bytes);
+    return written;
+}
+
+// Hands the mapped pages to the pipe by reference instead of copying them.
+bool copyVmsplice(TransferContext &, int source, int destination, size_t bytes)
+{
+    void *mapping = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, source, 0);
+    if (mapping == MAP_FAILED)
+        return false;
+    iovec vector{mapping, bytes};
+    bool spliced = true;
+    while (spliced && vector.iov_len > 0)
+    {
+        ssize_t moved = vmsplice(destination, &vector, 1, 0);
+        spliced = moved > 0;
+        vector.iov_base = static_cast<char *>(vector.iov_base) + std::max<ssize_t>(moved, 0);
+        vector.iov_len -= std::max<ssize_t>(moved, 0);
+    }
+    munmap(mapping, bytes);
+    return spliced;
+}
+
+struct TransferMethod
+{
+    const char *name;
+    std::vector<TransferEndpoint> destinations;
+    bool (*copy)(TransferContext &, int, int, size_t);
+};
+
+const TransferMethod TRANSFER_METHODS[] = {
+    {"read + write", {TransferEndpoint::File, TransferEndpoint::Pipe, TransferEndpoint::Socket}, copyReadWrite},
+    {"sendfile", {TransferEndpoint::File, TransferEndpoint::Pipe, TransferEndpoint::Socket}, copySendfile},
+    {"splice", {TransferEndpoint::File, TransferEndpoint::Pipe, TransferEndpoint::Socket}, copySplice},
+    {"copy_file_range", {TransferEndpoint::File}, copyFileRange},
+    {"mmap + write", {TransferEndpoint::File, TransferEndpoint::Pipe, TransferEndpoint::Socket}, copyMmapWrite},
+    {"vmsplice", {TransferEndpoint::Pipe}, copyVmsplice}};
+
+struct CpuTime
+{
+    double userSeconds;
+    double systemSeconds;
+};
+
+double rusageSeconds(const timeval &time)
+{
+    return time.tv_sec + time.tv_usec / 1e6;
+}
+
+CpuTime threadCpuTime()
+{
+    rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return {rusageSeconds(usage.ru_utime), rusageSeconds(usage.ru_stime)};
+}
+
+CpuTime operator-(const CpuTime &after, const CpuTime &before)
+{
+    return {after.userSeconds - before.userSeconds, after.systemSeconds - before.systemSeconds};
+}
+
+struct TransferRun
+{
+    double seconds;
+    CpuTime sender;
+    CpuTime receiver;
+    bool valid;
+    int error;
+};
+
+// Moves the first payload bytes of the source file to the destination
+// repeats times. Pipe and socket destinations are drained by a second thread
+// and the run ends once it has received everything. CPU time is taken per
+// thread, so the receiving side's copy out of the pipe or socket is counted
+// separately from the sender's.
+TransferRun runTransfer(const TransferMethod &method, TransferEndpoint destination, const std::string &sourcePath, const std::string &targetPath, size_t payload, int repeats)
+{
+    TransferContext context;
+    int source = open(sourcePath.c_str(), O_RDONLY);
+    int ends[2] = {-1, -1};
+    int error = 0;
+    if (source < 0)
+        error = errno;
+    else if (destination == TransferEndpoint::File)
+        ends[1] = open(targetPath.c_str(), O_WRONLY | O_TRUNC);
+    else if ((destination == TransferEndpoint::Pipe ? pipe(ends) : socketpair(AF_UNIX, SOCK_STREAM, 0, ends)) != 0)
+        error = errno;
+    if (error == 0 && ends[1] < 0)
+        error = errno;
+    if (error == 0 && destination != TransferEndpoint::Pipe && pipe(context.relay) != 0)
+        error = errno;
+    auto closeAll = [&]
+    {
+        for (int fd : {source, ends[0], ends[1], context.relay[0], context.relay[1]})
+        {
+            if (fd >= 0)
+                close(fd);
+        }
+    };
+    if (error != 0)
+    {
+        closeAll();
+        return {0.0, {}, {}, false, error};
+    }
+    context.destinationIsPipe = destination == TransferEndpoint::Pipe;
+    for (int fd : {ends[1], context.relay[1]})
+    {
+        fcntl(fd, F_SETPIPE_SZ, static_cast<int>(TRANSFER_CHUNK));
+    }
+
+    uint64_t total = static_cast<uint64_t>(payload) * repeats;
+    std::atomic<uint64_t> received{0};
+    CpuTime receiver{};
+    std::thread drain;
+    if (destination != TransferEndpoint::File)
+    {
+        drain = std::thread([&]
+                            {
+            CpuTime before = threadCpuTime();
+            std::vector<char> sink(TRANSFER_CHUNK);
+            ssize_t count;
+            while (received.load(std::memory_order_relaxed) < total && (count = read(ends[0], sink.data(), sink.size())) > 0)
+            {
+                received.fetch_add(count, std::memory_order_relaxed);
+            }
+            receiver = threadCpuTime() - before; });
+    }
+
+    CpuTime before = threadCpuTime();
+    auto start = std::chrono::high_resolution_clock::now();
+    bool copied = true;
+    for (int repeat = 0; repeat < repeats && copied; ++repeat)
+    {
+        copied = lseek(source, 0, SEEK_SET) == 0 && (destination != TransferEndpoint::File || lseek(ends[1], 0, SEEK_SET) == 0);
+        copied = copied && method.copy(context, source, ends[1], payload);
+    }
+    error = copied ? 0 : errno;
+    CpuTime sender = threadCpuTime() - before;
+    // Closing the write end lets the drain thread see EOF if the copy failed.
+    if (!copied)
+    {
+        close(ends[1]);
+        ends[1] = -1;
+    }
+    if (drain.joinable())
+        drain.join();
+    double seconds = elapsedNanos(start) / 1e9;
+
+    bool valid = copied;
+    if (destination == TransferEndpoint::File && copied)
+    {
+        // Every word of the source holds its index: spot-check the copy.
+        int check = open(targetPath.c_str(), O_RDONLY);
+        for (size_t offset : {size_t(0), payload / 2 / 8 * 8, payload - 8})
+        {
+            int64_t word = -1;
+            valid = valid && pread(check, &word, sizeof(word), offset) == sizeof(word) && word == static_cast<int64_t>(offset / 8);
+        }
+        valid = valid && lseek(check, 0, SEEK_END) == static_cast<off_t>(payload);
+        close(check);
+    }
+    else
+    {
+        valid = valid && received.load() == total;
+    }
+    closeAll();
+
+    if (!copied && received.load() == 0 && (error == EINVAL || error == ENOSYS || error == EXDEV || error == EOPNOTSUPP))
+        return {0.0, {}, {}, false, error};
+    return {seconds, sender, receiver, valid, 0};
+}
+
+// Returns false if the method cannot reach this destination here.
+bool measureTransfer(const TransferMethod &method, TransferEndpoint destination, const std::string &sourcePath, const std::string &targetPath, size_t payload, int runs)
+{
+    int repeats = static_cast<int>(std::max<size_t>(1, MIN_TRANSFER_BYTES / payload));
+    double bytes = static_cast<double>(payload) * repeats;
+    std::vector<double> nanosPerTransfer;
+    CpuTime sender{}, receiver{};
+    double seconds = 0.0;
+    bool valid = true;
+    std::string process = std::string("Zero Copy: ") + method.name + ", File to " + endpointName(destination);
+    for (int run = 0; run < runs; ++run)
+    {
+        TransferRun result = runTransfer(method, destination, sourcePath, targetPath, payload, repeats);
+        if (result.error != 0)
+        {
+            logMessage(process + " is not available: " + std::strerror(result.error) + ".");
+            return false;
+        }
+        nanosPerTransfer.push_back(result.seconds * 1e9 / repeats);
+        seconds += result.seconds;
+        sender.userSeconds += result.sender.userSeconds;
+        sender.systemSeconds += result.sender.systemSeconds;
+        receiver.userSeconds += result.receiver.userSeconds;
+        receiver.systemSeconds += result.receiver.systemSeconds;
+        valid = valid && result.valid;
+    }
+    if (!valid)
+        std::cerr << process << ": short or corrupt transfer of " << payload << " B" << std::endl;
+
+    double totalBytes = bytes * runs;
+    double megabytesPerSecond = totalBytes / seconds / 1e6;
+    double userNanosPerByte = (sender.userSeconds + receiver.userSeconds) * 1e9 / totalBytes;
+    double systemNanosPerByte = (sender.systemSeconds + receiver.systemSeconds) * 1e9 / totalBytes;
+    double senderNanosPerByte = (sender.userSeconds + sender.systemSeconds) * 1e9 / totalBytes;
+    double receiverNanosPerByte = (receiver.userSeconds + receiver.systemSeconds) * 1e9 / totalBytes;
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(3) << process << ", " << payload << " B: " << megabytesPerSecond << " MB/s, "
+         << senderNanosPerByte + receiverNanosPerByte << " CPU ns/B (sender " << senderNanosPerByte << ", receiver " << receiverNanosPerByte << ")";
+    recordRunResult(TRANSFER_FILE, process,
+                    {{"method", method.name}, {"source", "File"}, {"destination", endpointName(destination)}, {"payload_size", payload}, {"repeats", repeats},
+                     {"directory", std::filesystem::path(sourcePath).parent_path().string()}},
+                    nanosPerTransfer,
+                    {{"megabytes_per_second", megabytesPerSecond}, {"user_ns_per_byte", userNanosPerByte}, {"system_ns_per_byte", systemNanosPerByte},
+                     {"sender_cpu_ns_per_byte", senderNanosPerByte}, {"receiver_cpu_ns_per_byte", receiverNanosPerByte}, {"cpu_ns_per_byte", senderNanosPerByte + receiverNanosPerByte}}, valid, line.str());
+    return true;
+}
+
+// Zero-copy suite: moves a file's contents to another file, a pipe and an
+// AF_UNIX socketpair with read + write, sendfile, splice, copy_file_range,
+// mmap + write and vmsplice, over payload sizes, reporting throughput and
+// sender, receiver and total CPU time per byte to C++_zero_copy.json. Small payloads are repeated until
+// at least 64 MiB move per run, so getrusage has time to register.
+int transferMain(int argc, char *argv[])
+{
+    const char *usage = " transfer [--sizes 4096,65536,1048576,16777216,268435456,1073741824] [--directory DIR] [--runs 3]\n";
+    std::vector<int> sizes = {4096, 65536, 1 << 20, 16 << 20, 256 << 20, 1 << 30};
+    std::string directory = std::filesystem::temp_directory_path().string();
+    int runs = 3;
+    if (!parseOptions(argc, argv, 2, {{"--sizes", &sizes}, {"--directory", &directory}, {"--runs", &runs}}))
+    {
+        std::cerr << "Usage: " << argv[0] << usage;
+        return 2;
+    }
+    bool validSizes = !sizes.empty() && std::all_of(sizes.begin(), sizes.end(), [](int size)
+                                                    { return size > 0 && size % 8 == 0; });
+    if (runs <= 0 || !validSizes)
+    {
+        std::cerr << "Runs must be positive and payload sizes positive multiples of 8\n";
+        return 2;
+    }
+
+    size_t fileSize = *std::max_element(sizes.begin(), sizes.end());
+    auto [sourcePath, fd] = createIoFile(directory);
+    auto [targetPath, targetFd] = createIoFile(directory);
+    bool created = fd >= 0 && targetFd >= 0;
+    std::vector<int64_t> chunk(TRANSFER_CHUNK / sizeof(int64_t));
+    for (size_t offset = 0; created && offset < fileSize; offset += TRANSFER_CHUNK)
+    {
+        std::iota(chunk.begin(), chunk.end(), offset / 8);
+        size_t bytes = std::min(TRANSFER_CHUNK, fileSize - offset);
+        created = write(fd, chunk.data(), bytes) == static_cast<ssize_t>(bytes);
+    }
+    created = created && fsync(fd) == 0;
+    if (fd >= 0)
+        close(fd);
+    if (targetFd >= 0)
+        close(targetFd);
+    if (!created)
+    {
+        std::cerr << "Could not create the test files in " << directory << ": " << std::strerror(errno) << "\n";
+        if (!sourcePath.empty())
+            unlink(sourcePath.c_str());
+        if (!targetPath.empty())
+            unlink(targetPath.c_str());
+        return 1;
+    }
+
+    beginRun();
+    submitWrite({WriteRequest::RESET, TRANSFER_FILE});
+    for (const TransferMethod &method : TRANSFER_METHODS)
+    {
+        for (TransferEndpoint destination : method.destinations)
+        {
+            for (int size : sizes)
+            {
+                if (!measureTransfer(method, destination, sourcePath, targetPath, size, runs))
+                    break;
+            }
+        }
+    }
+    resultWriter.drain();
+    unlink(sourcePath.c_str());
+    unlink(targetPath.c_str());
+    return 0;
+}
+
+// Built with -DMEASURE_LIBRARY this file is a shared library instead of a
+// program, so the compiler comparison driver (compilers.cpp) can dlopen the
+// variant built by each toolchain and run them in turn.
+extern "C" const char *benchmarkCompiler()
+{
+    return BENCH_COMPILER;
+}
+
+extern "C" int benchmarkMain(int argc, char *argv[])
+{
+    if (argc >= 2 && std::string(argv[1]) == "compare")
+    {
+        return compareMain(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "contention")
+    {
+        return contentionMain(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "queues")
+    {
+        return queuesMain(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "layout")
+    {
+        return layoutMain(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "patterns")
+    {
+        return patternsMain(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "bandwidth")
+    {
+        return bandwidthMain(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "containers")
+    {
+        return containersMain(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "lifecycle")
+    {
+        return lifecycleMain(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "dispatch")
+    {
+        return dispatchMain(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "io")
+    {
+        return ioMain(argc, argv);
+    }
+    if (argc >= 2 && std::string(argv[1]) == "transfer")
+    {
+        return transferMain(argc, argv);
+    }
+
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <number_of_tests> <outlier_threshold> [--force]\n";
+        std::cerr << "       " << argv[0] << " compare <baseline_run|git_revision> [candidate_run|git_revision] [--alpha 0.05] [--min-change 0.05]\n";
+        std::cerr << "       " << argv[0] << " contention [--threads N] [--critical-section 0,100] [--runs 5] [--duration 200]\n";
+        std::cerr << "       " << argv[0] << " queues [--producers N] [--consumers N] [--sizes 32,256,1024] [--batch 1,16] [--messages 100000] [--runs 3]\n";
+        std::cerr << "       " << argv[0] << " layout <number_of_tests> <outlier_threshold> [--fields 2|4|8|16] [--field-size 4|8] [--force]\n";
+        std::cerr << "       " << argv[0] << " patterns <number_of_tests> <outlier_threshold> [--strides 1,2,4,...,4096] [--force]\n";
+        std::cerr << "       " << argv[0] << " bandwidth <number_of_tests> <outlier_threshold> [--force]\n";
+        std::cerr << "       " << argv[0] << " containers <number_of_tests> <outlier_threshold> [--max-size 10000000] [--force]\n";
+        std::cerr << "       " << argv[0] << " lifecycle <number_of_tests> <outlier_threshold> [--object-size 64] [--force]\n";
+        std::cerr << "       " << argv[0] << " dispatch <number_of_tests> <outlier_threshold> [--types 2,4,8] [--shuffle 0,10,100] [--max-size 10000000] [--force]\n";
+        std::cerr << "       " << argv[0] << " io [--block-sizes 4096,65536,1048576] [--queue-depths 1,8,32] [--file-size 256] [--directory DIR] [--runs 3]\n";
+        std::cerr << "       " << argv[0] << " transfer [--sizes 4096,65536,1048576,16777216,268435456,1073741824] [--directory DIR] [--runs 3]\n";
+        return 1;
+    }
+
+    int numTests = std::stoi(argv[1]);
     double threshold = std::stod(argv[2]);
+    forceRun = argc > 3 && std::string(argv[3]) == "--force";
+    if (numTests <= 0)
+    {
+        std::cerr << "Number of tests must be positive\n";
+        return 1;
+    }
+    if (!loadKernelSpec())
+    {
+        return 1;
+    }
+    sampleArena.reserve(numTests);
+
+    beginRun();
 
     StaticAccessMain(numTests, threshold);
     DynamicAccessMain(numTests, threshold);
@@ -537,8 +5294,22 @@ int main(int argc, char *argv[])
     ThreadCreationMain(numTests, threshold);
     ContextSwitchMain(numTests, threshold);
     ThreadMigrationMain(numTests, threshold);
+    FalseSharingMain(numTests, threshold);
 
-    combineJSONFiles({"C++_static_access.json", "C++_dynamic_access.json", "C++_allocation.json", "C++_deallocation.json", "C++_thread_creation.json", "C++_context_switch.json", "C++_thread_migration.json"}, "C++_results.json");
+    submitWrite({WriteRequest::COMBINE, "C++_results.json", {}, nullptr, "", "", {"C++_static_access.json", "C++_dynamic_access.json", "C++_allocation.json", "C++_deallocation.json", "C++_thread_creation.json", "C++_context_switch.json", "C++_thread_migration.json"}});
+    resultWriter.stop();
+
+    if (cacheHits > 0)
+    {
+        std::cout << "Reused " << cacheHits << " cached result(s); pass --force to re-measure everything.\n";
+    }
 
     return 0;
-}
\ No newline at end of file
+}
+
+#ifndef MEASURE_LIBRARY
+int main(int argc, char *argv[])
+{
+    return benchmarkMain(argc, argv);
+}
+#endif
@@ -0,0 +1,685 @@
+#ifndef MEASURE_COMMON_H
+#define MEASURE_COMMON_H
+
+// Sample storage, statistics, the asynchronous result writer and the context
+// switch and false sharing kernels, shared by the standalone harness
+// (measure.cpp) and the JNI library (C++_native_code.cpp). Each of them is a
+// single translation unit, so the definitions live here directly.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <ucontext.h>
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define HAVE_COROUTINES 1
+#endif
+
+// Samples of one sweep point, stored in a segment of the sample arena.
+struct SampleBuffer
+{
+    double *data;
+    size_t count;
+
+    void push(double sample) { data[count++] = sample; }
+    double *begin() { return data; }
+    double *end() { return data + count; }
+    const double *begin() const { return data; }
+    const double *end() const { return data + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+// Cache-line-aligned sample storage, allocated before a run and reused across
+// sizes and benchmarks so the drivers never touch the heap inside a sweep.
+// It is split into one segment per sweep point; a segment handed to the
+// result writer stays reserved until the writer releases it.
+class SampleArena
+{
+public:
+    static const size_t SEGMENTS = 32;
+
+    ~SampleArena()
+    {
+        std::free(storage);
+    }
+
+    // Only called between runs, when the writer has released every segment.
+    void reserve(size_t samplesPerSegment)
+    {
+        size_t stride = (samplesPerSegment * sizeof(double) + 63) / 64 * 64;
+        if (stride > segmentStride)
+        {
+            std::free(storage);
+            storage = static_cast<char *>(std::aligned_alloc(64, stride * SEGMENTS));
+            if (storage == nullptr)
+            {
+                std::cerr << "Failed to allocate the sample arena" << std::endl;
+                exit(EXIT_FAILURE);
+            }
+            segmentStride = stride;
+        }
+    }
+
+    SampleBuffer acquire()
+    {
+        size_t index = next++ % SEGMENTS;
+        while (reserved[index].load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+        reserved[index].store(true, std::memory_order_relaxed);
+        return {reinterpret_cast<double *>(storage + index * segmentStride), 0};
+    }
+
+    void release(const double *samples)
+    {
+        size_t index = (reinterpret_cast<const char *>(samples) - storage) / segmentStride;
+        reserved[index].store(false, std::memory_order_release);
+    }
+
+private:
+    char *storage = nullptr;
+    size_t segmentStride = 0;
+    size_t next = 0;
+    std::atomic<bool> reserved[SEGMENTS] = {};
+};
+
+SampleArena sampleArena;
+
+double calculateAverage(const SampleBuffer &times)
+{
+    return std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+}
+
+double calculateStandardDeviation(const SampleBuffer &times, double mean)
+{
+    double variance = 0.0;
+    for (const auto &time : times)
+    {
+        variance += (time - mean) * (time - mean);
+    }
+    return std::sqrt(variance / times.size());
+}
+
+void removeOutliers(SampleBuffer &times, double threshold)
+{
+    double mean = calculateAverage(times);
+    double stdDev = calculateStandardDeviation(times, mean);
+
+    double lowerThreshold = mean - threshold * stdDev;
+    double upperThreshold = mean + threshold * stdDev;
+
+    size_t kept = 0;
+    for (double time : times)
+    {
+        if (time >= lowerThreshold && time <= upperThreshold)
+        {
+            times.data[kept++] = time;
+        }
+    }
+    times.count = kept;
+}
+
+// Lock-free single-producer/single-consumer ring. The benchmark driver is the
+// only producer and the result writer thread the only consumer.
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool tryPush(T &item)
+    {
+        size_t current = tail.load(std::memory_order_relaxed);
+        if (current - head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        slots[current & (Capacity - 1)] = std::move(item);
+        tail.store(current + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(T &item)
+    {
+        size_t current = head.load(std::memory_order_relaxed);
+        if (current == tail.load(std::memory_order_acquire))
+            return false;
+        item = std::move(slots[current & (Capacity - 1)]);
+        head.store(current + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    T slots[Capacity];
+};
+
+// Owns all result serialization, file I/O and console output so none of it
+// runs on the measuring thread between samples. Only drain() and stop()
+// block. The writer thread calls handler(request) for every submitted
+// request, and handler.idle() whenever the queue has stayed empty for a while
+// and once more before it exits.
+template <typename Request, typename Handler>
+class ResultWriter
+{
+public:
+    ~ResultWriter()
+    {
+        stop();
+    }
+
+    void submit(Request &request)
+    {
+        if (!running.load(std::memory_order_relaxed))
+            start();
+        while (!queue.tryPush(request))
+        {
+            std::this_thread::yield();
+        }
+        submitted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void drain()
+    {
+        while (completed.load(std::memory_order_acquire) != submitted.load(std::memory_order_relaxed))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    // Writes everything submitted so far, ends the writer thread and gives
+    // the caller back the CPU it lent the writer. The next submit() starts a
+    // new writer. Call it from the thread that submitted.
+    void stop()
+    {
+        if (running.exchange(false))
+            worker.join();
+        if (narrowed && pthread_equal(caller, pthread_self()))
+            sched_setaffinity(0, sizeof(callerAffinity), &callerAffinity);
+        narrowed = false;
+    }
+
+private:
+    void start()
+    {
+        running = true;
+        worker = std::thread(&ResultWriter::run, this);
+        pinAwayFromCaller(worker);
+    }
+
+    // Give the writer a core of its own: the highest allowed CPU goes to the
+    // writer and the caller, together with every thread it spawns later, is
+    // restricted to the rest until stop(). The thread migration benchmark
+    // bounces between CPUs 0 and 1, so the highest CPU is the least
+    // disruptive choice.
+    void pinAwayFromCaller(std::thread &thread)
+    {
+        cpu_set_t allowed;
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) < 2)
+            return;
+        caller = pthread_self();
+        callerAffinity = allowed;
+        for (int cpu = CPU_SETSIZE - 1; cpu >= 0; --cpu)
+        {
+            if (CPU_ISSET(cpu, &allowed))
+            {
+                cpu_set_t target;
+                CPU_ZERO(&target);
+                CPU_SET(cpu, &target);
+                pthread_setaffinity_np(thread.native_handle(), sizeof(target), &target);
+                CPU_CLR(cpu, &allowed);
+                narrowed = sched_setaffinity(0, sizeof(allowed), &allowed) == 0;
+                return;
+            }
+        }
+    }
+
+    void run()
+    {
+        Request request;
+        int idleSpins = 0;
+        while (true)
+        {
+            if (queue.tryPop(request))
+            {
+                handler(request);
+                completed.fetch_add(1, std::memory_order_release);
+                idleSpins = 0;
+            }
+            else if (!running.load(std::memory_order_relaxed))
+            {
+                break;
+            }
+            else if (++idleSpins < 64)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                handler.idle();
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+        handler.idle();
+    }
+
+    Handler handler;
+    SpscQueue<Request, 256> queue;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> completed{0};
+    pthread_t caller{};
+    cpu_set_t callerAffinity{};
+    bool narrowed = false;
+};
+
+// Set by every kernel to a value derived from its work, defined by the
+// including file.
+extern uint64_t kernelChecksum;
+
+double measureContextSwitchTime(int iterations)
+{
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool turn = true;
+    uint64_t handoffs = 0;
+
+    auto threadFunc = [&](bool myTurn)
+    {
+        for (int i = 0; i < iterations / 2; ++i)
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&]
+                    { return turn == myTurn; });
+            turn = !myTurn;
+            ++handoffs;
+            lock.unlock();
+            cv.notify_one();
+        }
+    };
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::thread t1(threadFunc, true);
+    std::thread t2(threadFunc, false);
+
+    t1.join();
+    t2.join();
+
+    auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = handoffs;
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / iterations;
+}
+
+// User-space switches, counted like measureContextSwitchTime: iterations / 2
+// round trips of two handoffs each, so every case shares its checksum.
+const size_t FIBER_STACK_SIZE = 64 * 1024;
+
+#if HAVE_COROUTINES
+// Coroutine that runs until its first co_await; the handle is destroyed with it.
+struct SwitchTask
+{
+    struct promise_type
+    {
+        SwitchTask get_return_object() { return SwitchTask{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    explicit SwitchTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    SwitchTask(const SwitchTask &) = delete;
+    SwitchTask &operator=(const SwitchTask &) = delete;
+    ~SwitchTask() { handle.destroy(); }
+};
+
+// Symmetric transfer: suspends the current coroutine and resumes *peer
+// without going back through the caller.
+struct HandOff
+{
+    std::coroutine_handle<> *peer;
+    bool await_ready() noexcept { return false; }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept { return *peer; }
+    void await_resume() noexcept {}
+};
+
+SwitchTask pingPong(std::coroutine_handle<> &peer, int &remaining, uint64_t &handoffs)
+{
+    while (remaining > 0)
+    {
+        --remaining;
+        ++handoffs;
+        co_await HandOff{&peer};
+    }
+}
+
+double measureCoroutineSwitchTime(int iterations)
+{
+    int remaining = iterations / 2 * 2;
+    uint64_t handoffs = 0;
+    std::coroutine_handle<> first, second;
+    SwitchTask ping = pingPong(second, remaining, handoffs);
+    SwitchTask pong = pingPong(first, remaining, handoffs);
+    first = ping.handle;
+    second = pong.handle;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    first.resume();
+    auto end = std::chrono::high_resolution_clock::now();
+
+    kernelChecksum = handoffs;
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / iterations;
+}
+#endif
+
+struct UcontextPingPong
+{
+    ucontext_t caller;
+    ucontext_t fiber;
+    uint64_t handoffs;
+};
+
+// makecontext only passes int arguments, so the fiber finds its state here.
+UcontextPingPong *activeUcontextPingPong = nullptr;
+
+void ucontextFiberLoop()
+{
+    UcontextPingPong &pingPong = *activeUcontextPingPong;
+    for (;;)
+    {
+        ++pingPong.handoffs;
+        swapcontext(&pingPong.fiber, &pingPong.caller);
+    }
+}
+
+double measureUcontextSwitchTime(int iterations)
+{
+    std::vector<char> stack(FIBER_STACK_SIZE);
+    UcontextPingPong pingPong{};
+    activeUcontextPingPong = &pingPong;
+    getcontext(&pingPong.fiber);
+    pingPong.fiber.uc_stack.ss_sp = stack.data();
+    pingPong.fiber.uc_stack.ss_size = stack.size();
+    pingPong.fiber.uc_link = nullptr;
+    makecontext(&pingPong.fiber, ucontextFiberLoop, 0);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations / 2; ++i)
+    {
+        ++pingPong.handoffs;
+        swapcontext(&pingPong.caller, &pingPong.fiber);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    // The fiber is left suspended; nothing resumes it once its stack is gone.
+    kernelChecksum = pingPong.handoffs;
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / iterations;
+}
+
+#if defined(__x86_64__)
+// Saves the callee-saved registers on the current stack, stores the stack
+// pointer in *from and resumes the fiber whose stack pointer is to. Unlike
+// swapcontext it leaves the signal mask alone, so it never enters the kernel.
+extern "C" void switchFiber(void **from, void *to);
+asm(R"(
+    .text
+    .globl switchFiber
+    .hidden switchFiber
+    .type switchFiber, @function
+switchFiber:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size switchFiber, .-switchFiber
+)");
+
+// Lays out a fresh stack so that the first switchFiber into it returns into
+// entry with the alignment of a normal call. entry must never return.
+void *prepareFiberStack(std::vector<char> &stack, void (*entry)())
+{
+    uintptr_t top = (reinterpret_cast<uintptr_t>(stack.data()) + stack.size()) & ~uintptr_t(15);
+    void **sp = reinterpret_cast<void **>(top);
+    *--sp = nullptr;
+    *--sp = reinterpret_cast<void *>(entry);
+    for (int i = 0; i < 6; ++i)
+        *--sp = nullptr;
+    return sp;
+}
+
+struct FiberPingPong
+{
+    void *caller;
+    void *fiber;
+    uint64_t handoffs;
+};
+
+FiberPingPong *activeFiberPingPong = nullptr;
+
+void fiberLoop()
+{
+    FiberPingPong &pingPong = *activeFiberPingPong;
+    for (;;)
+    {
+        ++pingPong.handoffs;
+        switchFiber(&pingPong.fiber, pingPong.caller);
+    }
+}
+
+double measureFiberSwitchTime(int iterations)
+{
+    std::vector<char> stack(FIBER_STACK_SIZE);
+    FiberPingPong pingPong{};
+    activeFiberPingPong = &pingPong;
+    pingPong.fiber = prepareFiberStack(stack, fiberLoop);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations / 2; ++i)
+    {
+        ++pingPong.handoffs;
+        switchFiber(&pingPong.caller, pingPong.fiber);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    kernelChecksum = pingPong.handoffs;
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / iterations;
+}
+
+// Round-robin scheduler on one thread: it resumes each fiber in turn and every
+// fiber yields straight back, touching Fibers stacks in rotation.
+struct FiberScheduler
+{
+    void *scheduler;
+    std::vector<void *> fibers;
+    size_t current;
+    uint64_t handoffs;
+};
+
+FiberScheduler *activeFiberScheduler = nullptr;
+
+void scheduledFiberLoop()
+{
+    FiberScheduler &scheduler = *activeFiberScheduler;
+    for (;;)
+    {
+        ++scheduler.handoffs;
+        switchFiber(&scheduler.fibers[scheduler.current], scheduler.scheduler);
+    }
+}
+
+template <int Fibers>
+double measureFiberSchedulerSwitchTime(int iterations)
+{
+    std::vector<std::vector<char>> stacks(Fibers, std::vector<char>(FIBER_STACK_SIZE));
+    FiberScheduler scheduler{};
+    activeFiberScheduler = &scheduler;
+    for (auto &stack : stacks)
+        scheduler.fibers.push_back(prepareFiberStack(stack, scheduledFiberLoop));
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations / 2; ++i)
+    {
+        scheduler.current = i % Fibers;
+        ++scheduler.handoffs;
+        switchFiber(&scheduler.scheduler, scheduler.fibers[scheduler.current]);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    kernelChecksum = scheduler.handoffs;
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / iterations;
+}
+#endif
+
+struct ContextSwitchCase
+{
+    const char *process;
+    double (*measure)(int);
+};
+
+// Kernel thread handoffs first, then the user-space switches that would
+// replace them. All are reported in ns per switch.
+const ContextSwitchCase CONTEXT_SWITCH_CASES[] = {
+    {"Context Switch", measureContextSwitchTime},
+#if HAVE_COROUTINES
+    {"Context Switch: Coroutine", measureCoroutineSwitchTime},
+#endif
+    {"Context Switch: Fiber (swapcontext)", measureUcontextSwitchTime},
+#if defined(__x86_64__)
+    {"Context Switch: Fiber (Assembly)", measureFiberSwitchTime},
+    {"Context Switch: Fiber Scheduler, 2 Fibers", measureFiberSchedulerSwitchTime<2>},
+    {"Context Switch: Fiber Scheduler, 16 Fibers", measureFiberSchedulerSwitchTime<16>},
+    {"Context Switch: Fiber Scheduler, 256 Fibers", measureFiberSchedulerSwitchTime<256>},
+#endif
+};
+
+// Powers of two up to maxThreads, and maxThreads itself.
+std::vector<int> threadSweep(int maxThreads)
+{
+    std::vector<int> counts;
+    for (int threads = 1; threads < maxThreads; threads *= 2)
+    {
+        counts.push_back(threads);
+    }
+    counts.push_back(maxThreads);
+    return counts;
+}
+
+// Counter layouts of the false sharing benchmark: the distance in bytes
+// between the counters of neighbouring threads, or 0 when every thread counts
+// in a local on its own stack and only publishes the total at the end.
+struct FalseSharingLayout
+{
+    const char *process;
+    size_t stride;
+};
+
+const FalseSharingLayout FALSE_SHARING_LAYOUTS[] = {
+    {"False Sharing: Packed", sizeof(uint64_t)},
+    {"False Sharing: 64-Byte Padded", 64},
+    {"False Sharing: 128-Byte Padded", 128},
+    {"False Sharing: Thread-Local", 0}};
+
+const int FALSE_SHARING_INCREMENTS = 1000000;
+
+// Every thread increments its own counter increments times. 128-byte padding
+// also keeps the adjacent-line prefetcher from pulling in a neighbour's line.
+// Returns the wall time per increment over all threads, so ops/s is 1e9
+// divided by it.
+double measureFalseSharing(int threads, size_t stride, int increments)
+{
+    size_t slot = stride == 0 ? sizeof(uint64_t) : stride;
+    size_t bytes = (threads * slot + 127) / 128 * 128;
+    char *counters = static_cast<char *>(std::aligned_alloc(128, bytes));
+    std::memset(counters, 0, bytes);
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+
+    auto increment = [&](int t)
+    {
+        volatile uint64_t *counter = reinterpret_cast<volatile uint64_t *>(counters + t * slot);
+        ready.fetch_add(1);
+        while (!go.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+        if (stride == 0)
+        {
+            volatile uint64_t local = 0;
+            for (int i = 0; i < increments; ++i)
+            {
+                local = local + 1;
+            }
+            *counter = local;
+        }
+        else
+        {
+            for (int i = 0; i < increments; ++i)
+            {
+                *counter = *counter + 1;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back(increment, t);
+    }
+    while (ready.load() < threads)
+    {
+        std::this_thread::yield();
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    uint64_t total = 0;
+    for (int t = 0; t < threads; ++t)
+    {
+        total += *reinterpret_cast<uint64_t *>(counters + t * slot);
+    }
+    std::free(counters);
+    kernelChecksum = total;
+
+    double time = std::chrono::duration<double, std::nano>(end - start).count();
+    return time / (static_cast<double>(threads) * increments);
+}
+
+#endif
@@ -1,24 +1,111 @@
+import org.json.JSONException;
 import org.json.JSONObject;
 import org.json.JSONArray;
 
+import com.sun.management.GarbageCollectionNotificationInfo;
+import com.sun.management.GcInfo;
+
 import java.io.File;
 import java.io.FileWriter;
 import java.io.IOException;
+import java.lang.management.GarbageCollectorMXBean;
+import java.lang.management.ManagementFactory;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.ArrayList;
 import java.util.Arrays;
-import java.util.concurrent.atomic.AtomicBoolean;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.stream.Collectors;
+import java.util.concurrent.TimeUnit;
 import java.util.concurrent.locks.Condition;
 import java.util.concurrent.locks.Lock;
 import java.util.concurrent.locks.ReentrantLock;
+import javax.management.Notification;
+import javax.management.NotificationEmitter;
+import javax.management.openmbean.CompositeData;
 
 public class BenchmarkEngine {
     private JNInterface jni;
     public BenchmarkEngine() {
         jni = new JNInterface();
+        jni.setNative_Cpp_OutputFormat(parseOutputFormat(System.getProperty("benchmark.output", "binary")));
+    }
+
+    private static int parseOutputFormat(String format) {
+        switch (format.toLowerCase()) {
+            case "json":
+                return JNInterface.OUTPUT_JSON;
+            case "both":
+                return JNInterface.OUTPUT_JSON | JNInterface.OUTPUT_BINARY;
+            default:
+                return JNInterface.OUTPUT_BINARY;
+        }
     }
 
     private static final int[] ARRAY_SIZES = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
     private static final int[] ITERATIONS= {2, 10, 100, 1000, 10000};
     private static final String LANGUAGE = "Java";
+    private static final int WARMUP_MAX_ROUNDS = 200;
+    private static final int WARMUP_WINDOW = 5;
+    private static final double WARMUP_TOLERANCE = 0.05;
+    private static ResultListener resultListener;
+
+    // JIT warm-up calls before each sweep point, and whether each Java
+    // benchmark runs in its own JVM. Choosing a collector implies forking.
+    private static final int WARMUP_ITERATIONS = Integer.getInteger("benchmark.java.warmup", 5);
+    private static final String FORK_GC = System.getProperty("benchmark.java.gc", "");
+    private static final boolean FORK_JVM = Boolean.getBoolean("benchmark.java.fork") || !FORK_GC.isEmpty();
+    private static final String[] RESULT_FILES = {
+            "Java_allocation.json", "Java_deallocation.json", "Java_static_access.json", "Java_dynamic_access.json",
+            "Java_thread_creation.json", "Java_context_switch.json", "Java_thread_migration.json"
+    };
+
+    private static final Blackhole blackhole = new Blackhole();
+
+    // Checksum of the last kernel call, compared with kernel_spec.json after
+    // every sample like the C and C++ harnesses do.
+    private static long kernelChecksum;
+    // Set by cancelBenchmark, cleared by prepareRun. Checked between samples.
+    private static volatile boolean cancelled;
+    private static KernelSpec kernelSpec;
+
+    // Collectors whose time is spent in pauses. Beans for concurrent cycles
+    // (ZGC Cycles, G1 Concurrent GC) count time the mutator kept running.
+    private static final List<GarbageCollectorMXBean> PAUSE_COLLECTORS = ManagementFactory.getGarbageCollectorMXBeans().stream()
+            .filter(collector -> !collector.getName().contains("Cycles") && !collector.getName().contains("Concurrent"))
+            .collect(Collectors.toList());
+    // Pauses the collectors have reported, converted from JVM uptime to
+    // System.nanoTime(). Notifications arrive on their own thread after the
+    // collection; collectionsSeen holds the last collection each pause
+    // collector has reported so a sample can wait for its own.
+    private static final long JVM_START_NANOS = System.nanoTime() - ManagementFactory.getRuntimeMXBean().getUptime() * 1_000_000L;
+    private static final Object gcLock = new Object();
+    private static final List<long[]> gcPauses = new ArrayList<>();
+    private static final Map<String, Long> collectionsSeen = new HashMap<>();
+    // The timed section of the last kernel call, and the collection it forced
+    // after that section if any.
+    private static long timedStart;
+    private static long timedEnd;
+    private static long forcedCollectionNanos;
+
+    static {
+        for (GarbageCollectorMXBean collector : PAUSE_COLLECTORS) {
+            if (collector instanceof NotificationEmitter) {
+                collectionsSeen.put(collector.getName(), collector.getCollectionCount());
+                ((NotificationEmitter) collector).addNotificationListener(BenchmarkEngine::recordPause, null, null);
+            }
+        }
+    }
+
+    private static final String GARBAGE_COLLECTOR = ManagementFactory.getGarbageCollectorMXBeans().stream()
+            .map(GarbageCollectorMXBean::getName)
+            .collect(Collectors.joining(", "));
+    // Build stamp matching the native results: the JIT stands in for the
+    // compiler and the JVM options for its flags.
+    private static final String COMPILER = System.getProperty("java.vm.name") + " " + System.getProperty("java.vm.version");
+    private static final String COMPILER_FLAGS = String.join(" ", ManagementFactory.getRuntimeMXBean().getInputArguments());
     private static final JSONArray allocationResults = new JSONArray();
     private static final JSONArray deallocationResults = new JSONArray();
     private static final JSONArray staticAccessResults = new JSONArray();
@@ -58,13 +145,15 @@ public class BenchmarkEngine {
         }
 
         long startTime = System.nanoTime();
-        int sum = 0;
+        long sum = 0;
         for (int i = 0; i < size; i++) {
             sum += staticArray[i];
         }
         long endTime = System.nanoTime();
+        blackhole.consume(sum);
+        kernelChecksum = sum;
 
-        return (endTime - startTime) / (double) size;
+        return timedSection(startTime, endTime, size);
     }
 
     private static double measureDynamicMemoryAccess(int size) {
@@ -74,13 +163,15 @@ public class BenchmarkEngine {
         }
 
         long startTime = System.nanoTime();
-        int sum = 0;
+        long sum = 0;
         for (int i = 0; i < size; i++) {
             sum += dynamicArray[i];
         }
         long endTime = System.nanoTime();
+        blackhole.consume(sum);
+        kernelChecksum = sum;
 
-        return (endTime - startTime) / (double) size;
+        return timedSection(startTime, endTime, size);
     }
 
     private static double measureMemoryAllocation(int size) {
@@ -90,101 +181,112 @@ public class BenchmarkEngine {
             chunks[i] = new int[1];
         }
         long endTime = System.nanoTime();
+        blackhole.consume(chunks);
 
+        long sum = 0;
         for (int i = 0; i < size; i++) {
+            chunks[i][0] = i;
+            sum += chunks[i][0];
             chunks[i] = null;
         }
-        return (endTime - startTime) / (double) size;
+        kernelChecksum = sum;
+        return timedSection(startTime, endTime, size);
     }
 
     private static double measureMemoryDeallocation(int size) {
         int[][] chunks = new int[size][];
+        long sum = 0;
         for (int i = 0; i < size; i++) {
             chunks[i] = new int[1];
+            chunks[i][0] = i;
+            sum += chunks[i][0];
         }
+        blackhole.consume(chunks);
+        kernelChecksum = sum;
 
+        // Only dropping the references is timed. The collection that frees
+        // the chunks is forced afterwards and reported as gc_time.
         long startTime = System.nanoTime();
         for (int i = 0; i < size; i++) {
             chunks[i] = null;
         }
-        System.gc();
         long endTime = System.nanoTime();
+        System.gc();
+        forcedCollectionNanos = System.nanoTime() - endTime;
 
-        return (endTime - startTime) / (double) size;
+        return timedSection(startTime, endTime, size);
     }
 
     private static double measureThreadCreationTime(int iterations) throws InterruptedException {
+        long checksum = 0;
         long startTime = System.nanoTime();
         for (int i = 0; i < iterations; i++) {
+            long[] result = new long[1];
             Thread thread = new Thread(() -> {
                 int sum = 0;
                 for (int j = 0; j < 1000; j++) {
                     sum += j;
                 }
+                result[0] = sum;
             });
             thread.start();
             thread.join();
+            checksum += result[0];
         }
         long endTime = System.nanoTime();
+        kernelChecksum = checksum;
 
-        return (endTime - startTime) / (double) iterations;
+        return timedSection(startTime, endTime, iterations);
     }
 
+    // One lock and one condition shared by both threads, as in the C and C++ kernels.
     private static double measureContextSwitchTime(int iterations) throws InterruptedException {
         Lock lock = new ReentrantLock();
-        Condition condition1 = lock.newCondition();
-        Condition condition2 = lock.newCondition();
-        AtomicBoolean turn = new AtomicBoolean(true);
-
-        Runnable thread1Task = () -> {
-            try {
-                for (int i = 0; i < iterations / 2; i++) {
-                    lock.lock();
-                    try {
-                        while (!turn.get()) {
-                            condition1.await();
+        Condition turnChanged = lock.newCondition();
+        boolean[] turn = {true};
+        long[] handoffs = {0};
+
+        Runnable[] tasks = new Runnable[2];
+        for (int t = 0; t < tasks.length; t++) {
+            boolean myTurn = t == 0;
+            tasks[t] = () -> {
+                try {
+                    for (int i = 0; i < iterations / 2; i++) {
+                        lock.lock();
+                        try {
+                            while (turn[0] != myTurn) {
+                                turnChanged.await();
+                            }
+                            turn[0] = !myTurn;
+                            handoffs[0]++;
+                            turnChanged.signal();
+                        } finally {
+                            lock.unlock();
                         }
-                        turn.set(false);
-                        condition2.signal();
-                    } finally {
-                        lock.unlock();
                     }
+                } catch (InterruptedException e) {
+                    Thread.currentThread().interrupt();
                 }
-            } catch (InterruptedException e) {
-                Thread.currentThread().interrupt();
-            }
-        };
-
-        Runnable thread2Task = () -> {
-            try {
-                for (int i = 0; i < iterations / 2; i++) {
-                    lock.lock();
-                    try {
-                        while (turn.get()) {
-                            condition2.await();
-                        }
-                        turn.set(true);
-                        condition1.signal();
-                    } finally {
-                        lock.unlock();
-                    }
-                }
-            } catch (InterruptedException e) {
-                Thread.currentThread().interrupt();
-            }
-        };
+            };
+        }
 
         long startTime = System.nanoTime();
 
-        Thread t1 = new Thread(thread1Task);
-        Thread t2 = new Thread(thread2Task);
+        Thread t1 = new Thread(tasks[0]);
+        Thread t2 = new Thread(tasks[1]);
         t1.start();
         t2.start();
         t1.join();
         t2.join();
 
         long endTime = System.nanoTime();
-        return (endTime - startTime) / (double) iterations;
+        lock.lock();
+        try {
+            kernelChecksum = handoffs[0];
+        } finally {
+            lock.unlock();
+        }
+        return timedSection(startTime, endTime, iterations);
     }
 
     static {
@@ -193,7 +295,10 @@ public class BenchmarkEngine {
 
     public native double measureThreadMigrationTime(int iterations);
 
-    private static void saveResultToArray(JSONArray resultsArray, double average, double stdDev, String process, int numTests, int passedTests, String language, int arraySize, int iterations, double threshold, String fileName) {
+    // Affinity changes that succeeded in the last measureThreadMigrationTime call.
+    public native long getThreadMigrationChecksum();
+
+    private static void saveResultToArray(JSONArray resultsArray, double average, double stdDev, double gcTime, long checksum, int mismatches, String process, int numTests, int passedTests, String language, int arraySize, int iterations, double threshold, String fileName) {
         File directory = new File("Java_measurements");
         if (!directory.exists()) {
             directory.mkdir();
@@ -215,7 +320,21 @@ public class BenchmarkEngine {
         json.put("process_measured", process);
         json.put("average_time", average);
         json.put("std_deviation", stdDev);
+        json.put("gc_time", gcTime);
+        json.put("garbage_collector", GARBAGE_COLLECTOR);
+        json.put("checksum", checksum);
+        json.put("checksum_valid", mismatches == 0);
+        json.put("compiler", COMPILER);
+        json.put("compiler_flags", COMPILER_FLAGS);
+        json.put("build_profile", "jit");
         resultsArray.put(json);
+        if (mismatches > 0) {
+            System.err.println(process + ": " + mismatches + " samples did not match the kernel spec checksum (last " + checksum + ")");
+        }
+
+        if (resultListener != null) {
+            resultListener.onResult(new BenchmarkResult(arraySize, iterations, numTests, passedTests, (int) threshold, language, process, average, stdDev, gcTime, checksum, COMPILER));
+        }
 
         try (FileWriter fileWriter = new FileWriter(file)) {
             fileWriter.write(resultsArray.toString(4));
@@ -226,17 +345,22 @@ public class BenchmarkEngine {
     }
 
 
+    // Reads the per-benchmark files back, so it also works after forked runs.
     private static void createCombinedResultsJSON() {
 
         JSONArray combinedResults = new JSONArray();
         File directory = new File("Java_measurements");
-        combinedResults.putAll(allocationResults);
-        combinedResults.putAll(deallocationResults);
-        combinedResults.putAll(staticAccessResults);
-        combinedResults.putAll(dynamicAccessResults);
-        combinedResults.putAll(threadCreationResults);
-        combinedResults.putAll(contextSwitchResults);
-        combinedResults.putAll(threadMigrationResults);
+        for (String fileName : RESULT_FILES) {
+            File file = new File(directory, fileName);
+            if (!file.exists()) {
+                continue;
+            }
+            try {
+                combinedResults.putAll(new JSONArray(new String(Files.readAllBytes(file.toPath()))));
+            } catch (IOException e) {
+                e.printStackTrace();
+            }
+        }
 
         File file = new File(directory, "Java_results.json");
         try (FileWriter fileWriter = new FileWriter(file)) {
@@ -247,123 +371,156 @@ public class BenchmarkEngine {
         }
     }
 
-    private static void measureStaticMemoryAccess(int numTests, double threshold) {
-        for (int size : ARRAY_SIZES) {
-            double[] staticAccessTimes = new double[numTests];
-            for (int i = 0; i < numTests; i++) {
-                staticAccessTimes[i] = measureStaticMemoryAccess(size);
+    private interface Kernel {
+        double run(int parameter) throws InterruptedException;
+    }
+
+    // Records the timed section of a kernel call and returns its time per
+    // operation. Kernels that don't call it are timed as a whole.
+    private static double timedSection(long startTime, long endTime, int operations) {
+        timedStart = startTime;
+        timedEnd = endTime;
+        return (endTime - startTime) / (double) operations;
+    }
+
+    private static void recordPause(Notification notification, Object handback) {
+        if (!notification.getType().equals(GarbageCollectionNotificationInfo.GARBAGE_COLLECTION_NOTIFICATION)) {
+            return;
+        }
+        GarbageCollectionNotificationInfo info = GarbageCollectionNotificationInfo.from((CompositeData) notification.getUserData());
+        GcInfo collection = info.getGcInfo();
+        synchronized (gcLock) {
+            gcPauses.add(new long[]{JVM_START_NANOS + collection.getStartTime() * 1_000_000L, JVM_START_NANOS + collection.getEndTime() * 1_000_000L});
+            collectionsSeen.merge(info.getGcName(), collection.getId(), Math::max);
+            gcLock.notifyAll();
+        }
+    }
+
+    // Pause time between start and end, once every pause collector has
+    // reported the collections it has counted so far. Late notifications are
+    // given up on after a second. Reported pauses are only looked at once.
+    private static long gcPauseNanos(long start, long end) throws InterruptedException {
+        long deadline = System.nanoTime() + TimeUnit.SECONDS.toNanos(1);
+        synchronized (gcLock) {
+            for (GarbageCollectorMXBean collector : PAUSE_COLLECTORS) {
+                long count = collector.getCollectionCount();
+                Long seen = collectionsSeen.get(collector.getName());
+                while (seen != null && seen < count && System.nanoTime() < deadline) {
+                    TimeUnit.NANOSECONDS.timedWait(gcLock, deadline - System.nanoTime());
+                    seen = collectionsSeen.get(collector.getName());
+                }
             }
-            int staticSize = removeOutliers(staticAccessTimes, threshold);
-            if (staticSize > 0) {
-                double average = calculateAverage(staticAccessTimes, staticSize);
-                double stdDev = calculateStandardDeviation(staticAccessTimes, average, staticSize);
-                saveResultToArray(staticAccessResults, average, stdDev, "Static Memory Access", numTests, staticSize, LANGUAGE, size,0,threshold, "Java_static_access.json");
-            } else {
-                System.out.println("All static memory access times are outliers for array size: " + size);
+            long pause = 0;
+            for (long[] interval : gcPauses) {
+                pause += Math.max(0, Math.min(end, interval[1]) - Math.max(start, interval[0]));
             }
+            gcPauses.clear();
+            return pause;
         }
     }
 
-    private static void measureDynamicMemoryAccess(int numTests, double threshold) {
-        for (int size : ARRAY_SIZES) {
-            double[] dynamicAccessTimes = new double[numTests];
-            for (int i = 0; i < numTests; i++) {
-                dynamicAccessTimes[i] = measureDynamicMemoryAccess(size);
+    // One sweep point: WARMUP_ITERATIONS unmeasured calls so the JIT has
+    // compiled the kernel, then numTests samples. GC pauses inside a sample's
+    // timed section are taken out of it, so samples are mutator time, and
+    // reported as gc_time per operation together with any collection the
+    // kernel forced. A cancelled point is not saved, so its file keeps the
+    // points before it.
+    private static void measurePoint(Kernel kernel, String process, int arraySize, int iterations, int numTests, double threshold, JSONArray results, String fileName) throws InterruptedException {
+        if (cancelled) {
+            return;
+        }
+        int operations = arraySize > 0 ? arraySize : iterations;
+        for (int i = 0; i < WARMUP_ITERATIONS; i++) {
+            blackhole.consume(kernel.run(operations));
+        }
+
+        long expected = kernelSpec.expectedChecksum(process, operations);
+        int mismatches = 0;
+        double[] times = new double[numTests];
+        double gcTime = 0.0;
+        for (int i = 0; i < numTests && !cancelled; i++) {
+            forcedCollectionNanos = 0;
+            timedStart = System.nanoTime();
+            timedEnd = 0;
+            double time = kernel.run(operations);
+            if (timedEnd == 0) {
+                timedEnd = System.nanoTime();
             }
-            int dynamicSize = removeOutliers(dynamicAccessTimes, threshold);
-            if (dynamicSize > 0) {
-                double average = calculateAverage(dynamicAccessTimes, dynamicSize);
-                double stdDev = calculateStandardDeviation(dynamicAccessTimes, average, dynamicSize);
-                saveResultToArray(dynamicAccessResults, average, stdDev, "Dynamic Memory Access", numTests, dynamicSize, LANGUAGE, size,0, threshold, "Java_dynamic_access.json");
-            } else {
-                System.out.println("All dynamic memory access times are outliers for array size: " + size);
+            double pause = gcPauseNanos(timedStart, timedEnd) / (double) operations;
+            times[i] = Math.max(0.0, time - pause);
+            gcTime += pause + forcedCollectionNanos / (double) operations;
+            if (kernelChecksum != expected) {
+                mismatches++;
             }
         }
+
+        if (cancelled) {
+            return;
+        }
+
+        int passed = removeOutliers(times, threshold);
+        if (passed > 0) {
+            double average = calculateAverage(times, passed);
+            double stdDev = calculateStandardDeviation(times, average, passed);
+            saveResultToArray(results, average, stdDev, gcTime / numTests, kernelChecksum, mismatches, process, numTests, passed, LANGUAGE, arraySize, iterations, threshold, fileName);
+        } else if (arraySize > 0) {
+            System.out.println("All " + process.toLowerCase() + " times are outliers for array size: " + arraySize);
+        } else {
+            System.out.println("All " + process.toLowerCase() + " times are outliers for iterations: " + iterations);
+        }
     }
 
-    private static void measureMemoryAllocation(int numTests, double threshold) {
+    private static void measureStaticMemoryAccess(int numTests, double threshold) throws InterruptedException {
+        staticAccessResults.clear();
         for (int size : ARRAY_SIZES) {
-            double[] allocTimes = new double[numTests];
-            for (int i = 0; i < numTests; i++) {
-                allocTimes[i] = measureMemoryAllocation(size);
-            }
-            int allocSize = removeOutliers(allocTimes, threshold);
-            if (allocSize > 0) {
-                double average = calculateAverage(allocTimes, allocSize);
-                double stdDev = calculateStandardDeviation(allocTimes, average, allocSize);
-                saveResultToArray(allocationResults, average, stdDev, "Memory Allocation", numTests, allocSize, LANGUAGE, size, 0,threshold, "Java_allocation.json");
-            } else {
-                System.out.println("All memory allocation times are outliers for array size: " + size);
-            }
+            measurePoint(BenchmarkEngine::measureStaticMemoryAccess, "Static Memory Access", size, 0, numTests, threshold, staticAccessResults, "Java_static_access.json");
         }
     }
 
-    private static void measureMemoryDeallocation(int numTests, double threshold) {
+    private static void measureDynamicMemoryAccess(int numTests, double threshold) throws InterruptedException {
+        dynamicAccessResults.clear();
         for (int size : ARRAY_SIZES) {
-            double[] deallocTimes = new double[numTests];
-            for (int i = 0; i < numTests; i++) {
-                deallocTimes[i] = measureMemoryDeallocation(size);
-            }
-            int deallocSize = removeOutliers(deallocTimes, threshold);
-            if (deallocSize > 0) {
-                double average = calculateAverage(deallocTimes, deallocSize);
-                double stdDev = calculateStandardDeviation(deallocTimes, average, deallocSize);
-                saveResultToArray(deallocationResults, average, stdDev, "Memory Deallocation", numTests, deallocSize, LANGUAGE, size, 0,threshold, "Java_deallocation.json");
-            } else {
-                System.out.println("All memory deallocation times are outliers for array size: " + size);
-            }
+            measurePoint(BenchmarkEngine::measureDynamicMemoryAccess, "Dynamic Memory Access", size, 0, numTests, threshold, dynamicAccessResults, "Java_dynamic_access.json");
+        }
+    }
+
+    private static void measureMemoryAllocation(int numTests, double threshold) throws InterruptedException {
+        allocationResults.clear();
+        for (int size : ARRAY_SIZES) {
+            measurePoint(BenchmarkEngine::measureMemoryAllocation, "Memory Allocation", size, 0, numTests, threshold, allocationResults, "Java_allocation.json");
+        }
+    }
+
+    private static void measureMemoryDeallocation(int numTests, double threshold) throws InterruptedException {
+        deallocationResults.clear();
+        for (int size : ARRAY_SIZES) {
+            measurePoint(BenchmarkEngine::measureMemoryDeallocation, "Memory Deallocation", size, 0, numTests, threshold, deallocationResults, "Java_deallocation.json");
         }
     }
 
     private static void measureThreadCreation(int numTests, double threshold) throws InterruptedException {
+        threadCreationResults.clear();
         for (int iterations : ITERATIONS) {
-            double[] threadCreationTimes = new double[numTests];
-            for (int i = 0; i < numTests; i++) {
-                threadCreationTimes[i] = measureThreadCreationTime(iterations);
-            }
-            int creationSize = removeOutliers(threadCreationTimes, threshold);
-            if (creationSize > 0) {
-                double average = calculateAverage(threadCreationTimes, creationSize);
-                double stdDev = calculateStandardDeviation(threadCreationTimes, average, creationSize);
-                saveResultToArray(threadCreationResults, average, stdDev, "Thread Creation", numTests, creationSize, LANGUAGE, 0, iterations, threshold, "Java_thread_creation.json");
-            } else {
-                System.out.println("All thread creation times are outliers for iterations: " + iterations);
-            }
+            measurePoint(BenchmarkEngine::measureThreadCreationTime, "Thread Creation", 0, iterations, numTests, threshold, threadCreationResults, "Java_thread_creation.json");
         }
     }
 
     private static void measureContextSwitch(int numTests, double threshold) throws InterruptedException {
+        contextSwitchResults.clear();
         for (int iterations : ITERATIONS) {
-            double[] contextSwitchTimes = new double[numTests];
-            for (int i = 0; i < numTests; i++) {
-                contextSwitchTimes[i] = measureContextSwitchTime(iterations);
-            }
-            int switchSize = removeOutliers(contextSwitchTimes, threshold);
-            if (switchSize > 0) {
-                double average = calculateAverage(contextSwitchTimes, switchSize);
-                double stdDev = calculateStandardDeviation(contextSwitchTimes, average, switchSize);
-                saveResultToArray(contextSwitchResults, average, stdDev, "Context Switch", numTests, switchSize, LANGUAGE, 0, iterations, threshold, "Java_context_switch.json");
-            } else {
-                System.out.println("All context switch times are outliers for iterations: " + iterations);
-            }
+            measurePoint(BenchmarkEngine::measureContextSwitchTime, "Context Switch", 0, iterations, numTests, threshold, contextSwitchResults, "Java_context_switch.json");
         }
     }
 
-    private static void measureThreadMigration(int numTests, double threshold) {
+    private static void measureThreadMigration(int numTests, double threshold) throws InterruptedException {
         BenchmarkEngine performanceMeasurement = new BenchmarkEngine();
+        threadMigrationResults.clear();
         for (int iterations : ITERATIONS) {
-            double[] migrationTimes = new double[numTests];
-            for (int i = 0; i < numTests; i++) {
-                migrationTimes[i] = performanceMeasurement.measureThreadMigrationTime(iterations);
-            }
-            int migrationSize = removeOutliers(migrationTimes, threshold);
-            if (migrationSize > 0) {
-                double average = calculateAverage(migrationTimes, migrationSize);
-                double stdDev = calculateStandardDeviation(migrationTimes, average, migrationSize);
-                saveResultToArray(threadMigrationResults, average, stdDev, "Thread Migration", numTests, migrationSize, LANGUAGE, 0, iterations, threshold, "Java_thread_migration.json");
-            } else {
-                System.out.println("All thread migration times are outliers for iterations: " + iterations);
-            }
+            measurePoint(count -> {
+                double time = performanceMeasurement.measureThreadMigrationTime(count);
+                kernelChecksum = performanceMeasurement.getThreadMigrationChecksum();
+                return time;
+            }, "Thread Migration", 0, iterations, numTests, threshold, threadMigrationResults, "Java_thread_migration.json");
         }
     }
 
@@ -376,10 +533,36 @@ public class BenchmarkEngine {
         measureContextSwitch(numTests, threshold);
         measureThreadMigration(numTests, threshold);
 
-        createCombinedResultsJSON();
+        // Skipped benchmarks still hold the previous run's results.
+        if (!cancelled) {
+            createCombinedResultsJSON();
+        }
+    }
+
+    // Loads kernel_spec.json once and checks that this engine sweeps the same
+    // parameters as the native harnesses.
+    private static boolean loadKernelSpec() {
+        if (kernelSpec != null) {
+            return true;
+        }
+        try {
+            KernelSpec spec = KernelSpec.load();
+            if (!spec.sweepMatches("array_sizes", ARRAY_SIZES) || !spec.sweepMatches("iterations", ITERATIONS)) {
+                System.err.println("ARRAY_SIZES or ITERATIONS differ from the kernel spec");
+                return false;
+            }
+            kernelSpec = spec;
+            return true;
+        } catch (IOException | JSONException e) {
+            System.err.println("Failed to load kernel spec: " + e.getMessage());
+            return false;
+        }
     }
 
     private static void callJavaBenchmark(int benchmarkType, int numTests, double threshold) throws InterruptedException {
+        if (!loadKernelSpec()) {
+            return;
+        }
         switch (benchmarkType) {
             case 0:
                 runAllJavaBenchmarks(numTests, threshold);
@@ -411,6 +594,193 @@ public class BenchmarkEngine {
     }
 
 
+    // Entry point of a forked benchmark JVM: BenchmarkEngine <type> <numTests> <threshold> [language].
+    // With C or C++ as the language it runs the JNI libraries without the GUI,
+    // which the PGO build uses as its training run.
+    public static void main(String[] args) throws InterruptedException {
+        int benchmarkType = Integer.parseInt(args[0]);
+        int numTests = Integer.parseInt(args[1]);
+        double threshold = Double.parseDouble(args[2]);
+        if (args.length > 3 && !args[3].equalsIgnoreCase("java")) {
+            new BenchmarkEngine().runBenchmark(args[3], benchmarkType, numTests, threshold);
+        } else {
+            callJavaBenchmark(benchmarkType, numTests, threshold);
+        }
+    }
+
+    private static String collectorFlag(String collector) {
+        switch (collector.toLowerCase()) {
+            case "g1":
+                return "-XX:+UseG1GC";
+            case "parallel":
+                return "-XX:+UseParallelGC";
+            case "z":
+            case "zgc":
+                return "-XX:+UseZGC";
+            default:
+                throw new IllegalArgumentException("Unsupported garbage collector: " + collector);
+        }
+    }
+
+    private static void forkJavaBenchmark(int benchmarkType, int numTests, double threshold) throws InterruptedException {
+        List<String> command = new ArrayList<>();
+        command.add(Paths.get(System.getProperty("java.home"), "bin", "java").toString());
+        command.add("-Xss512m");
+        if (!FORK_GC.isEmpty()) {
+            command.add(collectorFlag(FORK_GC));
+        }
+        command.add("-Dbenchmark.java.warmup=" + WARMUP_ITERATIONS);
+        command.add("-Djava.library.path=" + System.getProperty("java.library.path"));
+        command.add("-cp");
+        command.add(System.getProperty("java.class.path"));
+        command.add(BenchmarkEngine.class.getName());
+        command.add(String.valueOf(benchmarkType));
+        command.add(String.valueOf(numTests));
+        command.add(String.valueOf(threshold));
+
+        try {
+            Process process = new ProcessBuilder(command).inheritIO().start();
+            while (!process.waitFor(100, TimeUnit.MILLISECONDS)) {
+                if (cancelled) {
+                    process.destroy();
+                }
+            }
+            int exitCode = process.exitValue();
+            if (exitCode != 0 && !cancelled) {
+                System.err.println("Forked Java benchmark " + benchmarkType + " exited with code " + exitCode);
+            }
+        } catch (IOException e) {
+            System.err.println("Could not fork a JVM for benchmark " + benchmarkType + ": " + e.getMessage());
+        }
+    }
+
+    // One fresh JVM per benchmark, so earlier benchmarks and the GUI do not
+    // leave JIT or heap state behind.
+    private static void runForkedJavaBenchmark(int benchmarkType, int numTests, double threshold) throws InterruptedException {
+        if (benchmarkType < 0 || benchmarkType > 7) {
+            System.out.println("Invalid benchmark type");
+            return;
+        }
+        int first = benchmarkType == 0 ? 1 : benchmarkType;
+        int last = benchmarkType == 0 ? 7 : benchmarkType;
+        for (int type = first; type <= last && !cancelled; type++) {
+            forkJavaBenchmark(type, numTests, threshold);
+        }
+        if (benchmarkType == 0 && !cancelled) {
+            createCombinedResultsJSON();
+        }
+    }
+
+    // Streams C++ and Java results to the listener as they are produced; C
+    // results, and Java results from forked JVMs, are loaded from their files.
+    public void setResultListener(ResultListener listener) {
+        resultListener = listener;
+        jni.setNative_Cpp_ResultListener(listener);
+    }
+
+    public boolean streamsResults(String language) {
+        return resultListener != null && (language.equalsIgnoreCase("c++") || (language.equalsIgnoreCase("java") && !FORK_JVM));
+    }
+
+    // Clears a previous cancel. Called when a run is queued rather than when a
+    // benchmark starts, so a cancel that arrives in between is not lost.
+    public void prepareRun() {
+        cancelled = false;
+        jni.prepareNative_C_Benchmark();
+        jni.prepareNative_Cpp_Benchmark();
+    }
+
+    // Stops the running benchmark or warm-up of any language after its current
+    // sample; a forked Java benchmark is killed. Points that already finished
+    // are kept and benchmarks that never started keep their previous files.
+    public void cancelBenchmark() {
+        cancelled = true;
+        jni.cancelNative_C_Benchmark();
+        jni.cancelNative_Cpp_Benchmark();
+    }
+
+    public int[] getNativeProgress() {
+        int[] progress = new int[5];
+        jni.getNative_Cpp_Progress(progress);
+        return progress;
+    }
+
+    // Same rounds as warmUpRound in the native libraries, so the JIT compiles
+    // the kernels before they are measured.
+    private double warmUpRound(int benchmarkType) throws InterruptedException {
+        switch (benchmarkType) {
+            case 1:
+                return measureStaticMemoryAccess(10000);
+            case 2:
+                return measureDynamicMemoryAccess(10000);
+            case 3:
+                return measureMemoryAllocation(10000);
+            case 4:
+                return measureMemoryDeallocation(10000);
+            case 5:
+                return measureThreadCreationTime(10);
+            case 6:
+                return measureContextSwitchTime(100);
+            case 7:
+                return measureThreadMigrationTime(2);
+            default:
+                return 0.0;
+        }
+    }
+
+    // Runs rounds until the mean of the last WARMUP_WINDOW rounds is within
+    // WARMUP_TOLERANCE of the window before it.
+    private int warmUpJavaBenchmark(int benchmarkType) throws InterruptedException {
+        double[] rounds = new double[2 * WARMUP_WINDOW];
+        int round = 0;
+        while (round < WARMUP_MAX_ROUNDS && !cancelled) {
+            rounds[round % rounds.length] = warmUpRound(benchmarkType);
+            round++;
+            if (round >= rounds.length) {
+                double previous = 0.0;
+                double current = 0.0;
+                for (int i = 0; i < WARMUP_WINDOW; i++) {
+                    previous += rounds[(round + i) % rounds.length];
+                    current += rounds[(round + WARMUP_WINDOW + i) % rounds.length];
+                }
+                if (Math.abs(current - previous) <= WARMUP_TOLERANCE * previous) {
+                    break;
+                }
+            }
+        }
+        return round;
+    }
+
+    private int warmUpJava(int benchmarkType) throws InterruptedException {
+        // JNI overhead and false sharing have no Java version to warm up.
+        if (benchmarkType > 7) {
+            return 0;
+        }
+        if (benchmarkType != 0) {
+            return warmUpJavaBenchmark(benchmarkType);
+        }
+        int rounds = 0;
+        for (int type = 1; type <= 7; type++) {
+            rounds += warmUpJavaBenchmark(type);
+        }
+        return rounds;
+    }
+
+    // Warms up only the benchmark about to run and returns the rounds it took.
+    public int warmUp(String language, int benchmarkType) throws InterruptedException {
+        switch (language.toLowerCase()) {
+            case "c":
+                return jni.warmUpNative_C_Benchmark(benchmarkType, WARMUP_MAX_ROUNDS, WARMUP_TOLERANCE);
+            case "c++":
+                return jni.warmUpNative_Cpp_Benchmark(benchmarkType, WARMUP_MAX_ROUNDS, WARMUP_TOLERANCE);
+            case "java":
+                // A forked JVM warms itself up; warming this one would not help it.
+                return FORK_JVM ? 0 : warmUpJava(benchmarkType);
+            default:
+                throw new IllegalArgumentException("Unsupported language: " + language);
+        }
+    }
+
     public void runBenchmark(String language, int benchmarkType, int numTests, double threshold) throws InterruptedException {
         switch (language.toLowerCase()) {
             case "c":
@@ -420,7 +790,11 @@ public class BenchmarkEngine {
                 jni.callNative_Cpp_Benchmark(benchmarkType, numTests, threshold);
                 break;
             case "java":
-                callJavaBenchmark(benchmarkType, numTests, threshold);
+                if (FORK_JVM) {
+                    runForkedJavaBenchmark(benchmarkType, numTests, threshold);
+                } else {
+                    callJavaBenchmark(benchmarkType, numTests, threshold);
+                }
                 break;
             default:
                 throw new IllegalArgumentException("Unsupported language: " + language);
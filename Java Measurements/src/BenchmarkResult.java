@@ -8,10 +8,23 @@ public class BenchmarkResult {
     private final String processMeasured;
     private final double averageTime;
     private final double stdDeviation;
+    private final double gcTime;
+    private final long checksum;
+    private final String compiler;
 
     // Constructor
     public BenchmarkResult(int arraySize, int iterations,int numberOfTests, int passedTests, int outlierThreshold,
                            String programmingLanguage, String processMeasured, double averageTime, double stdDeviation) {
+        this(arraySize, iterations, numberOfTests, passedTests, outlierThreshold, programmingLanguage, processMeasured, averageTime, stdDeviation, 0.0, -1, "");
+    }
+
+    // gcTime is the garbage collector time per operation that was left out
+    // of averageTime; only the Java engine reports it. checksum is the kernel
+    // spec checksum of the point, or -1 if the result has none. compiler is
+    // the toolchain that built the kernels, or empty if the result predates it.
+    public BenchmarkResult(int arraySize, int iterations, int numberOfTests, int passedTests, int outlierThreshold,
+                           String programmingLanguage, String processMeasured, double averageTime, double stdDeviation, double gcTime, long checksum,
+                           String compiler) {
         this.arraySize = arraySize;
         this.iterations = iterations;
         this.numberOfTests = numberOfTests;
@@ -21,6 +34,9 @@ public class BenchmarkResult {
         this.processMeasured = processMeasured;
         this.averageTime = averageTime;
         this.stdDeviation = stdDeviation;
+        this.gcTime = gcTime;
+        this.checksum = checksum;
+        this.compiler = compiler;
     }
 
     // Getters
@@ -60,6 +76,18 @@ public class BenchmarkResult {
         return stdDeviation;
     }
 
+    public double getGcTime() {
+        return gcTime;
+    }
+
+    public long getChecksum() {
+        return checksum;
+    }
+
+    public String getCompiler() {
+        return compiler;
+    }
+
     @Override
     public String toString() {
         return "BenchmarkResult{" +
@@ -72,6 +100,9 @@ public class BenchmarkResult {
                 ", processMeasured='" + processMeasured + '\'' +
                 ", averageTime=" + averageTime +
                 ", stdDeviation=" + stdDeviation +
+                ", gcTime=" + gcTime +
+                ", checksum=" + checksum +
+                ", compiler='" + compiler + '\'' +
                 '}';
     }
 }
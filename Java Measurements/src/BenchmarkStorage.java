@@ -5,14 +5,18 @@ import java.io.File;
 import java.io.IOException;
 import java.nio.file.Files;
 import java.nio.file.Paths;
-import java.util.ArrayList;
 import java.util.List;
+import java.util.concurrent.CopyOnWriteArrayList;
 
 public class BenchmarkStorage {
     private final List<BenchmarkResult> results;
 
     public BenchmarkStorage() {
-        this.results = new ArrayList<>();
+        this.results = new CopyOnWriteArrayList<>();
+    }
+
+    public void addResult(BenchmarkResult result) {
+        results.add(result);
     }
 
     public void loadFromJsonFile(String filePath) {
@@ -33,7 +37,10 @@ public class BenchmarkStorage {
                         obj.getString("programming_language"),
                         obj.getString("process_measured"),
                         obj.getDouble("average_time"),
-                        obj.getDouble("std_deviation")
+                        obj.getDouble("std_deviation"),
+                        obj.optDouble("gc_time", 0.0),
+                        obj.optLong("checksum", -1),
+                        obj.optString("compiler", "")
                 );
 
                 results.add(result);
@@ -44,6 +51,15 @@ public class BenchmarkStorage {
         }
     }
 
+    public void loadFromBinaryFile(String filePath) {
+        try {
+            BinaryResultReader reader = new BinaryResultReader(filePath);
+            results.addAll(reader.readAll());
+        } catch (IOException e) {
+            System.err.println("Error reading binary result file: " + e.getMessage());
+        }
+    }
+
     public List<BenchmarkResult> getResults() {
         return results;
     }
@@ -0,0 +1,141 @@
+import java.io.IOException;
+import java.nio.ByteOrder;
+import java.nio.MappedByteBuffer;
+import java.nio.channels.FileChannel;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Paths;
+import java.nio.file.StandardOpenOption;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+
+// Reads the columnar result files written by writeBinaryResults in C++_native_code.cpp.
+// The file is mapped once and every column is read in place.
+public class BinaryResultReader {
+    private static final byte[] MAGIC = {'C', 'L', 'P', 'B', 'R', 'E', 'S', 0};
+    private static final int VERSION = 1;
+    private static final int HEADER_SIZE = 64;
+    private static final int DESCRIPTOR_SIZE = 48;
+    private static final int NAME_LENGTH = 24;
+
+    private static final int COLUMN_I32 = 1;
+    private static final int COLUMN_I64 = 2;
+    private static final int COLUMN_F64 = 3;
+    private static final int COLUMN_STR = 4;
+
+    private static class Column {
+        final int type;
+        final int offset;
+        final long length;
+
+        Column(int type, int offset, long length) {
+            this.type = type;
+            this.offset = offset;
+            this.length = length;
+        }
+    }
+
+    private final MappedByteBuffer buffer;
+    private final Map<String, Column> columns = new HashMap<>();
+    private final int rowCount;
+    private final int stringTableOffset;
+
+    public BinaryResultReader(String filePath) throws IOException {
+        try (FileChannel channel = FileChannel.open(Paths.get(filePath), StandardOpenOption.READ)) {
+            buffer = channel.map(FileChannel.MapMode.READ_ONLY, 0, channel.size());
+        }
+        buffer.order(ByteOrder.LITTLE_ENDIAN);
+
+        if (buffer.capacity() < HEADER_SIZE) {
+            throw new IOException("Truncated result file: " + filePath);
+        }
+        for (int i = 0; i < MAGIC.length; i++) {
+            if (buffer.get(i) != MAGIC[i]) {
+                throw new IOException("Not a binary result file: " + filePath);
+            }
+        }
+        int version = buffer.getInt(8);
+        if (version != VERSION) {
+            throw new IOException("Unsupported result file version " + version + ": " + filePath);
+        }
+        int headerSize = buffer.getInt(12);
+        int columnCount = buffer.getInt(16);
+        rowCount = (int) buffer.getLong(24);
+        stringTableOffset = (int) buffer.getLong(40);
+
+        for (int i = 0; i < columnCount; i++) {
+            int base = headerSize + i * DESCRIPTOR_SIZE;
+            byte[] nameBytes = new byte[NAME_LENGTH];
+            int nameLength = 0;
+            while (nameLength < NAME_LENGTH && buffer.get(base + nameLength) != 0) {
+                nameBytes[nameLength] = buffer.get(base + nameLength);
+                nameLength++;
+            }
+            String name = new String(nameBytes, 0, nameLength, StandardCharsets.US_ASCII);
+            int type = buffer.getShort(base + NAME_LENGTH) & 0xFFFF;
+            int offset = (int) buffer.getLong(base + 32);
+            long length = buffer.getLong(base + 40);
+            columns.put(name, new Column(type, offset, length));
+        }
+    }
+
+    public int getRowCount() {
+        return rowCount;
+    }
+
+    public BenchmarkResult getResult(int row) {
+        return new BenchmarkResult(
+                getInt("array_size", row),
+                getInt("iterations", row),
+                getInt("number_of_tests", row),
+                getInt("passed_tests", row),
+                (int) getDouble("outlier_threshold", row),
+                getString("programming_language", row),
+                getString("process_measured", row),
+                getDouble("average_time", row),
+                getDouble("std_deviation", row),
+                0.0,
+                columns.containsKey("checksum") ? getLong("checksum", row) : -1,
+                columns.containsKey("compiler") ? getString("compiler", row) : ""
+        );
+    }
+
+    public List<BenchmarkResult> readAll() {
+        List<BenchmarkResult> results = new ArrayList<>(rowCount);
+        for (int row = 0; row < rowCount; row++) {
+            results.add(getResult(row));
+        }
+        return results;
+    }
+
+    private Column column(String name, int expectedType) {
+        Column column = columns.get(name);
+        if (column == null || column.type != expectedType) {
+            throw new IllegalStateException("Missing or mistyped column: " + name);
+        }
+        return column;
+    }
+
+    private int getInt(String name, int row) {
+        return buffer.getInt(column(name, COLUMN_I32).offset + row * Integer.BYTES);
+    }
+
+    private long getLong(String name, int row) {
+        return buffer.getLong(column(name, COLUMN_I64).offset + row * Long.BYTES);
+    }
+
+    private double getDouble(String name, int row) {
+        return buffer.getDouble(column(name, COLUMN_F64).offset + row * Double.BYTES);
+    }
+
+    private String getString(String name, int row) {
+        int entry = stringTableOffset + buffer.getInt(column(name, COLUMN_STR).offset + row * Integer.BYTES);
+        int length = buffer.getShort(entry) & 0xFFFF;
+        byte[] bytes = new byte[length];
+        for (int i = 0; i < length; i++) {
+            bytes[i] = buffer.get(entry + 2 + i);
+        }
+        return new String(bytes, StandardCharsets.UTF_8);
+    }
+}
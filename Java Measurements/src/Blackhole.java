@@ -0,0 +1,39 @@
+// Consumes benchmark results so the JIT cannot prove them unused and drop the
+// work that produced them. Same trick as JMH: compare against two volatile
+// fields that are never equal, so the store below never actually happens.
+public final class Blackhole {
+    private volatile int int1 = 1;
+    private volatile int int2 = 2;
+    private volatile long long1 = 1;
+    private volatile long long2 = 2;
+    private volatile double double1 = 1.0;
+    private volatile double double2 = 2.0;
+    private volatile Object sink;
+    private int objectCount;
+
+    public void consume(int value) {
+        if ((value ^ int1) == (value ^ int2)) {
+            sink = value;
+        }
+    }
+
+    public void consume(long value) {
+        if ((value ^ long1) == (value ^ long2)) {
+            sink = value;
+        }
+    }
+
+    public void consume(double value) {
+        if (value == double1 && value == double2) {
+            sink = value;
+        }
+    }
+
+    // Objects are published on a path the JIT cannot rule out, so escape
+    // analysis cannot remove their allocation.
+    public void consume(Object value) {
+        if ((++objectCount & 0x7FFFFFFF) == 0) {
+            sink = value;
+        }
+    }
+}
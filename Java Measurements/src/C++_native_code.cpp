@@ -1,6 +1,7 @@
 #include <chrono>
 #include <iostream>
 #include <numeric>
+#include <iterator>
 #include <cmath>
 #include <iomanip>
 #include <algorithm>
@@ -13,43 +14,135 @@
 #include <nlohmann/json.hpp>
 #include <fstream>
 #include <filesystem>
+#include <map>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #include "JNInterface.h"
+#include "../../C++ measurements/measure_common.h"
 using ordered_json = nlohmann::ordered_json;
 
 const int NUM_TESTS = 100;
 const std::vector<int> ARRAY_SIZES = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
 const std::vector<int> ITERATIONS = {2, 10, 100, 1000, 10000};
 
-double calculateAverage(const std::vector<double> &times)
+#ifndef KERNEL_SPEC_PATH
+#define KERNEL_SPEC_PATH "../../kernel_spec.json"
+#endif
+
+// Build stamp written into every result. The CMake build defines
+// BENCH_PROFILE and BENCH_CFLAGS; other builds fall back to "unspecified".
+#ifndef BENCH_PROFILE
+#define BENCH_PROFILE "unspecified"
+#endif
+#ifndef BENCH_CFLAGS
+#define BENCH_CFLAGS "unspecified"
+#endif
+#if defined(__clang__)
+#define BENCH_COMPILER "clang " __clang_version__
+#elif defined(__GNUC__)
+#define BENCH_COMPILER "gcc " __VERSION__
+#else
+#define BENCH_COMPILER "unknown"
+#endif
+
+// Checksum of the last kernel call. Every sample is compared with the value
+// kernel_spec.json expects for its point, so C, C++ and Java results can only
+// be compared when they provably ran the same workload.
+const uint64_t NO_CHECKSUM = UINT64_MAX;
+uint64_t kernelChecksum = 0;
+ordered_json kernelSpec;
+
+// Loads the spec once; KERNEL_SPEC in the environment overrides its path.
+// Returns false if it is missing or this harness sweeps different parameters.
+bool loadKernelSpec()
 {
-    return std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    if (!kernelSpec.is_null())
+        return true;
+    const char *path = std::getenv("KERNEL_SPEC");
+    if (path == nullptr)
+        path = KERNEL_SPEC_PATH;
+
+    std::ifstream file(path);
+    ordered_json spec = ordered_json::parse(file, nullptr, false);
+    if (!file.is_open() || spec.is_discarded() || !spec.contains("kernels"))
+    {
+        std::cerr << "Failed to load kernel spec " << path << std::endl;
+        return false;
+    }
+    if (spec["array_sizes"] != ordered_json(ARRAY_SIZES) || spec["iterations"] != ordered_json(ITERATIONS))
+    {
+        std::cerr << "ARRAY_SIZES or ITERATIONS differ from kernel spec " << path << std::endl;
+        return false;
+    }
+    kernelSpec = std::move(spec);
+    return true;
 }
 
-double calculateStandardDeviation(const std::vector<double> &times, double mean)
+uint64_t expectedChecksum(const std::string &process, int parameter)
 {
-    double variance = 0.0;
-    for (const auto &time : times)
+    for (const auto &kernel : kernelSpec["kernels"])
     {
-        variance += (time - mean) * (time - mean);
+        if (kernel.value("process", "") != process)
+            continue;
+        const auto &sweep = kernelSpec[kernel.value("parameter", "") == "array_size" ? "array_sizes" : "iterations"];
+        for (size_t point = 0; point < sweep.size() && point < kernel["expected"].size(); ++point)
+        {
+            if (sweep[point] == parameter)
+                return kernel["expected"][point].get<uint64_t>();
+        }
     }
-    return std::sqrt(variance / times.size());
+    return NO_CHECKSUM;
 }
+const int WARMUP_WINDOW = 5;
 
-void removeOutliers(std::vector<double> &times, double threshold)
+enum OutputFormat
 {
-    double mean = calculateAverage(times);
-    double stdDev = calculateStandardDeviation(times, mean);
+    OUTPUT_JSON = 1,
+    OUTPUT_BINARY = 2
+};
 
-    double lowerThreshold = mean - threshold * stdDev;
-    double upperThreshold = mean + threshold * stdDev;
+int outputFormat = OUTPUT_BINARY;
+
+struct BenchmarkRecord
+{
+    int arraySize;
+    int iterations;
+    int numTests;
+    int passedTests;
+    double threshold;
+    std::string language;
+    std::string process;
+    double average;
+    double stdDev;
+    std::vector<double> samples;
+    uint64_t checksum;
+    bool checksumValid;
+};
+
+std::map<std::string, std::vector<BenchmarkRecord>> binaryResults;
+
+// A finished sweep point as queued by a driver. It refers to string literals
+// and to its segment of the sample arena, so queuing it never allocates.
+struct PendingResult
+{
+    int arraySize;
+    int iterations;
+    int numTests;
+    double threshold;
+    const char *language;
+    const char *process;
+    double average;
+    double stdDev;
+    const double *samples;
+    size_t sampleCount;
+    uint64_t checksum;
+    int checksumMismatches;
+};
 
-    times.erase(std::remove_if(times.begin(), times.end(),
-                               [lowerThreshold, upperThreshold](double time)
-                               {
-                                   return time < lowerThreshold || time > upperThreshold;
-                               }),
-                times.end());
-}
 double measureStaticMemoryAccess(int size)
 {
     int staticArray[size];
@@ -59,12 +152,13 @@ double measureStaticMemoryAccess(int size)
     }
 
     auto start = std::chrono::high_resolution_clock::now();
-    int sum = 0;
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
         sum += staticArray[i];
     }
     auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = sum;
     double time = std::chrono::duration<double, std::nano>(end - start).count();
     return time / size;
 }
@@ -83,12 +177,13 @@ double measureDynamicMemoryAccess(int size)
     }
 
     auto start = std::chrono::high_resolution_clock::now();
-    int sum = 0;
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
         sum += dynamicArray[i];
     }
     auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = sum;
 
     delete[] dynamicArray;
     double time = std::chrono::duration<double, std::nano>(end - start).count();
@@ -110,10 +205,14 @@ double measureMemoryAllocation(int size)
     }
     auto end = std::chrono::high_resolution_clock::now();
 
+    uint64_t sum = 0;
     for (int i = 0; i < size; ++i)
     {
+        *chunks[i] = i;
+        sum += *chunks[i];
         delete chunks[i];
     }
+    kernelChecksum = sum;
     double time = std::chrono::duration<double, std::nano>(end - start).count();
     return time / size;
 }
@@ -122,15 +221,18 @@ double measureMemoryDeallocation(int size)
 {
     std::vector<int *> chunks(size);
 
+    uint64_t sum = 0;
     for (int i = 0; i < size; ++i)
     {
-        chunks[i] = new int;
+        chunks[i] = new int(i);
         if (chunks[i] == nullptr)
         {
             std::cerr << "Failed to allocate memory for a chunk" << std::endl;
             exit(EXIT_FAILURE);
         }
+        sum += *chunks[i];
     }
+    kernelChecksum = sum;
 
     auto start = std::chrono::high_resolution_clock::now();
     for (int i = 0; i < size; ++i)
@@ -143,61 +245,34 @@ double measureMemoryDeallocation(int size)
     return time / size;
 }
 
-void CreateThreadFunction()
+void CreateThreadFunction(uint64_t &result)
 {
     volatile int sum = 0;
     for (int i = 0; i < 1000; ++i)
     {
-        sum += i;
+        sum = sum + i;
     }
+    result = sum;
 }
 
 double measureThreadCreationTime(int iterations)
 {
+    uint64_t checksum = 0;
     auto start = std::chrono::high_resolution_clock::now();
     for (int i = 0; i < iterations; ++i)
     {
-        std::thread t(CreateThreadFunction);
+        uint64_t result = 0;
+        std::thread t(CreateThreadFunction, std::ref(result));
         t.join();
+        checksum += result;
     }
     auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = checksum;
 
     double time = std::chrono::duration<double, std::nano>(end - start).count();
     return time / iterations;
 }
 
-double measureContextSwitchTime(int iterations)
-{
-    std::mutex mtx;
-    std::condition_variable cv;
-    bool turn = true;
-
-    auto threadFunc = [&](bool myTurn)
-    {
-        for (int i = 0; i < iterations / 2; ++i)
-        {
-            std::unique_lock<std::mutex> lock(mtx);
-            cv.wait(lock, [&]
-                    { return turn == myTurn; });
-            turn = !myTurn;
-            lock.unlock();
-            cv.notify_one();
-        }
-    };
-
-    auto start = std::chrono::high_resolution_clock::now();
-
-    std::thread t1(threadFunc, true);
-    std::thread t2(threadFunc, false);
-
-    t1.join();
-    t2.join();
-
-    auto end = std::chrono::high_resolution_clock::now();
-    double time = std::chrono::duration<double, std::nano>(end - start).count();
-    return time / iterations;
-}
-
 double measureThreadMigrationTime(int iterations)
 {
     cpu_set_t cpuset;
@@ -208,7 +283,7 @@ double measureThreadMigrationTime(int iterations)
         volatile int sum = 0;
         for (int i = 0; i < 1000; ++i)
         {
-            sum += i;
+            sum = sum + i;
         }
     };
 
@@ -222,12 +297,14 @@ double measureThreadMigrationTime(int iterations)
         //exit(EXIT_FAILURE);
     }
 
+    uint64_t migrations = 0;
     auto start = std::chrono::high_resolution_clock::now();
     for (int i = 0; i < iterations; ++i)
     {
         CPU_ZERO(&cpuset);
         CPU_SET(i % 2, &cpuset);
         rc = pthread_setaffinity_np(t.native_handle(), sizeof(cpu_set_t), &cpuset);
+        migrations += rc == 0;
         if (rc != 0)
         {
             perror("Error setting thread affinity in iteration");
@@ -235,6 +312,7 @@ double measureThreadMigrationTime(int iterations)
         }
     }
     auto end = std::chrono::high_resolution_clock::now();
+    kernelChecksum = migrations;
 
     t.join();
 
@@ -250,7 +328,7 @@ void ensureDirectoryExists(const std::string &folderName)
     }
 }
 
-void saveResultsToJSON(const std::string &filename, double average, double stdDev, const std::string &process, int numTests, int passedTests, const std::string &language, int arraySize, double threshold, int iterations)
+void saveResultsToJSON(const std::string &filename, double average, double stdDev, const std::string &process, int numTests, int passedTests, const std::string &language, int arraySize, double threshold, int iterations, uint64_t checksum, bool checksumValid)
 {
     const std::string folderName = "C++_measurements";
     ensureDirectoryExists(folderName);
@@ -281,6 +359,14 @@ void saveResultsToJSON(const std::string &filename, double average, double stdDe
     result["process_measured"] = process;
     result["average_time"] = average;
     result["std_deviation"] = stdDev;
+    if (checksum != NO_CHECKSUM)
+    {
+        result["checksum"] = checksum;
+        result["checksum_valid"] = checksumValid;
+    }
+    result["compiler"] = BENCH_COMPILER;
+    result["compiler_flags"] = BENCH_CFLAGS;
+    result["build_profile"] = BENCH_PROFILE;
 
     json.push_back(result);
 
@@ -331,20 +417,481 @@ void combineJSONFiles(const std::vector<std::string> &filenames, const std::stri
     }
 }
 
+// Columnar result file: a fixed header, one descriptor per column, then each
+// column as a contiguous little-endian array. Rows are result records; the
+// "samples" column holds the passed samples of every row back to back, and
+// sample_offset/sample_count index into it. BinaryResultReader.java mirrors
+// this layout.
+const char BINARY_MAGIC[8] = {'C', 'L', 'P', 'B', 'R', 'E', 'S', '\0'};
+const uint32_t BINARY_VERSION = 1;
+
+enum ColumnType : uint16_t
+{
+    COLUMN_I32 = 1,
+    COLUMN_I64 = 2,
+    COLUMN_F64 = 3,
+    COLUMN_STR = 4
+};
+
+struct BinaryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint32_t columnCount;
+    uint32_t reserved;
+    uint64_t rowCount;
+    uint64_t sampleCount;
+    uint64_t stringTableOffset;
+    uint64_t stringTableSize;
+    uint64_t reserved2;
+};
+
+struct ColumnDescriptor
+{
+    char name[24];
+    uint16_t type;
+    uint16_t width;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t length;
+};
+
+static_assert(sizeof(BinaryHeader) == 64, "BinaryHeader layout changed");
+static_assert(sizeof(ColumnDescriptor) == 48, "ColumnDescriptor layout changed");
+
+uint64_t alignTo8(uint64_t value)
+{
+    return (value + 7) & ~uint64_t(7);
+}
+
+void writeBinaryResults(const std::string &filename, const std::vector<BenchmarkRecord> &records)
+{
+    const std::string folderName = "C++_measurements";
+    ensureDirectoryExists(folderName);
+
+    std::string fullPath = folderName + "/" + filename;
+
+    // String table: u16 length followed by the bytes, deduplicated.
+    std::string stringTable;
+    std::map<std::string, uint32_t> stringOffsets;
+    auto internString = [&](const std::string &value)
+    {
+        auto it = stringOffsets.find(value);
+        if (it != stringOffsets.end())
+            return it->second;
+        uint32_t offset = stringTable.size();
+        uint16_t length = value.size();
+        stringTable.append(reinterpret_cast<const char *>(&length), sizeof(length));
+        stringTable.append(value);
+        stringOffsets[value] = offset;
+        return offset;
+    };
+
+    uint64_t rowCount = records.size();
+    uint64_t sampleCount = 0;
+    for (const auto &record : records)
+    {
+        sampleCount += record.samples.size();
+    }
+
+    std::vector<ColumnDescriptor> columns;
+    auto addColumn = [&](const char *name, ColumnType type, uint16_t width, uint64_t length)
+    {
+        ColumnDescriptor column = {};
+        std::strncpy(column.name, name, sizeof(column.name) - 1);
+        column.type = type;
+        column.width = width;
+        column.length = length;
+        columns.push_back(column);
+    };
+
+    addColumn("array_size", COLUMN_I32, 4, rowCount);
+    addColumn("iterations", COLUMN_I32, 4, rowCount);
+    addColumn("number_of_tests", COLUMN_I32, 4, rowCount);
+    addColumn("passed_tests", COLUMN_I32, 4, rowCount);
+    addColumn("outlier_threshold", COLUMN_F64, 8, rowCount);
+    addColumn("programming_language", COLUMN_STR, 4, rowCount);
+    addColumn("process_measured", COLUMN_STR, 4, rowCount);
+    addColumn("average_time", COLUMN_F64, 8, rowCount);
+    addColumn("std_deviation", COLUMN_F64, 8, rowCount);
+    addColumn("sample_offset", COLUMN_I64, 8, rowCount);
+    addColumn("sample_count", COLUMN_I64, 8, rowCount);
+    addColumn("samples", COLUMN_F64, 8, sampleCount);
+    addColumn("checksum", COLUMN_I64, 8, rowCount);
+    addColumn("checksum_valid", COLUMN_I32, 4, rowCount);
+    addColumn("compiler", COLUMN_STR, 4, rowCount);
+    addColumn("compiler_flags", COLUMN_STR, 4, rowCount);
+    addColumn("build_profile", COLUMN_STR, 4, rowCount);
+
+    uint64_t offset = sizeof(BinaryHeader) + columns.size() * sizeof(ColumnDescriptor);
+    for (auto &column : columns)
+    {
+        offset = alignTo8(offset);
+        column.offset = offset;
+        offset += column.width * column.length;
+    }
+
+    std::vector<uint32_t> languageIds, processIds;
+    for (const auto &record : records)
+    {
+        languageIds.push_back(internString(record.language));
+        processIds.push_back(internString(record.process));
+    }
+    uint32_t compilerId = internString(BENCH_COMPILER);
+    uint32_t flagsId = internString(BENCH_CFLAGS);
+    uint32_t profileId = internString(BENCH_PROFILE);
+
+    uint64_t stringTableOffset = alignTo8(offset);
+    uint64_t totalSize = stringTableOffset + stringTable.size();
+
+    int fd = open(fullPath.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        perror("Failed to open binary results file");
+        return;
+    }
+    if (ftruncate(fd, totalSize) != 0)
+    {
+        perror("Failed to size binary results file");
+        close(fd);
+        return;
+    }
+    char *base = static_cast<char *>(mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    if (base == MAP_FAILED)
+    {
+        perror("Failed to map binary results file");
+        close(fd);
+        return;
+    }
+
+    BinaryHeader header = {};
+    std::memcpy(header.magic, BINARY_MAGIC, sizeof(header.magic));
+    header.version = BINARY_VERSION;
+    header.headerSize = sizeof(BinaryHeader);
+    header.columnCount = columns.size();
+    header.rowCount = rowCount;
+    header.sampleCount = sampleCount;
+    header.stringTableOffset = stringTableOffset;
+    header.stringTableSize = stringTable.size();
+    std::memcpy(base, &header, sizeof(header));
+    std::memcpy(base + sizeof(header), columns.data(), columns.size() * sizeof(ColumnDescriptor));
+
+    auto column = [&](int index)
+    { return base + columns[index].offset; };
+    int32_t *arraySizes = reinterpret_cast<int32_t *>(column(0));
+    int32_t *iterations = reinterpret_cast<int32_t *>(column(1));
+    int32_t *numTests = reinterpret_cast<int32_t *>(column(2));
+    int32_t *passedTests = reinterpret_cast<int32_t *>(column(3));
+    double *thresholds = reinterpret_cast<double *>(column(4));
+    uint32_t *languages = reinterpret_cast<uint32_t *>(column(5));
+    uint32_t *processes = reinterpret_cast<uint32_t *>(column(6));
+    double *averages = reinterpret_cast<double *>(column(7));
+    double *stdDevs = reinterpret_cast<double *>(column(8));
+    int64_t *sampleOffsets = reinterpret_cast<int64_t *>(column(9));
+    int64_t *sampleCounts = reinterpret_cast<int64_t *>(column(10));
+    double *samples = reinterpret_cast<double *>(column(11));
+    int64_t *checksums = reinterpret_cast<int64_t *>(column(12));
+    int32_t *checksumValid = reinterpret_cast<int32_t *>(column(13));
+    uint32_t *compilers = reinterpret_cast<uint32_t *>(column(14));
+    uint32_t *flags = reinterpret_cast<uint32_t *>(column(15));
+    uint32_t *profiles = reinterpret_cast<uint32_t *>(column(16));
+
+    int64_t sampleIndex = 0;
+    for (size_t row = 0; row < records.size(); ++row)
+    {
+        const BenchmarkRecord &record = records[row];
+        arraySizes[row] = record.arraySize;
+        iterations[row] = record.iterations;
+        numTests[row] = record.numTests;
+        passedTests[row] = record.passedTests;
+        thresholds[row] = record.threshold;
+        languages[row] = languageIds[row];
+        processes[row] = processIds[row];
+        averages[row] = record.average;
+        stdDevs[row] = record.stdDev;
+        sampleOffsets[row] = sampleIndex;
+        sampleCounts[row] = record.samples.size();
+        checksums[row] = static_cast<int64_t>(record.checksum);
+        checksumValid[row] = record.checksumValid;
+        compilers[row] = compilerId;
+        flags[row] = flagsId;
+        profiles[row] = profileId;
+        std::memcpy(samples + sampleIndex, record.samples.data(), record.samples.size() * sizeof(double));
+        sampleIndex += record.samples.size();
+    }
+    std::memcpy(base + stringTableOffset, stringTable.data(), stringTable.size());
+
+    munmap(base, totalSize);
+    close(fd);
+}
+
+void writeReset(const std::string &name)
+{
+    const std::string folderName = "C++_measurements";
+    ensureDirectoryExists(folderName);
+
+    // Drop the output of the format we are not writing so the Java side never
+    // picks up a stale file from an earlier run.
+    if (outputFormat & OUTPUT_JSON)
+        std::ofstream(folderName + "/" + name + ".json") << "[]";
+    else
+        std::filesystem::remove(folderName + "/" + name + ".json");
+    std::filesystem::remove(folderName + "/" + name + ".bin");
+
+    binaryResults[name].clear();
+}
+
+// Java listener that receives every saved result, registered through
+// setNative_Cpp_ResultListener. Only the writer thread calls into it; it
+// attaches to the JVM while it has results to hand over and detaches when idle.
+struct ResultChannel
+{
+    JavaVM *vm = nullptr;
+    jobject listener = nullptr;
+    jmethodID onResult = nullptr;
+    jclass resultClass = nullptr;
+    jmethodID resultConstructor = nullptr;
+    JNIEnv *writerEnv = nullptr;
+};
+
+ResultChannel resultChannel;
+
+void publishResult(const PendingResult &result)
+{
+    if (resultChannel.listener == nullptr)
+        return;
+    if (resultChannel.writerEnv == nullptr &&
+        resultChannel.vm->AttachCurrentThreadAsDaemon(reinterpret_cast<void **>(&resultChannel.writerEnv), nullptr) != JNI_OK)
+    {
+        resultChannel.writerEnv = nullptr;
+        return;
+    }
+
+    JNIEnv *env = resultChannel.writerEnv;
+    jstring language = env->NewStringUTF(result.language);
+    jstring process = env->NewStringUTF(result.process);
+    jstring compiler = env->NewStringUTF(BENCH_COMPILER);
+    jobject record = env->NewObject(resultChannel.resultClass, resultChannel.resultConstructor,
+                                    result.arraySize, result.iterations, result.numTests, static_cast<jint>(result.sampleCount),
+                                    static_cast<jint>(result.threshold), language, process, result.average, result.stdDev,
+                                    0.0, static_cast<jlong>(result.checksum), compiler);
+    if (record != nullptr)
+        env->CallVoidMethod(resultChannel.listener, resultChannel.onResult, record);
+    if (env->ExceptionCheck())
+    {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+    }
+    env->DeleteLocalRef(record);
+    env->DeleteLocalRef(compiler);
+    env->DeleteLocalRef(process);
+    env->DeleteLocalRef(language);
+}
+
+void detachResultChannel()
+{
+    if (resultChannel.writerEnv != nullptr)
+    {
+        resultChannel.vm->DetachCurrentThread();
+        resultChannel.writerEnv = nullptr;
+    }
+}
+
+void writeRecord(const std::string &name, const PendingResult &result)
+{
+    publishResult(result);
+    int passedTests = result.sampleCount;
+    bool checksumValid = result.checksumMismatches == 0;
+    if (!checksumValid)
+        std::cerr << result.process << ": " << result.checksumMismatches << " samples did not match the kernel spec checksum (last " << result.checksum << ")" << std::endl;
+    if (outputFormat & OUTPUT_JSON)
+        saveResultsToJSON(name + ".json", result.average, result.stdDev, result.process, result.numTests, passedTests, result.language, result.arraySize, result.threshold, result.iterations, result.checksum, checksumValid);
+    if (outputFormat & OUTPUT_BINARY)
+        binaryResults[name].push_back({result.arraySize, result.iterations, result.numTests, passedTests, result.threshold, result.language, result.process, result.average, result.stdDev,
+                                       std::vector<double>(result.samples, result.samples + result.sampleCount), result.checksum, checksumValid});
+    sampleArena.release(result.samples);
+}
+
+void writeFlush(const std::string &name)
+{
+    if (outputFormat & OUTPUT_BINARY)
+        writeBinaryResults(name + ".bin", binaryResults[name]);
+}
+
+void writeCombined(const std::vector<std::string> &names, const std::string &outputName)
+{
+    if (outputFormat & OUTPUT_JSON)
+    {
+        std::vector<std::string> filenames;
+        for (const auto &name : names)
+        {
+            filenames.push_back(name + ".json");
+        }
+        combineJSONFiles(filenames, outputName + ".json");
+    }
+    if (outputFormat & OUTPUT_BINARY)
+    {
+        std::vector<BenchmarkRecord> combined;
+        for (const auto &name : names)
+        {
+            const auto &records = binaryResults[name];
+            combined.insert(combined.end(), records.begin(), records.end());
+        }
+        writeBinaryResults(outputName + ".bin", combined);
+    }
+}
+
+struct WriteRequest
+{
+    enum Kind
+    {
+        RESET,
+        SAVE,
+        FLUSH,
+        COMBINE,
+        LOG
+    } kind;
+    const char *name;
+    PendingResult result;
+    std::string message;
+    std::vector<std::string> names;
+};
+
+struct ResultHandler
+{
+    void operator()(WriteRequest &request)
+    {
+        switch (request.kind)
+        {
+        case WriteRequest::RESET:
+            writeReset(request.name);
+            break;
+        case WriteRequest::SAVE:
+            writeRecord(request.name, request.result);
+            break;
+        case WriteRequest::FLUSH:
+            writeFlush(request.name);
+            break;
+        case WriteRequest::COMBINE:
+            writeCombined(request.names, request.name);
+            break;
+        case WriteRequest::LOG:
+            std::cout << request.message << std::endl;
+            break;
+        }
+    }
+
+    // The writer thread detaches from the JVM while it has nothing to do.
+    void idle()
+    {
+        detachResultChannel();
+    }
+};
+
+ResultWriter<WriteRequest, ResultHandler> resultWriter;
+
+void resetResults(const char *name)
+{
+    WriteRequest request{WriteRequest::RESET, name, {}, {}, {}};
+    resultWriter.submit(request);
+}
+
+void saveResults(const char *name, const SampleBuffer &times, double average, double stdDev, const char *process, int numTests, const char *language, int arraySize, double threshold, int iterations, uint64_t checksum, int mismatches)
+{
+    WriteRequest request{WriteRequest::SAVE, name, {arraySize, iterations, numTests, threshold, language, process, average, stdDev, times.begin(), times.size(), checksum, mismatches}, {}, {}};
+    resultWriter.submit(request);
+}
+
+void discardSamples(const SampleBuffer &times)
+{
+    sampleArena.release(times.begin());
+}
+
+void flushResults(const char *name)
+{
+    WriteRequest request{WriteRequest::FLUSH, name, {}, {}, {}};
+    resultWriter.submit(request);
+}
+
+void combineResults(const std::vector<std::string> &names, const char *outputName)
+{
+    WriteRequest request{WriteRequest::COMBINE, outputName, {}, {}, names};
+    resultWriter.submit(request);
+}
+
+void logMessage(const std::string &message)
+{
+    WriteRequest request{WriteRequest::LOG, nullptr, {}, message, {}};
+    resultWriter.submit(request);
+}
+
+// Shared with Java while a benchmark call runs. The drivers and warm-ups check
+// the cancel flag between samples and publish where they are; Java polls the
+// counters through getNative_Cpp_Progress. Relaxed ordering is enough for
+// both. The flag is cleared by prepareNative_Cpp_Benchmark when the GUI queues
+// a run, so a cancel that arrives before the benchmark call starts still
+// counts.
+struct RunProgress
+{
+    std::atomic<bool> cancelled{false};
+    std::atomic<int> benchmark{0};
+    std::atomic<int> parameter{0};
+    std::atomic<int> sample{0};
+    std::atomic<int> completedPoints{0};
+    std::atomic<int> totalPoints{0};
+};
+
+RunProgress runProgress;
+
+bool cancelRequested()
+{
+    return runProgress.cancelled.load(std::memory_order_relaxed);
+}
+
+void beginPoint(int benchmark, int parameter)
+{
+    runProgress.benchmark.store(benchmark, std::memory_order_relaxed);
+    runProgress.parameter.store(parameter, std::memory_order_relaxed);
+    runProgress.sample.store(0, std::memory_order_relaxed);
+}
+
+void recordSample(int sample)
+{
+    runProgress.sample.store(sample, std::memory_order_relaxed);
+}
+
+void finishPoint()
+{
+    runProgress.completedPoints.fetch_add(1, std::memory_order_relaxed);
+}
+
 void StaticAccessMain(int numTests, double threshold)
 {
-    const char language[] = "C++";
+    if (cancelRequested())
+        return;
+    const char *language = "C++";
     std::cout << std::fixed << std::setprecision(6);
 
-    std::ofstream("C++_measurements/C++_static_access.json") << "[]";
+    resetResults("C++_static_access");
 
     for (int size : ARRAY_SIZES)
     {
-        std::vector<double> staticAccessTimes;
+        beginPoint(1, size);
+        SampleBuffer staticAccessTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Static Memory Access", size);
+        int mismatches = 0;
 
-        for (int i = 0; i < NUM_TESTS; ++i)
+        for (int i = 0; i < numTests && !cancelRequested(); ++i)
+        {
+            recordSample(i);
+            staticAccessTimes.push(measureStaticMemoryAccess(size));
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
         {
-            staticAccessTimes.push_back(measureStaticMemoryAccess(size));
+            discardSamples(staticAccessTimes);
+            break;
         }
 
         removeOutliers(staticAccessTimes, threshold);
@@ -353,29 +900,45 @@ void StaticAccessMain(int numTests, double threshold)
         {
             double staticAverage = calculateAverage(staticAccessTimes);
             double staticStdDev = calculateStandardDeviation(staticAccessTimes, staticAverage);
-            saveResultsToJSON("C++_static_access.json", staticAverage, staticStdDev, "Static Memory Access", numTests, staticAccessTimes.size(), language, size, threshold, 0);
+            saveResults("C++_static_access", staticAccessTimes, staticAverage, staticStdDev, "Static Memory Access", numTests, language, size, threshold, 0, kernelChecksum, mismatches);
         }
         else
         {
-            std::cout << "All static memory access times were outliers for array size " << size << ".\n";
+            discardSamples(staticAccessTimes);
+            logMessage("All static memory access times were outliers for array size " + std::to_string(size) + ".");
         }
+        finishPoint();
     }
+
+    flushResults("C++_static_access");
 }
 
 void DynamicAccessMain(int numTests, double threshold)
 {
-    const char language[] = "C++";
+    if (cancelRequested())
+        return;
+    const char *language = "C++";
     std::cout << std::fixed << std::setprecision(6);
 
-    std::ofstream("C++_measurements/C++_dynamic_access.json") << "[]";
+    resetResults("C++_dynamic_access");
 
     for (int size : ARRAY_SIZES)
     {
-        std::vector<double> dynamicAccessTimes;
+        beginPoint(2, size);
+        SampleBuffer dynamicAccessTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Dynamic Memory Access", size);
+        int mismatches = 0;
 
-        for (int i = 0; i < NUM_TESTS; ++i)
+        for (int i = 0; i < numTests && !cancelRequested(); ++i)
+        {
+            recordSample(i);
+            dynamicAccessTimes.push(measureDynamicMemoryAccess(size));
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
         {
-            dynamicAccessTimes.push_back(measureDynamicMemoryAccess(size));
+            discardSamples(dynamicAccessTimes);
+            break;
         }
 
         removeOutliers(dynamicAccessTimes, threshold);
@@ -384,29 +947,45 @@ void DynamicAccessMain(int numTests, double threshold)
         {
             double dynamicAverage = calculateAverage(dynamicAccessTimes);
             double dynamicStdDev = calculateStandardDeviation(dynamicAccessTimes, dynamicAverage);
-            saveResultsToJSON("C++_dynamic_access.json", dynamicAverage, dynamicStdDev, "Dynamic Memory Access", numTests, dynamicAccessTimes.size(), language, size, threshold, 0);
+            saveResults("C++_dynamic_access", dynamicAccessTimes, dynamicAverage, dynamicStdDev, "Dynamic Memory Access", numTests, language, size, threshold, 0, kernelChecksum, mismatches);
         }
         else
         {
-            std::cout << "All dynamic memory access times were outliers for array size " << size << ".\n";
+            discardSamples(dynamicAccessTimes);
+            logMessage("All dynamic memory access times were outliers for array size " + std::to_string(size) + ".");
         }
+        finishPoint();
     }
+
+    flushResults("C++_dynamic_access");
 }
 
 void AllocationMain(int numTests, double threshold)
 {
-    const char language[] = "C++";
+    if (cancelRequested())
+        return;
+    const char *language = "C++";
     std::cout << std::fixed << std::setprecision(6);
 
-    std::ofstream("C++_measurements/C++_allocation.json") << "[]";
+    resetResults("C++_allocation");
 
     for (int size : ARRAY_SIZES)
     {
-        std::vector<double> allocTimes;
+        beginPoint(3, size);
+        SampleBuffer allocTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Memory Allocation", size);
+        int mismatches = 0;
 
-        for (int i = 0; i < NUM_TESTS; ++i)
+        for (int i = 0; i < numTests && !cancelRequested(); ++i)
+        {
+            recordSample(i);
+            allocTimes.push(measureMemoryAllocation(size));
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
         {
-            allocTimes.push_back(measureMemoryAllocation(size));
+            discardSamples(allocTimes);
+            break;
         }
 
         removeOutliers(allocTimes, threshold);
@@ -415,29 +994,45 @@ void AllocationMain(int numTests, double threshold)
         {
             double allocAverage = calculateAverage(allocTimes);
             double allocStdDev = calculateStandardDeviation(allocTimes, allocAverage);
-            saveResultsToJSON("C++_allocation.json", allocAverage, allocStdDev, "Memory Allocation", numTests, allocTimes.size(), language, size, threshold, 0);
+            saveResults("C++_allocation", allocTimes, allocAverage, allocStdDev, "Memory Allocation", numTests, language, size, threshold, 0, kernelChecksum, mismatches);
         }
         else
         {
-            std::cout << "All memory allocation times were outliers for array size " << size << ".\n";
+            discardSamples(allocTimes);
+            logMessage("All memory allocation times were outliers for array size " + std::to_string(size) + ".");
         }
+        finishPoint();
     }
+
+    flushResults("C++_allocation");
 }
 
 void DeallocationMain(int numTests, double threshold)
 {
-    const char language[] = "C++";
+    if (cancelRequested())
+        return;
+    const char *language = "C++";
     std::cout << std::fixed << std::setprecision(6);
 
-    std::ofstream("C++_measurements/C++_deallocation.json") << "[]";
+    resetResults("C++_deallocation");
 
     for (int size : ARRAY_SIZES)
     {
-        std::vector<double> deallocTimes;
+        beginPoint(4, size);
+        SampleBuffer deallocTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Memory Deallocation", size);
+        int mismatches = 0;
 
-        for (int i = 0; i < NUM_TESTS; ++i)
+        for (int i = 0; i < numTests && !cancelRequested(); ++i)
+        {
+            recordSample(i);
+            deallocTimes.push(measureMemoryDeallocation(size));
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
         {
-            deallocTimes.push_back(measureMemoryDeallocation(size));
+            discardSamples(deallocTimes);
+            break;
         }
 
         removeOutliers(deallocTimes, threshold);
@@ -446,28 +1041,44 @@ void DeallocationMain(int numTests, double threshold)
         {
             double deallocAverage = calculateAverage(deallocTimes);
             double deallocStdDev = calculateStandardDeviation(deallocTimes, deallocAverage);
-            saveResultsToJSON("C++_deallocation.json", deallocAverage, deallocStdDev, "Memory Deallocation", numTests, deallocTimes.size(), language, size, threshold, 0);
+            saveResults("C++_deallocation", deallocTimes, deallocAverage, deallocStdDev, "Memory Deallocation", numTests, language, size, threshold, 0, kernelChecksum, mismatches);
         }
         else
         {
-            std::cout << "All memory deallocation times were outliers for array size " << size << ".\n";
+            discardSamples(deallocTimes);
+            logMessage("All memory deallocation times were outliers for array size " + std::to_string(size) + ".");
         }
+        finishPoint();
     }
+
+    flushResults("C++_deallocation");
 }
 
 void ThreadCreationMain(int numTests, double threshold)
 {
-    const char language[] = "C++";
+    if (cancelRequested())
+        return;
+    const char *language = "C++";
     std::cout << std::fixed << std::setprecision(6);
 
-    std::ofstream("C++_measurements/C++_thread_creation.json") << "[]";
+    resetResults("C++_thread_creation");
 
     for (int iterations : ITERATIONS)
     {
-        std::vector<double> threadCreationTimes;
-        for (int i = 0; i < NUM_TESTS; ++i)
+        beginPoint(5, iterations);
+        SampleBuffer threadCreationTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Thread Creation", iterations);
+        int mismatches = 0;
+        for (int i = 0; i < numTests && !cancelRequested(); ++i)
+        {
+            recordSample(i);
+            threadCreationTimes.push(measureThreadCreationTime(iterations));
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
         {
-            threadCreationTimes.push_back(measureThreadCreationTime(iterations));
+            discardSamples(threadCreationTimes);
+            break;
         }
 
         removeOutliers(threadCreationTimes, threshold);
@@ -476,58 +1087,95 @@ void ThreadCreationMain(int numTests, double threshold)
         {
             double threadCreationAverage = calculateAverage(threadCreationTimes);
             double threadCreationStdDev = calculateStandardDeviation(threadCreationTimes, threadCreationAverage);
-            saveResultsToJSON("C++_thread_creation.json", threadCreationAverage, threadCreationStdDev, "Thread Creation", numTests, threadCreationTimes.size(), language, 0, threshold, iterations);
+            saveResults("C++_thread_creation", threadCreationTimes, threadCreationAverage, threadCreationStdDev, "Thread Creation", numTests, language, 0, threshold, iterations, kernelChecksum, mismatches);
         }
         else
         {
-            std::cout << "All thread creation times were outliers.\n";
+            discardSamples(threadCreationTimes);
+            logMessage("All thread creation times were outliers.");
         }
+        finishPoint();
     }
+
+    flushResults("C++_thread_creation");
 }
 
 void ContextSwitchMain(int numTests, double threshold)
 {
-    const char language[] = "C++";
+    if (cancelRequested())
+        return;
+    const char *language = "C++";
     std::cout << std::fixed << std::setprecision(6);
 
-    std::ofstream("C++_measurements/C++_context_switch.json") << "[]";
+    resetResults("C++_context_switch");
 
-    for (int iterations : ITERATIONS)
+    for (const ContextSwitchCase &contextSwitch : CONTEXT_SWITCH_CASES)
     {
-        std::vector<double> contextSwitchTimes;
-        for (int i = 0; i < NUM_TESTS; ++i)
+        for (int iterations : ITERATIONS)
         {
-            contextSwitchTimes.push_back(measureContextSwitchTime(iterations));
-        }
+            if (cancelRequested())
+                break;
+            beginPoint(6, iterations);
+            SampleBuffer contextSwitchTimes = sampleArena.acquire();
+            uint64_t expected = expectedChecksum("Context Switch", iterations);
+            int mismatches = 0;
+            for (int i = 0; i < numTests && !cancelRequested(); ++i)
+            {
+                recordSample(i);
+                contextSwitchTimes.push(contextSwitch.measure(iterations));
+                mismatches += kernelChecksum != expected;
+            }
+            if (cancelRequested())
+            {
+                discardSamples(contextSwitchTimes);
+                break;
+            }
 
-        removeOutliers(contextSwitchTimes, threshold);
+            removeOutliers(contextSwitchTimes, threshold);
 
-        if (!contextSwitchTimes.empty())
-        {
-            double contextSwitchAverage = calculateAverage(contextSwitchTimes);
-            double contextSwitchStdDev = calculateStandardDeviation(contextSwitchTimes, contextSwitchAverage);
-            saveResultsToJSON("C++_context_switch.json", contextSwitchAverage, contextSwitchStdDev, "Context Switch", numTests, contextSwitchTimes.size(), language, 0, threshold, iterations);
-        }
-        else
-        {
-            std::cout << "All context switch times were outliers.\n";
+            if (!contextSwitchTimes.empty())
+            {
+                double contextSwitchAverage = calculateAverage(contextSwitchTimes);
+                double contextSwitchStdDev = calculateStandardDeviation(contextSwitchTimes, contextSwitchAverage);
+                saveResults("C++_context_switch", contextSwitchTimes, contextSwitchAverage, contextSwitchStdDev, contextSwitch.process, numTests, language, 0, threshold, iterations, kernelChecksum, mismatches);
+            }
+            else
+            {
+                discardSamples(contextSwitchTimes);
+                logMessage(std::string("All ") + contextSwitch.process + " times were outliers.");
+            }
+            finishPoint();
         }
     }
+
+    flushResults("C++_context_switch");
 }
 
 void ThreadMigrationMain(int numTests, double threshold)
 {
-    const char language[] = "C++";
+    if (cancelRequested())
+        return;
+    const char *language = "C++";
     std::cout << std::fixed << std::setprecision(6);
 
-    std::ofstream("C++_measurements/C++_thread_migration.json") << "[]";
+    resetResults("C++_thread_migration");
 
     for (int iterations : ITERATIONS)
     {
-        std::vector<double> threadMigrationTimes;
-        for (int i = 0; i < NUM_TESTS; ++i)
+        beginPoint(7, iterations);
+        SampleBuffer threadMigrationTimes = sampleArena.acquire();
+        uint64_t expected = expectedChecksum("Thread Migration", iterations);
+        int mismatches = 0;
+        for (int i = 0; i < numTests && !cancelRequested(); ++i)
         {
-            threadMigrationTimes.push_back(measureThreadMigrationTime(iterations));
+            recordSample(i);
+            threadMigrationTimes.push(measureThreadMigrationTime(iterations));
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
+        {
+            discardSamples(threadMigrationTimes);
+            break;
         }
 
         removeOutliers(threadMigrationTimes, threshold);
@@ -536,18 +1184,299 @@ void ThreadMigrationMain(int numTests, double threshold)
         {
             double threadMigrationAverage = calculateAverage(threadMigrationTimes);
             double threadMigrationStdDev = calculateStandardDeviation(threadMigrationTimes, threadMigrationAverage);
-            saveResultsToJSON("C++_thread_migration.json", threadMigrationAverage, threadMigrationStdDev, "Thread Migration", numTests, threadMigrationTimes.size(), language, 0, threshold, iterations);
+            saveResults("C++_thread_migration", threadMigrationTimes, threadMigrationAverage, threadMigrationStdDev, "Thread Migration", numTests, language, 0, threshold, iterations, kernelChecksum, mismatches);
         }
         else
         {
-            std::cout << "All thread migration times were outliers.\n";
+            discardSamples(threadMigrationTimes);
+            logMessage("All thread migration times were outliers.");
         }
+        finishPoint();
     }
+
+    flushResults("C++_thread_migration");
 }
 
-void callAll_Cpp_Benchmarks(int numTests, double threshold)
+// False sharing (benchmark type 9): each counter layout over 1..N threads.
+// The thread count goes in the iterations column, so the results keep the
+// ns/op schema of the other benchmarks.
+void FalseSharingMain(int numTests, double threshold)
+{
+    if (cancelRequested())
+        return;
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    resetResults("C++_false_sharing");
+
+    std::vector<int> threadCounts = threadSweep(std::max(1u, std::thread::hardware_concurrency()));
+    for (const FalseSharingLayout &layout : FALSE_SHARING_LAYOUTS)
+    {
+        for (int threads : threadCounts)
+        {
+            if (cancelRequested())
+                break;
+            beginPoint(9, threads);
+            SampleBuffer falseSharingTimes = sampleArena.acquire();
+            uint64_t expected = static_cast<uint64_t>(threads) * FALSE_SHARING_INCREMENTS;
+            int mismatches = 0;
+            for (int i = 0; i < numTests && !cancelRequested(); ++i)
+            {
+                recordSample(i);
+                falseSharingTimes.push(measureFalseSharing(threads, layout.stride, FALSE_SHARING_INCREMENTS));
+                mismatches += kernelChecksum != expected;
+            }
+            if (cancelRequested())
+            {
+                discardSamples(falseSharingTimes);
+                break;
+            }
+
+            removeOutliers(falseSharingTimes, threshold);
+
+            if (!falseSharingTimes.empty())
+            {
+                double falseSharingAverage = calculateAverage(falseSharingTimes);
+                double falseSharingStdDev = calculateStandardDeviation(falseSharingTimes, falseSharingAverage);
+                saveResults("C++_false_sharing", falseSharingTimes, falseSharingAverage, falseSharingStdDev, layout.process, numTests, language, 0, threshold, threads, kernelChecksum, mismatches);
+                logMessage(std::string(layout.process) + ", " + std::to_string(threads) + " threads: " + std::to_string(1e3 / falseSharingAverage) + " Mops/s");
+            }
+            else
+            {
+                discardSamples(falseSharingTimes);
+                logMessage(std::string("All ") + layout.process + " times were outliers for " + std::to_string(threads) + " threads.");
+            }
+            finishPoint();
+        }
+    }
+
+    flushResults("C++_false_sharing");
+}
+
+// JNI overhead benchmarks (benchmark type 8). Java-to-native crossings are
+// timed by loops in JNInterface that the driver calls once per sample; the
+// callback case is timed here. Array and buffer cases touch every element.
+JNIEXPORT void JNICALL Java_JNInterface_jniEmpty(JNIEnv *env, jobject obj)
+{
+}
+
+JNIEXPORT jint JNICALL Java_JNInterface_jniPrimitiveArgs(JNIEnv *env, jobject obj, jint a, jlong b, jdouble c)
+{
+    return a + static_cast<jint>(b) + static_cast<jint>(c);
+}
+
+JNIEXPORT jlong JNICALL Java_JNInterface_jniSumArrayElements(JNIEnv *env, jobject obj, jintArray data)
+{
+    jsize length = env->GetArrayLength(data);
+    jint *elements = env->GetIntArrayElements(data, nullptr);
+    jlong sum = std::accumulate(elements, elements + length, jlong(0));
+    env->ReleaseIntArrayElements(data, elements, JNI_ABORT);
+    return sum;
+}
+
+JNIEXPORT jlong JNICALL Java_JNInterface_jniSumArrayCritical(JNIEnv *env, jobject obj, jintArray data)
+{
+    jsize length = env->GetArrayLength(data);
+    jint *elements = static_cast<jint *>(env->GetPrimitiveArrayCritical(data, nullptr));
+    jlong sum = std::accumulate(elements, elements + length, jlong(0));
+    env->ReleasePrimitiveArrayCritical(data, elements, JNI_ABORT);
+    return sum;
+}
+
+JNIEXPORT jlong JNICALL Java_JNInterface_jniSumDirectBuffer(JNIEnv *env, jobject obj, jobject buffer)
+{
+    const jint *elements = static_cast<const jint *>(env->GetDirectBufferAddress(buffer));
+    jlong length = env->GetDirectBufferCapacity(buffer) / sizeof(jint);
+    return std::accumulate(elements, elements + length, jlong(0));
+}
+
+// Java objects shared by the cases of one sweep point.
+struct JniPayload
+{
+    jmethodID timeEmptyCalls;
+    jmethodID timePrimitiveCalls;
+    jmethodID timeArrayElements;
+    jmethodID timeArrayCritical;
+    jmethodID timeDirectBuffer;
+    jmethodID onCallback;
+    jintArray array;
+    jobject directBuffer;
+};
+
+// Payload cases repeat the call so small arrays are not below timer resolution.
+int payloadCalls(int size)
+{
+    return std::max(1, 100000 / size);
+}
+
+// Cases without a payload sweep the number of back-to-back calls instead.
+double measureJniEmptyCall(JNIEnv *env, jobject obj, const JniPayload &payload, int size)
+{
+    return env->CallLongMethod(obj, payload.timeEmptyCalls, size) / static_cast<double>(size);
+}
+
+double measureJniPrimitiveCall(JNIEnv *env, jobject obj, const JniPayload &payload, int size)
+{
+    return env->CallLongMethod(obj, payload.timePrimitiveCalls, size) / static_cast<double>(size);
+}
+
+double measureJniArrayElements(JNIEnv *env, jobject obj, const JniPayload &payload, int size)
 {
+    int calls = payloadCalls(size);
+    return env->CallLongMethod(obj, payload.timeArrayElements, payload.array, calls) / static_cast<double>(calls);
+}
+
+double measureJniArrayCritical(JNIEnv *env, jobject obj, const JniPayload &payload, int size)
+{
+    int calls = payloadCalls(size);
+    return env->CallLongMethod(obj, payload.timeArrayCritical, payload.array, calls) / static_cast<double>(calls);
+}
+
+double measureJniDirectBuffer(JNIEnv *env, jobject obj, const JniPayload &payload, int size)
+{
+    int calls = payloadCalls(size);
+    return env->CallLongMethod(obj, payload.timeDirectBuffer, payload.directBuffer, calls) / static_cast<double>(calls);
+}
+
+double measureJniCallback(JNIEnv *env, jobject obj, const JniPayload &payload, int size)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < size; ++i)
+    {
+        env->CallVoidMethod(obj, payload.onCallback, i);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / size;
+}
+
+struct JniOverheadCase
+{
+    const char *process;
+    double (*measure)(JNIEnv *, jobject, const JniPayload &, int);
+};
+
+const JniOverheadCase JNI_OVERHEAD_CASES[] = {
+    {"JNI Empty Call", measureJniEmptyCall},
+    {"JNI Primitive Call", measureJniPrimitiveCall},
+    {"JNI GetIntArrayElements", measureJniArrayElements},
+    {"JNI GetPrimitiveArrayCritical", measureJniArrayCritical},
+    {"JNI Direct ByteBuffer", measureJniDirectBuffer},
+    {"JNI Callback", measureJniCallback},
+};
+
+void JniOverheadMain(JNIEnv *env, jobject obj, int numTests, double threshold)
+{
+    if (cancelRequested())
+        return;
+    const char *language = "C++";
+    std::cout << std::fixed << std::setprecision(6);
+
+    jclass jniClass = env->GetObjectClass(obj);
+    JniPayload payload;
+    payload.timeEmptyCalls = env->GetMethodID(jniClass, "timeEmptyCalls", "(I)J");
+    payload.timePrimitiveCalls = env->GetMethodID(jniClass, "timePrimitiveCalls", "(I)J");
+    payload.timeArrayElements = env->GetMethodID(jniClass, "timeArrayElements", "([II)J");
+    payload.timeArrayCritical = env->GetMethodID(jniClass, "timeArrayCritical", "([II)J");
+    payload.timeDirectBuffer = env->GetMethodID(jniClass, "timeDirectBuffer", "(Ljava/nio/ByteBuffer;I)J");
+    payload.onCallback = env->GetMethodID(jniClass, "onCallback", "(I)V");
+    if (env->ExceptionCheck())
+    {
+        env->ExceptionDescribe();
+        env->ExceptionClear();
+        return;
+    }
+
+    resetResults("C++_jni_overhead");
+
+    // Every payload is allocated before the sweep. Direct buffers are slices of
+    // one native array of the largest size. GetIntArrayElements copies the
+    // whole Java array, so each size keeps its own int[], filled from the same
+    // slice.
+    std::vector<jint> values(*std::max_element(ARRAY_SIZES.begin(), ARRAY_SIZES.end()));
+    std::iota(values.begin(), values.end(), 0);
+    std::vector<jintArray> arrays(ARRAY_SIZES.size(), nullptr);
+    std::vector<jobject> directBuffers(ARRAY_SIZES.size(), nullptr);
+    for (size_t index = 0; index < ARRAY_SIZES.size(); ++index)
+    {
+        int size = ARRAY_SIZES[index];
+        jintArray array = env->NewIntArray(size);
+        if (array == nullptr)
+        {
+            env->ExceptionClear();
+            logMessage("Could not allocate a Java array of size " + std::to_string(size) + ".");
+            continue;
+        }
+        env->SetIntArrayRegion(array, 0, size, values.data());
+        arrays[index] = static_cast<jintArray>(env->NewGlobalRef(array));
+        env->DeleteLocalRef(array);
+
+        jobject buffer = env->NewDirectByteBuffer(values.data(), static_cast<jlong>(size) * sizeof(jint));
+        directBuffers[index] = env->NewGlobalRef(buffer);
+        env->DeleteLocalRef(buffer);
+    }
+
+    for (const JniOverheadCase &benchmark : JNI_OVERHEAD_CASES)
+    {
+        for (size_t index = 0; index < ARRAY_SIZES.size(); ++index)
+        {
+            int size = ARRAY_SIZES[index];
+            if (cancelRequested())
+                break;
+            beginPoint(8, size);
+
+            if (arrays[index] == nullptr)
+            {
+                logMessage(std::string("Skipping ") + benchmark.process + " for array size " + std::to_string(size) + ".");
+                finishPoint();
+                continue;
+            }
+            payload.array = arrays[index];
+            payload.directBuffer = directBuffers[index];
 
+            SampleBuffer jniTimes = sampleArena.acquire();
+            for (int i = 0; i < numTests && !cancelRequested(); ++i)
+            {
+                recordSample(i);
+                jniTimes.push(benchmark.measure(env, obj, payload, size));
+            }
+
+            if (cancelRequested())
+            {
+                discardSamples(jniTimes);
+                break;
+            }
+
+            removeOutliers(jniTimes, threshold);
+
+            if (!jniTimes.empty())
+            {
+                double jniAverage = calculateAverage(jniTimes);
+                double jniStdDev = calculateStandardDeviation(jniTimes, jniAverage);
+                saveResults("C++_jni_overhead", jniTimes, jniAverage, jniStdDev, benchmark.process, numTests, language, size, threshold, 0, NO_CHECKSUM, 0);
+            }
+            else
+            {
+                discardSamples(jniTimes);
+                logMessage(std::string("All ") + benchmark.process + " times were outliers for array size " + std::to_string(size) + ".");
+            }
+            finishPoint();
+        }
+    }
+
+    for (size_t index = 0; index < ARRAY_SIZES.size(); ++index)
+    {
+        if (arrays[index] != nullptr)
+        {
+            env->DeleteGlobalRef(arrays[index]);
+            env->DeleteGlobalRef(directBuffers[index]);
+        }
+    }
+
+    flushResults("C++_jni_overhead");
+}
+
+void callAll_Cpp_Benchmarks(int numTests, double threshold)
+{
     StaticAccessMain(numTests, threshold);
     DynamicAccessMain(numTests, threshold);
     AllocationMain(numTests, threshold);
@@ -556,11 +1485,128 @@ void callAll_Cpp_Benchmarks(int numTests, double threshold)
     ContextSwitchMain(numTests, threshold);
     ThreadMigrationMain(numTests, threshold);
 
-    combineJSONFiles({"C++_static_access.json", "C++_dynamic_access.json", "C++_allocation.json", "C++_deallocation.json", "C++_thread_creation.json", "C++_context_switch.json", "C++_thread_migration.json"}, "C++_results.json");
+    // Skipped benchmarks still hold the previous run's results.
+    if (cancelRequested())
+        return;
+    combineResults({"C++_static_access", "C++_dynamic_access", "C++_allocation", "C++_deallocation", "C++_thread_creation", "C++_context_switch", "C++_thread_migration"}, "C++_results");
+}
+
+// One cheap round per benchmark: a single mid-sized point of its sweep. The
+// JNI overhead round crosses into Java, so it needs the caller's env.
+double warmUpRound(JNIEnv *env, jobject obj, int benchmarkType)
+{
+    switch (benchmarkType)
+    {
+    case 1:
+        return measureStaticMemoryAccess(10000);
+    case 2:
+        return measureDynamicMemoryAccess(10000);
+    case 3:
+        return measureMemoryAllocation(10000);
+    case 4:
+        return measureMemoryDeallocation(10000);
+    case 5:
+        return measureThreadCreationTime(10);
+    case 6:
+        return measureContextSwitchTime(100);
+    case 7:
+        return measureThreadMigrationTime(2);
+    case 8:
+    {
+        jmethodID timeEmptyCalls = env->GetMethodID(env->GetObjectClass(obj), "timeEmptyCalls", "(I)J");
+        if (timeEmptyCalls == nullptr)
+        {
+            env->ExceptionClear();
+            return 0.0;
+        }
+        return env->CallLongMethod(obj, timeEmptyCalls, 10000) / 10000.0;
+    }
+    case 9:
+        return measureFalseSharing(2, sizeof(uint64_t), 100000);
+    default:
+        return 0.0;
+    }
+}
+
+// Runs warm-up rounds until the mean of the last WARMUP_WINDOW rounds is
+// within tolerance of the window before it. Returns the rounds it took.
+int warmUpBenchmark(JNIEnv *env, jobject obj, int benchmarkType, int maxRounds, double tolerance)
+{
+    double rounds[2 * WARMUP_WINDOW];
+    int round = 0;
+    while (round < maxRounds && !cancelRequested())
+    {
+        rounds[round % (2 * WARMUP_WINDOW)] = warmUpRound(env, obj, benchmarkType);
+        ++round;
+        if (round >= 2 * WARMUP_WINDOW)
+        {
+            double previous = 0.0;
+            double current = 0.0;
+            for (int i = 0; i < WARMUP_WINDOW; ++i)
+            {
+                previous += rounds[(round + i) % (2 * WARMUP_WINDOW)];
+                current += rounds[(round + WARMUP_WINDOW + i) % (2 * WARMUP_WINDOW)];
+            }
+            if (std::fabs(current - previous) <= tolerance * previous)
+            {
+                break;
+            }
+        }
+    }
+    return round;
+}
+
+JNIEXPORT jint JNICALL Java_JNInterface_warmUpNative_1Cpp_1Benchmark(JNIEnv *env, jobject obj, jint benchmarkType, jint maxRounds, jdouble tolerance)
+{
+    if (benchmarkType < 0 || benchmarkType > 9)
+    {
+        std::cerr << "Invalid benchmark type" << std::endl;
+        return 0;
+    }
+    if (benchmarkType != 0)
+    {
+        return warmUpBenchmark(env, obj, benchmarkType, maxRounds, tolerance);
+    }
+
+    int rounds = 0;
+    for (int type = 1; type <= 7; ++type)
+    {
+        rounds += warmUpBenchmark(env, obj, type, maxRounds, tolerance);
+    }
+    return rounds;
 }
 
 JNIEXPORT void JNICALL Java_JNInterface_callNative_1Cpp_1Benchmark(JNIEnv *env, jobject obj, jint benchmarkType, jint numTests, jdouble threshold)
 {
+    if (numTests <= 0)
+    {
+        std::cerr << "Number of tests must be positive" << std::endl;
+        return;
+    }
+    if (!loadKernelSpec())
+    {
+        env->ThrowNew(env->FindClass("java/lang/IllegalStateException"),
+                      "C++ kernel spec is missing or does not match this library; set KERNEL_SPEC to kernel_spec.json");
+        return;
+    }
+    sampleArena.reserve(numTests);
+
+    // Benchmarks 1-4 sweep ARRAY_SIZES, 5-7 sweep ITERATIONS (6 once per
+    // context switch case), 8 sweeps ARRAY_SIZES once per JNI overhead case
+    // and 9 sweeps thread counts once per counter layout.
+    int sizePoints = ARRAY_SIZES.size();
+    int iterationPoints = ITERATIONS.size();
+    int contextSwitchPoints = std::size(CONTEXT_SWITCH_CASES) * iterationPoints;
+    int totalPoints = benchmarkType == 0 ? 4 * sizePoints + 2 * iterationPoints + contextSwitchPoints : (benchmarkType <= 4 ? sizePoints : iterationPoints);
+    if (benchmarkType == 6)
+        totalPoints = contextSwitchPoints;
+    if (benchmarkType == 8)
+        totalPoints = std::size(JNI_OVERHEAD_CASES) * sizePoints;
+    if (benchmarkType == 9)
+        totalPoints = std::size(FALSE_SHARING_LAYOUTS) * threadSweep(std::max(1u, std::thread::hardware_concurrency())).size();
+    runProgress.completedPoints.store(0, std::memory_order_relaxed);
+    runProgress.totalPoints.store(totalPoints, std::memory_order_relaxed);
+
     switch (benchmarkType)
     {
     case 0:
@@ -587,8 +1633,75 @@ JNIEXPORT void JNICALL Java_JNInterface_callNative_1Cpp_1Benchmark(JNIEnv *env,
     case 7:
         ThreadMigrationMain(numTests, threshold);
         break;
+    case 8:
+        JniOverheadMain(env, obj, numTests, threshold);
+        break;
+    case 9:
+        FalseSharingMain(numTests, threshold);
+        break;
     default:
         std::cerr << "Invalid benchmark type" << std::endl;
         break;
     }
+
+    // Ends the writer so this worker thread gets back the CPU it gave up.
+    resultWriter.stop();
+}
+
+JNIEXPORT void JNICALL Java_JNInterface_setNative_1Cpp_1OutputFormat(JNIEnv *env, jobject obj, jint format)
+{
+    if ((format & (OUTPUT_JSON | OUTPUT_BINARY)) == 0)
+    {
+        std::cerr << "Invalid output format" << std::endl;
+        return;
+    }
+    resultWriter.drain();
+    outputFormat = format;
+}
+
+JNIEXPORT void JNICALL Java_JNInterface_setNative_1Cpp_1ResultListener(JNIEnv *env, jobject obj, jobject listener)
+{
+    resultWriter.drain();
+    if (resultChannel.listener != nullptr)
+    {
+        env->DeleteGlobalRef(resultChannel.listener);
+        env->DeleteGlobalRef(resultChannel.resultClass);
+        resultChannel.listener = nullptr;
+        resultChannel.resultClass = nullptr;
+    }
+    if (listener == nullptr)
+        return;
+
+    jclass resultClass = env->FindClass("BenchmarkResult");
+    if (resultClass == nullptr)
+        return;
+    env->GetJavaVM(&resultChannel.vm);
+    resultChannel.resultConstructor = env->GetMethodID(resultClass, "<init>", "(IIIIILjava/lang/String;Ljava/lang/String;DDDJLjava/lang/String;)V");
+    resultChannel.onResult = env->GetMethodID(env->GetObjectClass(listener), "onResult", "(LBenchmarkResult;)V");
+    if (resultChannel.resultConstructor == nullptr || resultChannel.onResult == nullptr)
+        return;
+    resultChannel.resultClass = static_cast<jclass>(env->NewGlobalRef(resultClass));
+    resultChannel.listener = env->NewGlobalRef(listener);
+}
+
+JNIEXPORT void JNICALL Java_JNInterface_prepareNative_1Cpp_1Benchmark(JNIEnv *env, jobject obj)
+{
+    runProgress.cancelled.store(false, std::memory_order_relaxed);
+}
+
+JNIEXPORT void JNICALL Java_JNInterface_cancelNative_1Cpp_1Benchmark(JNIEnv *env, jobject obj)
+{
+    runProgress.cancelled.store(true, std::memory_order_relaxed);
+}
+
+// Fills progress with {benchmark, size or iterations, sample, completed points, total points}.
+JNIEXPORT void JNICALL Java_JNInterface_getNative_1Cpp_1Progress(JNIEnv *env, jobject obj, jintArray progress)
+{
+    jint snapshot[] = {runProgress.benchmark.load(std::memory_order_relaxed),
+                       runProgress.parameter.load(std::memory_order_relaxed),
+                       runProgress.sample.load(std::memory_order_relaxed),
+                       runProgress.completedPoints.load(std::memory_order_relaxed),
+                       runProgress.totalPoints.load(std::memory_order_relaxed)};
+    if (env->GetArrayLength(progress) >= 5)
+        env->SetIntArrayRegion(progress, 0, 5, snapshot);
 }
@@ -7,6 +7,7 @@
 #include <unistd.h>
 #include <sched.h>
 #include <stdint.h>
+#include <string.h>
 #include <cjson/cJSON.h>
 #include <stdatomic.h>
 #include <sys/stat.h>
@@ -16,6 +17,7 @@
 #define NUM_TESTS 100
 #define NUM_ARRAY_SIZES 8
 #define ITERATION_VALUES_COUNT 5
+#define WARMUP_WINDOW 5
 typedef enum
 {
     ALL,
@@ -31,6 +33,124 @@ typedef enum
 int ARRAY_SIZES[NUM_ARRAY_SIZES] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000};
 int ITERATIONS[ITERATION_VALUES_COUNT] = {2, 10, 100, 1000, 10000};
 
+#ifndef KERNEL_SPEC_PATH
+#define KERNEL_SPEC_PATH "../../kernel_spec.json"
+#endif
+
+// Build stamp written into every result. The CMake build defines
+// BENCH_PROFILE and BENCH_CFLAGS; other builds fall back to "unspecified".
+#ifndef BENCH_PROFILE
+#define BENCH_PROFILE "unspecified"
+#endif
+#ifndef BENCH_CFLAGS
+#define BENCH_CFLAGS "unspecified"
+#endif
+#if defined(__clang__)
+#define BENCH_COMPILER "clang " __clang_version__
+#elif defined(__GNUC__)
+#define BENCH_COMPILER "gcc " __VERSION__
+#else
+#define BENCH_COMPILER "unknown"
+#endif
+
+// Checksum of the last kernel call. Every sample is compared with the value
+// kernel_spec.json expects for its point, so C, C++ and Java results can only
+// be compared when they provably ran the same workload.
+uint64_t kernelChecksum;
+cJSON *kernelSpec = NULL;
+
+// Set by cancelNative_C_Benchmark and cleared by prepareNative_C_Benchmark
+// when the GUI queues a run. The drivers and warm-ups check it between
+// samples; a cancelled benchmark keeps the points it already finished and the
+// ones it never started leave their files alone.
+atomic_bool cancelled;
+
+int cancelRequested(void)
+{
+    return atomic_load_explicit(&cancelled, memory_order_relaxed);
+}
+
+int sweepMatchesSpec(const char *name, const int *values, int count)
+{
+    cJSON *sweep = cJSON_GetObjectItem(kernelSpec, name);
+    if (!cJSON_IsArray(sweep) || cJSON_GetArraySize(sweep) != count)
+    {
+        return 0;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (cJSON_GetArrayItem(sweep, i)->valueint != values[i])
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Loads the spec once; KERNEL_SPEC in the environment overrides its path.
+// Returns 0 if it is missing or this harness sweeps different parameters.
+int loadKernelSpec(void)
+{
+    if (kernelSpec != NULL)
+    {
+        return 1;
+    }
+    const char *path = getenv("KERNEL_SPEC");
+    if (path == NULL)
+    {
+        path = KERNEL_SPEC_PATH;
+    }
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Failed to open kernel spec %s\n", path);
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *content = (char *)malloc(fileSize + 1);
+    if (content == NULL)
+    {
+        fclose(file);
+        return 0;
+    }
+    content[fread(content, 1, fileSize, file)] = '\0';
+    fclose(file);
+
+    kernelSpec = cJSON_Parse(content);
+    free(content);
+    if (kernelSpec == NULL)
+    {
+        fprintf(stderr, "Failed to parse kernel spec %s\n", path);
+        return 0;
+    }
+    if (!sweepMatchesSpec("array_sizes", ARRAY_SIZES, NUM_ARRAY_SIZES) || !sweepMatchesSpec("iterations", ITERATIONS, ITERATION_VALUES_COUNT))
+    {
+        fprintf(stderr, "ARRAY_SIZES or ITERATIONS differ from kernel spec %s\n", path);
+        cJSON_Delete(kernelSpec);
+        kernelSpec = NULL;
+        return 0;
+    }
+    return 1;
+}
+
+uint64_t expectedChecksum(const char *process, int point)
+{
+    cJSON *kernel = NULL;
+    cJSON_ArrayForEach(kernel, cJSON_GetObjectItem(kernelSpec, "kernels"))
+    {
+        cJSON *name = cJSON_GetObjectItem(kernel, "process");
+        if (cJSON_IsString(name) && strcmp(name->valuestring, process) == 0)
+        {
+            cJSON *expected = cJSON_GetArrayItem(cJSON_GetObjectItem(kernel, "expected"), point);
+            return cJSON_IsNumber(expected) ? (uint64_t)expected->valuedouble : UINT64_MAX;
+        }
+    }
+    return UINT64_MAX;
+}
+
 double calculateAverage(double *times, int size)
 {
     double sum = 0.0;
@@ -80,12 +200,13 @@ double measureStaticMemoryAccess(int size)
 
     struct timespec start, end;
     clock_gettime(CLOCK_MONOTONIC, &start);
-    int sum = 0;
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
         sum += staticArray[i];
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
+    kernelChecksum = sum;
 
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
     return time / size;
@@ -107,12 +228,13 @@ double measureDynamicMemoryAccess(int size)
 
     struct timespec start, end;
     clock_gettime(CLOCK_MONOTONIC, &start);
-    int sum = 0;
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
         sum += dynamicArray[i];
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
+    kernelChecksum = sum;
 
     free(dynamicArray);
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
@@ -141,11 +263,15 @@ double measureMemoryAllocation(int size)
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
 
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
+        *chunks[i] = i;
+        sum += *chunks[i];
         free(chunks[i]);
     }
     free(chunks);
+    kernelChecksum = sum;
 
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
     return time / size;
@@ -154,13 +280,14 @@ double measureMemoryAllocation(int size)
 double measureMemoryDeallocation(int size)
 {
     struct timespec start, end;
-    void **chunks = malloc(size * sizeof(void *));
+    int **chunks = malloc(size * sizeof(int *));
     if (!chunks)
     {
         perror("Failed to allocate memory for chunk pointers");
         exit(EXIT_FAILURE);
     }
 
+    uint64_t sum = 0;
     for (int i = 0; i < size; i++)
     {
         chunks[i] = (int *)malloc(sizeof(int));
@@ -169,7 +296,10 @@ double measureMemoryDeallocation(int size)
             perror("Failed to allocate memory for a chunk");
             exit(EXIT_FAILURE);
         }
+        *chunks[i] = i;
+        sum += *chunks[i];
     }
+    kernelChecksum = sum;
 
     clock_gettime(CLOCK_MONOTONIC, &start);
     for (int i = 0; i < size; i++)
@@ -191,17 +321,20 @@ void *CreateThreadFunction(void *arg)
     {
         sum += i;
     }
+    *(uint64_t *)arg = sum;
     return NULL;
 }
 
 double measureThreadCreationTime(int iterations)
 {
     struct timespec start, end;
+    uint64_t checksum = 0;
     clock_gettime(CLOCK_MONOTONIC, &start);
     for (int i = 0; i < iterations; i++)
     {
         pthread_t thread;
-        if (pthread_create(&thread, NULL, CreateThreadFunction, NULL) != 0)
+        uint64_t result = 0;
+        if (pthread_create(&thread, NULL, CreateThreadFunction, &result) != 0)
         {
             perror("Failed to create thread");
             exit(EXIT_FAILURE);
@@ -211,8 +344,10 @@ double measureThreadCreationTime(int iterations)
             perror("Failed to join thread");
             exit(EXIT_FAILURE);
         }
+        checksum += result;
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
+    kernelChecksum = checksum;
 
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
     return time / iterations;
@@ -223,6 +358,7 @@ double measureContextSwitchTime(int iterations)
     pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
     pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
     int turn = 1;
+    uint64_t handoffs = 0;
 
     void *switchTask(void *arg)
     {
@@ -235,6 +371,7 @@ double measureContextSwitchTime(int iterations)
                 pthread_cond_wait(&cond, &mutex);
             }
             turn = (turn == 1) ? 2 : 1;
+            handoffs++;
             pthread_cond_signal(&cond);
             pthread_mutex_unlock(&mutex);
         }
@@ -268,6 +405,7 @@ double measureContextSwitchTime(int iterations)
     }
 
     clock_gettime(CLOCK_MONOTONIC, &end);
+    kernelChecksum = handoffs;
     double time = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
     return time / iterations;
 }
@@ -302,12 +440,14 @@ double measureThreadMigrationTime(int iterations)
         //exit(EXIT_FAILURE);
     }
     struct timespec start, end;
+    uint64_t migrations = 0;
     clock_gettime(CLOCK_MONOTONIC, &start);
     for (int i = 0; i < iterations; i++)
     {
         CPU_ZERO(&cpuset);
         CPU_SET(i % 2, &cpuset);
         int s2 = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+        migrations += s2 == 0;
         if (s2 != 0)
         {
             perror("Failed to set affinity in iteration");
@@ -315,6 +455,7 @@ double measureThreadMigrationTime(int iterations)
         }
     }
     clock_gettime(CLOCK_MONOTONIC, &end);
+    kernelChecksum = migrations;
 
     if (pthread_join(thread, NULL) != 0)
     {
@@ -338,7 +479,7 @@ void ensureDirectoryExists(const char *dirName)
     }
 }
 
-void saveResultsToJSON(FILE *file, double average, double stdDev, const char *process, int numTests, int passedTests, const char *language, int arraySize, double threshold, int iterations, int isFirstEntry)
+void saveResultsToJSON(FILE *file, double average, double stdDev, const char *process, int numTests, int passedTests, const char *language, int arraySize, double threshold, int iterations, uint64_t checksum, int mismatches, int isFirstEntry)
 {
     if (!isFirstEntry)
     {
@@ -361,6 +502,15 @@ void saveResultsToJSON(FILE *file, double average, double stdDev, const char *pr
     cJSON_AddStringToObject(json, "process_measured", process);
     cJSON_AddNumberToObject(json, "average_time", average);
     cJSON_AddNumberToObject(json, "std_deviation", stdDev);
+    cJSON_AddNumberToObject(json, "checksum", (double)checksum);
+    cJSON_AddBoolToObject(json, "checksum_valid", mismatches == 0);
+    cJSON_AddStringToObject(json, "compiler", BENCH_COMPILER);
+    cJSON_AddStringToObject(json, "compiler_flags", BENCH_CFLAGS);
+    cJSON_AddStringToObject(json, "build_profile", BENCH_PROFILE);
+    if (mismatches > 0)
+    {
+        fprintf(stderr, "%s: %d samples did not match the kernel spec checksum (last %llu)\n", process, mismatches, (unsigned long long)checksum);
+    }
 
     char *jsonString = cJSON_Print(json);
     if (jsonString == NULL)
@@ -451,6 +601,10 @@ void combineJSONFiles(const char *outputFilename, const char **filenames, int nu
 
 void StaticAccessMain(int numTests, double threshold)
 {
+    if (cancelRequested())
+    {
+        return;
+    }
     ensureDirectoryExists("C_measurements");
     double staticAccessTimes[numTests];
     FILE *staticAccessFile = fopen("C_measurements/C_static_access.json", "w");
@@ -465,10 +619,17 @@ void StaticAccessMain(int numTests, double threshold)
     {
         int size = ARRAY_SIZES[j];
         int staticSize = 0;
+        uint64_t expected = expectedChecksum("Static Memory Access", j);
+        int mismatches = 0;
 
-        for (int i = 0; i < numTests; i++)
+        for (int i = 0; i < numTests && !cancelRequested(); i++)
         {
             staticAccessTimes[staticSize++] = measureStaticMemoryAccess(size);
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
+        {
+            break;
         }
 
         removeOutliers(staticAccessTimes, &staticSize, threshold);
@@ -477,7 +638,7 @@ void StaticAccessMain(int numTests, double threshold)
         {
             double staticAverage = calculateAverage(staticAccessTimes, staticSize);
             double staticStdDev = calculateStandardDeviation(staticAccessTimes, staticAverage, staticSize);
-            saveResultsToJSON(staticAccessFile, staticAverage, staticStdDev, "Static Memory Access", numTests, staticSize, "C", size, threshold, 0, (j == 0));
+            saveResultsToJSON(staticAccessFile, staticAverage, staticStdDev, "Static Memory Access", numTests, staticSize, "C", size, threshold, 0, kernelChecksum, mismatches, (j == 0));
         }
         else
         {
@@ -491,6 +652,10 @@ void StaticAccessMain(int numTests, double threshold)
 
 void DynamicAccessMain(int numTests, double threshold)
 {
+    if (cancelRequested())
+    {
+        return;
+    }
     ensureDirectoryExists("C_measurements");
     double dynamicAccessTimes[numTests];
     FILE *dynamicAccessFile = fopen("C_measurements/C_dynamic_access.json", "w");
@@ -505,10 +670,17 @@ void DynamicAccessMain(int numTests, double threshold)
     {
         int size = ARRAY_SIZES[j];
         int dynamicSize = 0;
+        uint64_t expected = expectedChecksum("Dynamic Memory Access", j);
+        int mismatches = 0;
 
-        for (int i = 0; i < numTests; i++)
+        for (int i = 0; i < numTests && !cancelRequested(); i++)
         {
             dynamicAccessTimes[dynamicSize++] = measureDynamicMemoryAccess(size);
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
+        {
+            break;
         }
 
         removeOutliers(dynamicAccessTimes, &dynamicSize, threshold);
@@ -517,7 +689,7 @@ void DynamicAccessMain(int numTests, double threshold)
         {
             double dynamicAverage = calculateAverage(dynamicAccessTimes, dynamicSize);
             double dynamicStdDev = calculateStandardDeviation(dynamicAccessTimes, dynamicAverage, dynamicSize);
-            saveResultsToJSON(dynamicAccessFile, dynamicAverage, dynamicStdDev, "Dynamic Memory Access", numTests, dynamicSize, "C", size, threshold, 0, (j == 0));
+            saveResultsToJSON(dynamicAccessFile, dynamicAverage, dynamicStdDev, "Dynamic Memory Access", numTests, dynamicSize, "C", size, threshold, 0, kernelChecksum, mismatches, (j == 0));
         }
         else
         {
@@ -531,6 +703,10 @@ void DynamicAccessMain(int numTests, double threshold)
 
 void AllocationMain(int numTests, double threshold)
 {
+    if (cancelRequested())
+    {
+        return;
+    }
     ensureDirectoryExists("C_measurements");
     double allocTimes[numTests];
     FILE *allocationFile = fopen("C_measurements/C_allocation.json", "w");
@@ -545,10 +721,17 @@ void AllocationMain(int numTests, double threshold)
     {
         int size = ARRAY_SIZES[j];
         int allocSize = 0;
+        uint64_t expected = expectedChecksum("Memory Allocation", j);
+        int mismatches = 0;
 
-        for (int i = 0; i < numTests; i++)
+        for (int i = 0; i < numTests && !cancelRequested(); i++)
         {
             allocTimes[allocSize++] = measureMemoryAllocation(size);
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
+        {
+            break;
         }
 
         removeOutliers(allocTimes, &allocSize, threshold);
@@ -557,7 +740,7 @@ void AllocationMain(int numTests, double threshold)
         {
             double allocAverage = calculateAverage(allocTimes, allocSize);
             double allocStdDev = calculateStandardDeviation(allocTimes, allocAverage, allocSize);
-            saveResultsToJSON(allocationFile, allocAverage, allocStdDev, "Memory Allocation", numTests, allocSize, "C", size, threshold, 0, (j == 0));
+            saveResultsToJSON(allocationFile, allocAverage, allocStdDev, "Memory Allocation", numTests, allocSize, "C", size, threshold, 0, kernelChecksum, mismatches, (j == 0));
         }
         else
         {
@@ -571,6 +754,10 @@ void AllocationMain(int numTests, double threshold)
 
 void DeallocationMain(int numTests, double threshold)
 {
+    if (cancelRequested())
+    {
+        return;
+    }
     ensureDirectoryExists("C_measurements");
     double deallocTimes[numTests];
     FILE *deallocationFile = fopen("C_measurements/C_deallocation.json", "w");
@@ -585,10 +772,17 @@ void DeallocationMain(int numTests, double threshold)
     {
         int size = ARRAY_SIZES[j];
         int deallocSize = 0;
+        uint64_t expected = expectedChecksum("Memory Deallocation", j);
+        int mismatches = 0;
 
-        for (int i = 0; i < numTests; i++)
+        for (int i = 0; i < numTests && !cancelRequested(); i++)
         {
             deallocTimes[deallocSize++] = measureMemoryDeallocation(size);
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
+        {
+            break;
         }
 
         removeOutliers(deallocTimes, &deallocSize, threshold);
@@ -597,7 +791,7 @@ void DeallocationMain(int numTests, double threshold)
         {
             double deallocAverage = calculateAverage(deallocTimes, deallocSize);
             double deallocStdDev = calculateStandardDeviation(deallocTimes, deallocAverage, deallocSize);
-            saveResultsToJSON(deallocationFile, deallocAverage, deallocStdDev, "Memory Deallocation", numTests, deallocSize, "C", size, threshold, 0, (j == 0));
+            saveResultsToJSON(deallocationFile, deallocAverage, deallocStdDev, "Memory Deallocation", numTests, deallocSize, "C", size, threshold, 0, kernelChecksum, mismatches, (j == 0));
         }
         else
         {
@@ -611,6 +805,10 @@ void DeallocationMain(int numTests, double threshold)
 
 void ThreadCreationMain(int numTests, double threshold)
 {
+    if (cancelRequested())
+    {
+        return;
+    }
     ensureDirectoryExists("C_measurements");
     double threadCreationTimes[numTests];
     FILE *threadCreationFile = fopen("C_measurements/C_thread_creation.json", "w");
@@ -625,17 +823,24 @@ void ThreadCreationMain(int numTests, double threshold)
     {
         int iterations = ITERATIONS[iterIndex];
         int creationSize = 0;
+        uint64_t expected = expectedChecksum("Thread Creation", iterIndex);
+        int mismatches = 0;
 
-        for (int i = 0; i < numTests; i++)
+        for (int i = 0; i < numTests && !cancelRequested(); i++)
         {
             threadCreationTimes[creationSize++] = measureThreadCreationTime(iterations);
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
+        {
+            break;
         }
 
         if (creationSize)
         {
             double creationAverage = calculateAverage(threadCreationTimes, creationSize);
             double creationStdDev = calculateStandardDeviation(threadCreationTimes, creationAverage, creationSize);
-            saveResultsToJSON(threadCreationFile, creationAverage, creationStdDev, "Thread Creation", creationSize, numTests, "C", 0, threshold, iterations, (iterIndex == 0));
+            saveResultsToJSON(threadCreationFile, creationAverage, creationStdDev, "Thread Creation", creationSize, numTests, "C", 0, threshold, iterations, kernelChecksum, mismatches, (iterIndex == 0));
         }
         else
         {
@@ -649,6 +854,10 @@ void ThreadCreationMain(int numTests, double threshold)
 
 void ContextSwitchMain(int numTests, double threshold)
 {
+    if (cancelRequested())
+    {
+        return;
+    }
     ensureDirectoryExists("C_measurements");
     double contextSwitchTimes[numTests];
     FILE *contextSwitchFile = fopen("C_measurements/C_context_switch.json", "w");
@@ -663,17 +872,24 @@ void ContextSwitchMain(int numTests, double threshold)
     {
         int iterations = ITERATIONS[iterIndex];
         int contextSwitchSize = 0;
+        uint64_t expected = expectedChecksum("Context Switch", iterIndex);
+        int mismatches = 0;
 
-        for (int i = 0; i < numTests; i++)
+        for (int i = 0; i < numTests && !cancelRequested(); i++)
         {
             contextSwitchTimes[contextSwitchSize++] = measureContextSwitchTime(iterations);
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
+        {
+            break;
         }
 
         if (contextSwitchSize)
         {
             double switchAverage = calculateAverage(contextSwitchTimes, contextSwitchSize);
             double switchStdDev = calculateStandardDeviation(contextSwitchTimes, switchAverage, contextSwitchSize);
-            saveResultsToJSON(contextSwitchFile, switchAverage, switchStdDev, "Context Switch", numTests, contextSwitchSize, "C", 0, threshold, iterations, (iterIndex == 0));
+            saveResultsToJSON(contextSwitchFile, switchAverage, switchStdDev, "Context Switch", numTests, contextSwitchSize, "C", 0, threshold, iterations, kernelChecksum, mismatches, (iterIndex == 0));
         }
         else
         {
@@ -687,6 +903,10 @@ void ContextSwitchMain(int numTests, double threshold)
 
 void ThreadMigrationMain(int numTests, double threshold)
 {
+    if (cancelRequested())
+    {
+        return;
+    }
     ensureDirectoryExists("C_measurements");
     double migrationTimes[numTests];
     FILE *migrationFile = fopen("C_measurements/C_thread_migration.json", "w");
@@ -701,17 +921,24 @@ void ThreadMigrationMain(int numTests, double threshold)
     {
         int iterations = ITERATIONS[iterIndex];
         int migrationSize = 0;
+        uint64_t expected = expectedChecksum("Thread Migration", iterIndex);
+        int mismatches = 0;
 
-        for (int i = 0; i < numTests; i++)
+        for (int i = 0; i < numTests && !cancelRequested(); i++)
         {
             migrationTimes[migrationSize++] = measureThreadMigrationTime(iterations);
+            mismatches += kernelChecksum != expected;
+        }
+        if (cancelRequested())
+        {
+            break;
         }
 
         if (migrationSize)
         {
             double migrationAverage = calculateAverage(migrationTimes, migrationSize);
             double migrationStdDev = calculateStandardDeviation(migrationTimes, migrationAverage, migrationSize);
-            saveResultsToJSON(migrationFile, migrationAverage, migrationStdDev, "Thread Migration", numTests, migrationSize, "C", 0, threshold, iterations, (iterIndex == 0));
+            saveResultsToJSON(migrationFile, migrationAverage, migrationStdDev, "Thread Migration", numTests, migrationSize, "C", 0, threshold, iterations, kernelChecksum, mismatches, (iterIndex == 0));
         }
         else
         {
@@ -743,11 +970,96 @@ void callAll_C_Benchmarks(int numTests, double threshold)
         "C_measurements/C_thread_migration.json"};
     int numFiles = sizeof(filenames) / sizeof(filenames[0]);
 
+    if (cancelRequested())
+    {
+        return;
+    }
     combineJSONFiles("C_measurements/C_results.json", filenames, numFiles);
 }
 
+// One cheap round per benchmark: a single mid-sized point of its sweep.
+double warmUpRound(int benchmarkType)
+{
+    switch (benchmarkType)
+    {
+    case STATIC_ACCESS:
+        return measureStaticMemoryAccess(10000);
+    case DYNAMIC_ACCESS:
+        return measureDynamicMemoryAccess(10000);
+    case ALLOCATION:
+        return measureMemoryAllocation(10000);
+    case DEALLOCATION:
+        return measureMemoryDeallocation(10000);
+    case THREAD_CREATION:
+        return measureThreadCreationTime(10);
+    case CONTEXT_SWITCH:
+        return measureContextSwitchTime(100);
+    case THREAD_MIGRATION:
+        return measureThreadMigrationTime(2);
+    default:
+        return 0.0;
+    }
+}
+
+// Runs warm-up rounds until the mean of the last WARMUP_WINDOW rounds is
+// within tolerance of the window before it. Returns the rounds it took.
+int warmUpBenchmark(int benchmarkType, int maxRounds, double tolerance)
+{
+    double rounds[2 * WARMUP_WINDOW];
+    int round = 0;
+    while (round < maxRounds && !cancelRequested())
+    {
+        rounds[round % (2 * WARMUP_WINDOW)] = warmUpRound(benchmarkType);
+        round++;
+        if (round >= 2 * WARMUP_WINDOW)
+        {
+            double previous = 0.0;
+            double current = 0.0;
+            for (int i = 0; i < WARMUP_WINDOW; i++)
+            {
+                previous += rounds[(round + i) % (2 * WARMUP_WINDOW)];
+                current += rounds[(round + WARMUP_WINDOW + i) % (2 * WARMUP_WINDOW)];
+            }
+            if (fabs(current - previous) <= tolerance * previous)
+            {
+                break;
+            }
+        }
+    }
+    return round;
+}
+
+JNIEXPORT jint JNICALL Java_JNInterface_warmUpNative_1C_1Benchmark(JNIEnv *env, jobject obj, jint benchmarkType, jint maxRounds, jdouble tolerance)
+{
+    // JNI overhead (8) and false sharing (9) only exist in the C++ library.
+    if (benchmarkType == 8 || benchmarkType == 9)
+        return 0;
+    if (benchmarkType < ALL || benchmarkType > THREAD_MIGRATION)
+    {
+        fprintf(stderr, "Invalid benchmark type\n");
+        return 0;
+    }
+    if (benchmarkType != ALL)
+    {
+        return warmUpBenchmark(benchmarkType, maxRounds, tolerance);
+    }
+
+    int rounds = 0;
+    for (int type = STATIC_ACCESS; type <= THREAD_MIGRATION; type++)
+    {
+        rounds += warmUpBenchmark(type, maxRounds, tolerance);
+    }
+    return rounds;
+}
+
 JNIEXPORT void JNICALL Java_JNInterface_callNative_1C_1Benchmark(JNIEnv *env, jobject obj, jint benchmarkType, jint numTests, jdouble threshold)
 {
+    if (!loadKernelSpec())
+    {
+        (*env)->ThrowNew(env, (*env)->FindClass(env, "java/lang/IllegalStateException"),
+                         "C kernel spec is missing or does not match this library; set KERNEL_SPEC to kernel_spec.json");
+        return;
+    }
     switch (benchmarkType)
     {
     case ALL:
@@ -779,3 +1091,13 @@ JNIEXPORT void JNICALL Java_JNInterface_callNative_1C_1Benchmark(JNIEnv *env, jo
         exit(EXIT_FAILURE);
     }
 }
+
+JNIEXPORT void JNICALL Java_JNInterface_prepareNative_1C_1Benchmark(JNIEnv *env, jobject obj)
+{
+    atomic_store_explicit(&cancelled, 0, memory_order_relaxed);
+}
+
+JNIEXPORT void JNICALL Java_JNInterface_cancelNative_1C_1Benchmark(JNIEnv *env, jobject obj)
+{
+    atomic_store_explicit(&cancelled, 1, memory_order_relaxed);
+}
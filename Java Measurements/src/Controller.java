@@ -1,41 +1,105 @@
+import java.io.File;
+import java.io.IOException;
+import java.util.ArrayList;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+
 public class Controller {
     private BenchmarkEngine benchmarkEngine;
     private BenchmarkStorage benchmarkStorage;
     private GraphGenerator graphGenerator;
+    private volatile ResultListener progressListener;
 
     public Controller() {
         this.benchmarkEngine = new BenchmarkEngine();
         this.benchmarkStorage = new BenchmarkStorage();
         this.graphGenerator = new GraphGenerator();
+        benchmarkEngine.setResultListener(this::onResult);
+    }
+
+    private void onResult(BenchmarkResult result) {
+        benchmarkStorage.addResult(result);
+        ResultListener listener = progressListener;
+        if (listener != null) {
+            listener.onResult(result);
+        }
+    }
+
+    public void setProgressListener(ResultListener listener) {
+        this.progressListener = listener;
     }
 
     public void runBenchmark(String language, int benchmarkType, int numTests, double threshold) throws InterruptedException {
         benchmarkEngine.runBenchmark(language, benchmarkType, numTests, threshold);
     }
 
+    public void prepareRun() {
+        benchmarkEngine.prepareRun();
+    }
+
+    public void cancelBenchmark() {
+        benchmarkEngine.cancelBenchmark();
+    }
+
+    public int[] getNativeProgress() {
+        return benchmarkEngine.getNativeProgress();
+    }
+
+    public int warmUp(String language, int benchmarkType) throws InterruptedException {
+        return benchmarkEngine.warmUp(language, benchmarkType);
+    }
+
     public void loadResults(String language, int benchmarkType) {
-        String filePath = getBenchmarkFilePath(language, benchmarkType);
-        if (filePath != null) {
-            benchmarkStorage.loadFromJsonFile(filePath);
-        } else {
+        if (benchmarkEngine.streamsResults(language)) {
+            return;
+        }
+        String basePath = getBenchmarkFileBase(language, benchmarkType);
+        if (basePath == null) {
             System.out.println("Invalid benchmark type");
+            return;
+        }
+        // A run only rewrites the formats it was asked for, so the other one
+        // may be left over from an earlier run: load whichever is newer.
+        File binary = new File(basePath + ".bin");
+        File json = new File(basePath + ".json");
+        if (binary.exists() && (!json.exists() || binary.lastModified() >= json.lastModified())) {
+            benchmarkStorage.loadFromBinaryFile(binary.getPath());
+        } else {
+            benchmarkStorage.loadFromJsonFile(json.getPath());
         }
     }
 
-    private String getBenchmarkFilePath(String language, int benchmarkType) {
+    private String getBenchmarkFileBase(String language, int benchmarkType) {
         switch (benchmarkType) {
-            case 0: return language + "_measurements/" + language + "_results.json";
-            case 1: return language + "_measurements/" + language + "_static_access.json";
-            case 2: return language + "_measurements/" + language + "_dynamic_access.json";
-            case 3: return language + "_measurements/" + language + "_allocation.json";
-            case 4: return language + "_measurements/" + language + "_deallocation.json";
-            case 5: return language + "_measurements/" + language + "_thread_creation.json";
-            case 6: return language + "_measurements/" + language + "_context_switch.json";
-            case 7: return language + "_measurements/" + language + "_thread_migration.json";
+            case 0: return language + "_measurements/" + language + "_results";
+            case 1: return language + "_measurements/" + language + "_static_access";
+            case 2: return language + "_measurements/" + language + "_dynamic_access";
+            case 3: return language + "_measurements/" + language + "_allocation";
+            case 4: return language + "_measurements/" + language + "_deallocation";
+            case 5: return language + "_measurements/" + language + "_thread_creation";
+            case 6: return language + "_measurements/" + language + "_context_switch";
+            case 7: return language + "_measurements/" + language + "_thread_migration";
+            case 8: return language + "_measurements/" + language + "_jni_overhead";
+            case 9: return language + "_measurements/" + language + "_false_sharing";
             default: return null;
         }
     }
 
+    // Loads a merged compiler comparison file and returns the benchmarks it covers.
+    public List<String> loadCompilerResults(String filePath) {
+        int firstResult = benchmarkStorage.getResults().size();
+        benchmarkStorage.loadFromJsonFile(filePath);
+        List<BenchmarkResult> results = benchmarkStorage.getResults();
+        List<String> measurements = new ArrayList<>();
+        for (BenchmarkResult result : results.subList(firstResult, results.size())) {
+            if (!measurements.contains(result.getProcessMeasured())) {
+                measurements.add(result.getProcessMeasured());
+            }
+        }
+        return measurements;
+    }
+
     public void generateGraph(String measurement) {
         graphGenerator.createAndShowGraph(measurement, benchmarkStorage);
     }
@@ -44,6 +108,43 @@ public class Controller {
         return benchmarkStorage;
     }
 
+    // Compares the checksums of every result stored since firstResult with
+    // kernel_spec.json and with the other languages that measured the same
+    // point. Returns one line per disagreement.
+    public List<String> crossCheckChecksums(int firstResult) {
+        List<String> problems = new ArrayList<>();
+        KernelSpec spec;
+        try {
+            spec = KernelSpec.load();
+        } catch (IOException e) {
+            problems.add("Could not load kernel spec: " + e.getMessage());
+            return problems;
+        }
+
+        List<BenchmarkResult> results = benchmarkStorage.getResults();
+        Map<String, BenchmarkResult> firstByPoint = new LinkedHashMap<>();
+        for (BenchmarkResult result : results.subList(firstResult, results.size())) {
+            String parameter = spec.parameterOf(result.getProcessMeasured());
+            if (parameter == null || result.getChecksum() == -1) {
+                continue;
+            }
+            int point = parameter.equals("array_size") ? result.getArraySize() : result.getIterations();
+            String where = String.format("%s %s, %s %d", result.getProgrammingLanguage(), result.getProcessMeasured(), parameter, point);
+
+            long expected = spec.expectedChecksum(result.getProcessMeasured(), point);
+            if (expected != -1 && result.getChecksum() != expected) {
+                problems.add(String.format("%s: checksum %d, spec expects %d", where, result.getChecksum(), expected));
+            }
+            BenchmarkResult first = firstByPoint.putIfAbsent(result.getProcessMeasured() + "/" + point, result);
+            if (first != null && first.getChecksum() != result.getChecksum()
+                    && !first.getProgrammingLanguage().equals(result.getProgrammingLanguage())) {
+                problems.add(String.format("%s: checksum %d, %s got %d", where, result.getChecksum(),
+                        first.getProgrammingLanguage(), first.getChecksum()));
+            }
+        }
+        return problems;
+    }
+
     public void printResults() {
         benchmarkStorage.printResults();
     }
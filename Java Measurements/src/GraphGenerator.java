@@ -18,41 +18,78 @@ import java.awt.*;
 import java.io.File;
 import java.io.FileWriter;
 import java.io.IOException;
+import java.util.HashMap;
 import java.util.HashSet;
 import java.util.List;
+import java.util.Map;
 import java.util.Set;
 
 public class GraphGenerator {
 
     public void createAndShowGraph(String measurement, BenchmarkStorage benchmarkStorage) {
-        DefaultCategoryDataset dataset = createDataset(measurement, benchmarkStorage, false);
+        boolean byCompiler = hasSeveralCompilers(benchmarkStorage.getResults(), measurement);
+        DefaultCategoryDataset dataset = createDataset(measurement, benchmarkStorage, false, byCompiler);
         JFreeChart lineChart = createLineChart(dataset, measurement);
         JFreeChart barChart = createBarChart(dataset, measurement);
-        displayChart(lineChart, barChart,dataset, measurement, benchmarkStorage);
+        displayChart(lineChart, barChart,dataset, measurement, benchmarkStorage, byCompiler);
     }
 
 
-    private DefaultCategoryDataset createDataset(String measurement, BenchmarkStorage benchmarkStorage, boolean showStandardDeviation) {
+    private DefaultCategoryDataset createDataset(String measurement, BenchmarkStorage benchmarkStorage, boolean showStandardDeviation, boolean byCompiler) {
         DefaultCategoryDataset dataset = new DefaultCategoryDataset();
-        addDataToDataset(dataset, benchmarkStorage.getResults(), measurement, showStandardDeviation);
+        addDataToDataset(dataset, benchmarkStorage.getResults(), measurement, showStandardDeviation, byCompiler);
         return dataset;
     }
 
-    private void addDataToDataset(DefaultCategoryDataset dataset, List<BenchmarkResult> results, String measurement, boolean showStandardDeviation) {
+    private void addDataToDataset(DefaultCategoryDataset dataset, List<BenchmarkResult> results, String measurement, boolean showStandardDeviation, boolean byCompiler) {
         for (BenchmarkResult result : results) {
             if (result.getProcessMeasured().equals(measurement)) {
-                String xValue = (measurement.contains("Thread") || measurement.contains("Context"))
+                String xValue = sweepsIterations(measurement)
                         ? String.valueOf(result.getIterations())
                         : String.valueOf(result.getArraySize());
                 double value = showStandardDeviation ? result.getStdDeviation() : result.getAverageTime();
-                dataset.addValue(value, result.getProgrammingLanguage(), xValue);
+                dataset.addValue(value, seriesKey(result, byCompiler), xValue);
             }
         }
     }
+
+    // False sharing results keep their thread count in the iterations column.
+    private boolean sweepsIterations(String measurement) {
+        return measurement.contains("Thread") || measurement.contains("Context") || measurement.startsWith("False Sharing");
+    }
+
+    private String xAxisLabel(String measurement) {
+        if (measurement.startsWith("False Sharing")) {
+            return "Threads";
+        }
+        return sweepsIterations(measurement) ? "Iterations" : "Array Size";
+    }
+
+    // One series per language, or per language and compiler when comparing
+    // builds of the same kernels.
+    private String seriesKey(BenchmarkResult result, boolean byCompiler) {
+        if (!byCompiler || result.getCompiler().isEmpty()) {
+            return result.getProgrammingLanguage();
+        }
+        return result.getProgrammingLanguage() + " (" + result.getCompiler() + ")";
+    }
+
+    private boolean hasSeveralCompilers(List<BenchmarkResult> results, String measurement) {
+        Map<String, String> compilerByLanguage = new HashMap<>();
+        for (BenchmarkResult result : results) {
+            if (result.getProcessMeasured().equals(measurement) && !result.getCompiler().isEmpty()) {
+                String previous = compilerByLanguage.putIfAbsent(result.getProgrammingLanguage(), result.getCompiler());
+                if (previous != null && !previous.equals(result.getCompiler())) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
     private JFreeChart createLineChart(DefaultCategoryDataset dataset, String measurement) {
         JFreeChart chart = ChartFactory.createLineChart(
                 measurement + " Comparison",
-                measurement.contains("Thread") || measurement.contains("Context") ? "Iterations" : "Array Size",
+                xAxisLabel(measurement),
                 "Average Time (ns)",
                 dataset,
                 PlotOrientation.VERTICAL,
@@ -74,7 +111,7 @@ public class GraphGenerator {
     private JFreeChart createBarChart(DefaultCategoryDataset dataset, String measurement) {
         JFreeChart chart = ChartFactory.createBarChart(
                 measurement + " Comparison",
-                measurement.contains("Thread") || measurement.contains("Context") ? "Iterations" : "Array Size",
+                xAxisLabel(measurement),
                 "Average Time (ns)",
                 dataset,
                 PlotOrientation.VERTICAL,
@@ -90,7 +127,7 @@ public class GraphGenerator {
             String series = (String) dataset1.getRowKey(row);
             String category = (String) dataset1.getColumnKey(column);
             Number value = dataset1.getValue(row, column);
-            return String.format("<html>Language: %s<br>Category: %s<br>Value: %.2f</html>", series, category, value.doubleValue());
+            return String.format("<html>Series: %s<br>Category: %s<br>Value: %.2f</html>", series, category, value.doubleValue());
         });
 
         plot.setRenderer(renderer);
@@ -118,7 +155,7 @@ public class GraphGenerator {
         legend.setPosition(RectangleEdge.BOTTOM);
         legend.setItemFont(new Font("Arial", Font.PLAIN, 12));
     }
-    private void displayChart(JFreeChart lineChart, JFreeChart barChart,DefaultCategoryDataset dataset, String measurement, BenchmarkStorage benchmarkStorage) {
+    private void displayChart(JFreeChart lineChart, JFreeChart barChart,DefaultCategoryDataset dataset, String measurement, BenchmarkStorage benchmarkStorage, boolean compilerSeries) {
         JFrame frame = new JFrame(measurement + " Chart");
         frame.setDefaultCloseOperation(JFrame.DISPOSE_ON_CLOSE);
 
@@ -133,7 +170,7 @@ public class GraphGenerator {
             String series = (String) dataset1.getRowKey(row);
             String category = (String) dataset1.getColumnKey(column);
             Number value = dataset1.getValue(row, column);
-            return String.format("<html>Language: %s<br>Category: %s<br>Value: %.2f</html>", series, category, value.doubleValue());
+            return String.format("<html>Series: %s<br>Category: %s<br>Value: %.2f</html>", series, category, value.doubleValue());
         });
 
         final JFreeChart[] currentChart = {lineChart};
@@ -230,12 +267,13 @@ public class GraphGenerator {
         });
 
 
+        final boolean[] byCompiler = {compilerSeries};
         JComboBox<String> metricSelector = new JComboBox<>(new String[]{"Average Time", "Standard Deviation"});
         metricSelector.addActionListener(e -> {
             boolean showStandardDeviation = metricSelector.getSelectedItem().equals("Standard Deviation");
 
             dataset.clear();
-            addDataToDataset(dataset, benchmarkStorage.getResults(), measurement, showStandardDeviation);
+            addDataToDataset(dataset, benchmarkStorage.getResults(), measurement, showStandardDeviation, byCompiler[0]);
 
             String yAxisLabel = showStandardDeviation ? "Standard Deviation" : "Average Time (ns)";
             lineChart.getCategoryPlot().getRangeAxis().setLabel(yAxisLabel);
@@ -250,36 +288,69 @@ public class GraphGenerator {
 
 
         JPanel filterPanel = new JPanel();
-        Set<String> languages = new HashSet<>();
-        for (BenchmarkResult result : benchmarkStorage.getResults()) {
-            languages.add(result.getProgrammingLanguage());
-        }
-        for (String language : languages) {
-            JCheckBox checkBox = new JCheckBox(language, true);
-            checkBox.addItemListener(e -> {
-                boolean visible = checkBox.isSelected();
-                int seriesIndex = dataset.getRowIndex(language);
+        Runnable rebuildFilters = () -> {
+            filterPanel.removeAll();
+            Set<String> seriesKeys = new HashSet<>();
+            for (BenchmarkResult result : benchmarkStorage.getResults()) {
+                if (result.getProcessMeasured().equals(measurement)) {
+                    seriesKeys.add(seriesKey(result, byCompiler[0]));
+                }
+            }
+            for (String series : seriesKeys) {
+                JCheckBox checkBox = new JCheckBox(series, true);
+                checkBox.addItemListener(e -> {
+                    boolean visible = checkBox.isSelected();
+                    int seriesIndex = dataset.getRowIndex(series);
 
-                LineAndShapeRenderer lineRenderer = (LineAndShapeRenderer) lineChart.getCategoryPlot().getRenderer();
-                BarRenderer barRenderer = (BarRenderer) barChart.getCategoryPlot().getRenderer();
-                lineRenderer.setSeriesVisible(seriesIndex, visible);
-                barRenderer.setSeriesVisible(seriesIndex, visible);
+                    LineAndShapeRenderer lineRenderer = (LineAndShapeRenderer) lineChart.getCategoryPlot().getRenderer();
+                    BarRenderer barRenderer = (BarRenderer) barChart.getCategoryPlot().getRenderer();
+                    lineRenderer.setSeriesVisible(seriesIndex, visible);
+                    barRenderer.setSeriesVisible(seriesIndex, visible);
 
-                double newMaxValue = getMaxValue.apply(dataset);
-                rangeSlider.setMaximum((int) Math.ceil(newMaxValue));
-                rangeSlider.setValue((int) Math.ceil(newMaxValue));
+                    double newMaxValue = getMaxValue.apply(dataset);
+                    rangeSlider.setMaximum((int) Math.ceil(newMaxValue));
+                    rangeSlider.setValue((int) Math.ceil(newMaxValue));
 
-                currentChart[0].setNotify(true);
-            });
+                    currentChart[0].setNotify(true);
+                });
 
-            filterPanel.add(checkBox);
-        }
+                filterPanel.add(checkBox);
+            }
+            filterPanel.revalidate();
+            filterPanel.repaint();
+        };
+        rebuildFilters.run();
+
+        JComboBox<String> seriesSelector = new JComboBox<>(new String[]{"Language", "Compiler"});
+        seriesSelector.setSelectedIndex(compilerSeries ? 1 : 0);
+        seriesSelector.addActionListener(e -> {
+            byCompiler[0] = seriesSelector.getSelectedIndex() == 1;
+            boolean showStandardDeviation = metricSelector.getSelectedItem().equals("Standard Deviation");
+
+            dataset.clear();
+            addDataToDataset(dataset, benchmarkStorage.getResults(), measurement, showStandardDeviation, byCompiler[0]);
+            LineAndShapeRenderer lineRenderer = (LineAndShapeRenderer) lineChart.getCategoryPlot().getRenderer();
+            BarRenderer barRenderer = (BarRenderer) barChart.getCategoryPlot().getRenderer();
+            for (int row = 0; row < dataset.getRowCount(); row++) {
+                lineRenderer.setSeriesVisible(row, true);
+                barRenderer.setSeriesVisible(row, true);
+            }
+            rebuildFilters.run();
+
+            double newMaxValue = getMaxValue.apply(dataset);
+            rangeSlider.setMaximum((int) Math.ceil(newMaxValue));
+            rangeSlider.setValue((int) Math.ceil(newMaxValue));
+
+            currentChart[0].setNotify(true);
+        });
 
         JPanel controlPanel = new JPanel();
         controlPanel.add(new JLabel("Select Chart Type:"));
         controlPanel.add(chartTypeSelector);
         controlPanel.add(new JLabel("Select Metric:"));
         controlPanel.add(metricSelector);
+        controlPanel.add(new JLabel("Series:"));
+        controlPanel.add(seriesSelector);
         controlPanel.add(new JLabel("Filters:"));
         controlPanel.add(filterPanel);
         controlPanel.add(exportButton);
@@ -1,11 +1,112 @@
+import java.nio.ByteBuffer;
+
 public class JNInterface {
+    public static final int OUTPUT_JSON = 1;
+    public static final int OUTPUT_BINARY = 2;
+    public static final int JNI_OVERHEAD = 8;
+    public static final int FALSE_SHARING = 9;
+
+    private int sink;
 
     static {
         System.loadLibrary("mynative_c");
         System.loadLibrary("mynative_cpp");
     }
 
+    // Both throw IllegalStateException if kernel_spec.json is missing or
+    // sweeps different parameters than the library.
     public native void callNative_C_Benchmark(int benchmarkType, int numTests, double threshold);
 
     public native void callNative_Cpp_Benchmark(int benchmarkType, int numTests, double threshold);
+
+    public native int warmUpNative_C_Benchmark(int benchmarkType, int maxRounds, double tolerance);
+
+    public native int warmUpNative_Cpp_Benchmark(int benchmarkType, int maxRounds, double tolerance);
+
+    public native void setNative_Cpp_OutputFormat(int format);
+
+    public native void setNative_Cpp_ResultListener(ResultListener listener);
+
+    // prepare clears a pending cancel when a run is queued; cancel stops the
+    // running benchmark or warm-up after its current sample.
+    public native void prepareNative_C_Benchmark();
+
+    public native void cancelNative_C_Benchmark();
+
+    public native void prepareNative_Cpp_Benchmark();
+
+    public native void cancelNative_Cpp_Benchmark();
+
+    // Fills {benchmark, size or iterations, sample, completed points, total points}.
+    public native void getNative_Cpp_Progress(int[] progress);
+
+    // JNI overhead benchmarks. callNative_Cpp_Benchmark(JNI_OVERHEAD, ...) calls
+    // these timing loops once per sample, so every timed call crosses from Java
+    // into the C++ library. Each returns the elapsed nanoseconds.
+    private native void jniEmpty();
+
+    private native int jniPrimitiveArgs(int a, long b, double c);
+
+    private native long jniSumArrayElements(int[] data);
+
+    private native long jniSumArrayCritical(int[] data);
+
+    private native long jniSumDirectBuffer(ByteBuffer buffer);
+
+    private long timeEmptyCalls(int calls) {
+        long start = System.nanoTime();
+        for (int i = 0; i < calls; i++) {
+            jniEmpty();
+        }
+        return System.nanoTime() - start;
+    }
+
+    private long timePrimitiveCalls(int calls) {
+        int result = 0;
+        long start = System.nanoTime();
+        for (int i = 0; i < calls; i++) {
+            result += jniPrimitiveArgs(i, i, i);
+        }
+        long elapsed = System.nanoTime() - start;
+        sink += result;
+        return elapsed;
+    }
+
+    private long timeArrayElements(int[] data, int calls) {
+        long result = 0;
+        long start = System.nanoTime();
+        for (int i = 0; i < calls; i++) {
+            result += jniSumArrayElements(data);
+        }
+        long elapsed = System.nanoTime() - start;
+        sink += (int) result;
+        return elapsed;
+    }
+
+    private long timeArrayCritical(int[] data, int calls) {
+        long result = 0;
+        long start = System.nanoTime();
+        for (int i = 0; i < calls; i++) {
+            result += jniSumArrayCritical(data);
+        }
+        long elapsed = System.nanoTime() - start;
+        sink += (int) result;
+        return elapsed;
+    }
+
+    private long timeDirectBuffer(ByteBuffer buffer, int calls) {
+        long result = 0;
+        long start = System.nanoTime();
+        for (int i = 0; i < calls; i++) {
+            result += jniSumDirectBuffer(buffer);
+        }
+        long elapsed = System.nanoTime() - start;
+        sink += (int) result;
+        return elapsed;
+    }
+
+    // Target of the native-to-Java callback case.
+    private void onCallback(int value) {
+        sink += value;
+    }
 }
@@ -0,0 +1,70 @@
+import org.json.JSONArray;
+import org.json.JSONObject;
+
+import java.io.IOException;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+
+// kernel_spec.json: the sweeps, loop semantics and expected checksums every
+// harness must match. KERNEL_SPEC in the environment overrides its path, the
+// same way it does for the native libraries.
+public class KernelSpec {
+    private static final String DEFAULT_PATH = "../../kernel_spec.json";
+    private final JSONObject spec;
+
+    private KernelSpec(JSONObject spec) {
+        this.spec = spec;
+    }
+
+    public static KernelSpec load() throws IOException {
+        String path = System.getenv().getOrDefault("KERNEL_SPEC", DEFAULT_PATH);
+        return new KernelSpec(new JSONObject(new String(Files.readAllBytes(Paths.get(path)))));
+    }
+
+    public boolean sweepMatches(String name, int[] values) {
+        JSONArray sweep = spec.getJSONArray(name);
+        if (sweep.length() != values.length) {
+            return false;
+        }
+        for (int i = 0; i < values.length; i++) {
+            if (sweep.getInt(i) != values[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Sweep parameter a process is measured over, "array_size" or
+    // "iterations", or null if the spec has no kernel for it.
+    public String parameterOf(String process) {
+        JSONObject kernel = kernel(process);
+        return kernel == null ? null : kernel.getString("parameter");
+    }
+
+    // Checksum every harness must produce for one point, or -1 if the spec
+    // does not cover it.
+    public long expectedChecksum(String process, int parameter) {
+        JSONObject kernel = kernel(process);
+        if (kernel == null) {
+            return -1;
+        }
+        JSONArray sweep = spec.getJSONArray(kernel.getString("parameter").equals("array_size") ? "array_sizes" : "iterations");
+        JSONArray expected = kernel.getJSONArray("expected");
+        for (int point = 0; point < sweep.length() && point < expected.length(); point++) {
+            if (sweep.getInt(point) == parameter) {
+                return expected.getLong(point);
+            }
+        }
+        return -1;
+    }
+
+    private JSONObject kernel(String process) {
+        JSONArray kernels = spec.getJSONArray("kernels");
+        for (int k = 0; k < kernels.length(); k++) {
+            if (kernels.getJSONObject(k).getString("process").equals(process)) {
+                return kernels.getJSONObject(k);
+            }
+        }
+        return null;
+    }
+}
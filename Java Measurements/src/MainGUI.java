@@ -15,12 +15,40 @@ public class MainGUI extends JFrame {
     private JTextField thresholdField;
     private JProgressBar progressBar;
     private final Map<String, String> benchmarkExplanations;
-    private boolean isBenchmarkInProgress = false;
+    private volatile boolean isBenchmarkInProgress = false;
+    private volatile boolean isCancelRequested = false;
+    private static final String[] JNI_OVERHEAD_CASES = {
+            "JNI Empty Call", "JNI Primitive Call", "JNI GetIntArrayElements",
+            "JNI GetPrimitiveArrayCritical", "JNI Direct ByteBuffer", "JNI Callback"
+    };
+    private static final String[] USER_SPACE_SWITCHES = {
+            "Context Switch: Coroutine", "Context Switch: Fiber (swapcontext)",
+            "Context Switch: Fiber (Assembly)", "Context Switch: Fiber Scheduler, 2 Fibers",
+            "Context Switch: Fiber Scheduler, 16 Fibers", "Context Switch: Fiber Scheduler, 256 Fibers"
+    };
+    private static final String[] FALSE_SHARING_LAYOUTS = {
+            "False Sharing: Packed", "False Sharing: 64-Byte Padded",
+            "False Sharing: 128-Byte Padded", "False Sharing: Thread-Local"
+    };
 
     public MainGUI() {
         controller = new Controller();
         benchmarkExplanations = loadBenchmarkExplanations();
         setupUI();
+        controller.setProgressListener(result -> SwingUtilities.invokeLater(() -> logResult(result)));
+    }
+
+    private void logResult(BenchmarkResult result) {
+        String point = result.getArraySize() > 0
+                ? "size " + result.getArraySize()
+                : result.getIterations() + (result.getProcessMeasured().startsWith("False Sharing") ? " threads" : " iterations");
+        String gc = result.getGcTime() > 0
+                ? String.format(" (+%.6f ns GC)", result.getGcTime())
+                : "";
+        logArea.append(String.format("%s %s, %s: %.6f ns%s (%d/%d tests passed)%n",
+                result.getProgrammingLanguage(), result.getProcessMeasured(), point,
+                result.getAverageTime(), gc, result.getPassedTests(), result.getNumberOfTests()));
+        logArea.setCaretPosition(logArea.getDocument().getLength());
     }
 
     private JButton createStyledButton(String text, Color backgroundColor) {
@@ -61,7 +89,7 @@ public class MainGUI extends JFrame {
         String[] benchmarks = {
                 "All Benchmarks", "Static Memory Access", "Dynamic Memory Access",
                 "Memory Allocation", "Memory Deallocation", "Thread Creation",
-                "Context Switch", "Thread Migration"
+                "Context Switch", "Thread Migration", "JNI Overhead", "False Sharing"
         };
 
         for (String benchmark : benchmarks) {
@@ -153,6 +181,18 @@ public class MainGUI extends JFrame {
         helpButton.addActionListener(e -> showHelpDialog());
         inputPanel.add(helpButton, gbc);
 
+        gbc.gridx = 0;
+        gbc.gridy = 3;
+        gbc.gridwidth = 2;
+        JButton cancelButton = createStyledButton("Cancel", new Color(255, 160, 122));
+        cancelButton.addActionListener(e -> cancelBenchmark());
+        inputPanel.add(cancelButton, gbc);
+
+        gbc.gridy = 4;
+        JButton compilersButton = createStyledButton("Load Compiler Comparison", new Color(221, 160, 221));
+        compilersButton.addActionListener(e -> loadCompilerComparison());
+        inputPanel.add(compilersButton, gbc);
+
         mainPanel.add(inputPanel, BorderLayout.NORTH);
 
         // Tabbed Pane
@@ -381,6 +421,8 @@ public class MainGUI extends JFrame {
                         + "<li><b>C and C++:</b> Minimal overhead due to direct OS calls for context switching. Performance depends on OS efficiency.</li>"
                         + "<li><b>Java:</b> Context switching is managed by the JVM and operating system. JVM adds slight overhead to manage thread safety and scheduling.</li>"
                         + "</ul>"
+                        + "<h3 style='color:darkgreen;'>User-Space Switches (C++)</h3>"
+                        + "<p>The C++ library also measures switches that never enter the kernel: a symmetric C++20 coroutine handoff (when built as C++20), a <code>swapcontext</code> fiber, a hand-written assembly fiber and a round-robin fiber scheduler with 2, 16 and 256 fibers. They are reported in the same ns per switch.</p>"
                         + "<h3 style='color:darkred;'>Key Takeaway</h3>"
                         + "<p>Low-level languages like <b>C</b> and <b>C++</b> offer faster context switching for all iterations, while <b>Java</b> incurs additional JVM overhead at less iterations but as iterations increase it catches up with the other languages.</p>"
                         + "</body></html>");
@@ -398,32 +440,96 @@ public class MainGUI extends JFrame {
                         + "<p>Thread migration is almost equally fast in all 3 languages, but it is much slower as iterations increase.</p>"
                         + "</body></html>");
 
+        explanations.put("JNI Overhead",
+                "<html><body style='font-family:sans-serif; padding:10px;'>"
+                        + "<h2 style='color:darkblue;'>JNI Overhead</h2>"
+                        + "<p>JNI overhead measures the cost of crossing between Java and the C++ library, in nanoseconds per call, for every array size.</p>"
+                        + "<h3 style='color:darkgreen;'>Cases</h3>"
+                        + "<ul>"
+                        + "<li><b>Empty and primitive calls:</b> The bare cost of a Java-to-native transition, with the array size used as the number of back-to-back calls.</li>"
+                        + "<li><b>GetIntArrayElements vs GetPrimitiveArrayCritical:</b> Passing an int[] of the given size; the first may copy the array, the second pins it and blocks the GC while held.</li>"
+                        + "<li><b>Direct ByteBuffer:</b> Native code reads memory it shares with Java, with no copy and no pinning.</li>"
+                        + "<li><b>Callback:</b> Native code calling a Java method, the reverse crossing.</li>"
+                        + "</ul>"
+                        + "<h3 style='color:darkred;'>Key Takeaway</h3>"
+                        + "<p>Only the C++ library is measured, since the crossing itself is what is being compared.</p>"
+                        + "</body></html>");
+
+        explanations.put("False Sharing",
+                "<html><body style='font-family:sans-serif; padding:10px;'>"
+                        + "<h2 style='color:darkblue;'>False Sharing</h2>"
+                        + "<p>False sharing measures what it costs when threads update separate counters that live on the same cache line, in nanoseconds per increment across all threads, for 1 to N threads.</p>"
+                        + "<h3 style='color:darkgreen;'>Layouts</h3>"
+                        + "<ul>"
+                        + "<li><b>Packed:</b> The counters sit next to each other, so every increment pulls the line away from the other cores.</li>"
+                        + "<li><b>64-byte padded:</b> One cache line per counter.</li>"
+                        + "<li><b>128-byte padded:</b> Two lines per counter, out of reach of the adjacent-line prefetcher.</li>"
+                        + "<li><b>Thread-local:</b> Each thread counts on its own stack and publishes the total once.</li>"
+                        + "</ul>"
+                        + "<h3 style='color:darkred;'>Key Takeaway</h3>"
+                        + "<p>Packed counters get slower as threads are added, while padded and thread-local ones scale.</p>"
+                        + "</body></html>");
+
         return explanations;
     }
 
 
+    // Opens the C++_compilers.json written by the compare-compilers build
+    // target and plots each benchmark in it with one series per compiler.
+    private void loadCompilerComparison() {
+        JFileChooser fileChooser = new JFileChooser(new java.io.File("../.."));
+        fileChooser.setFileFilter(new javax.swing.filechooser.FileNameExtensionFilter("JSON results", "json"));
+        if (fileChooser.showOpenDialog(this) != JFileChooser.APPROVE_OPTION) {
+            return;
+        }
+        java.util.List<String> measurements = controller.loadCompilerResults(fileChooser.getSelectedFile().getPath());
+        logArea.append("Loaded compiler comparison for " + measurements.size() + " benchmark(s).\n");
+        for (String measurement : measurements) {
+            controller.generateGraph(measurement);
+        }
+    }
+
+    private void cancelBenchmark() {
+        if (!isBenchmarkInProgress) {
+            return;
+        }
+        isCancelRequested = true;
+        controller.cancelBenchmark();
+        logArea.append("Cancelling after the current sample...\n");
+    }
+
     private void startBenchmark(String benchmark) {
         if (isBenchmarkInProgress) {
             logArea.append("Benchmarking is already in progress. Please wait for the current benchmark to complete.\n");
             return;
         }
+        // Set before the worker starts, so a Cancel pressed while it is still
+        // queued is seen by the warm-ups and the benchmarks.
+        isBenchmarkInProgress = true;
+        isCancelRequested = false;
+        controller.prepareRun();
         SwingWorker<Void, String> worker = new SwingWorker<>() {
             @Override
             protected Void doInBackground() {
                 try {
-                    isBenchmarkInProgress = true;
                     int numTests = Integer.parseInt(numTestsField.getText());
                     double threshold = Double.parseDouble(thresholdField.getText());
 
-                    publish("Running warm-up...");
-                    controller.runBenchmark("C", 0, numTests, threshold);
-                    publish("Warm-up completed.");
+                    for (String language : getLanguages(benchmark)) {
+                        if (isCancelRequested) {
+                            break;
+                        }
+                        publish("Warming up " + language + "...");
+                        int rounds = controller.warmUp(language, getBenchmarkType(benchmark));
+                        publish(language + " warm-up completed after " + rounds + " rounds.");
+                    }
 
                     publish("Running " + benchmark + "...");
                     runBenchmarkForAllLanguages(benchmark, numTests, threshold);
                     //publish(benchmark + " completed.");
                 } catch (Exception ex) {
                     publish("Error: " + ex.getMessage());
+                    isBenchmarkInProgress = false;
                 }
                 return null;
             }
@@ -449,11 +555,21 @@ public class MainGUI extends JFrame {
         SwingWorker<Void, Integer> worker = new SwingWorker<>() {
             @Override
             protected Void doInBackground() {
-                String[] languages = {"C++", "C", "Java"};
+                String[] languages = getLanguages(benchmark);
                 int totalSteps = languages.length;
                 int step = 0;
+                int firstResult = controller.getBenchmarkStorage().getResults().size();
 
                 for (String language : languages) {
+                    if (isCancelRequested) {
+                        break;
+                    }
+                    // The C++ library reports progress per sample; poll it while it runs.
+                    int languageStep = step;
+                    Timer poller = new Timer(100, e -> showNativeProgress(languageStep, totalSteps, numTests));
+                    if (language.equals("C++")) {
+                        poller.start();
+                    }
                     try {
                         controller.runBenchmark(language, getBenchmarkType(benchmark), numTests, threshold);
                         controller.loadResults(language, getBenchmarkType(benchmark));
@@ -462,9 +578,21 @@ public class MainGUI extends JFrame {
                         publish(progress);
                     } catch (Exception ex) {
                         logArea.append("Error: " + ex.getMessage() + "\n");
+                    } finally {
+                        poller.stop();
                     }
                 }
 
+                java.util.List<String> mismatches = controller.crossCheckChecksums(firstResult);
+                SwingUtilities.invokeLater(() -> {
+                    for (String mismatch : mismatches) {
+                        logArea.append("Checksum mismatch: " + mismatch + "\n");
+                    }
+                    if (mismatches.isEmpty()) {
+                        logArea.append("Checksums agree with the kernel spec.\n");
+                    }
+                });
+
                 if (benchmark.equals("All Benchmarks")) {
                     for (String allBenchmarks : new String[]{
                             "Static Memory Access", "Dynamic Memory Access", "Memory Allocation",
@@ -472,6 +600,22 @@ public class MainGUI extends JFrame {
                     }) {
                         controller.generateGraph(allBenchmarks);
                     }
+                    for (String userSpaceSwitch : USER_SPACE_SWITCHES) {
+                        controller.generateGraph(userSpaceSwitch);
+                    }
+                } else if (benchmark.equals("Context Switch")) {
+                    controller.generateGraph(benchmark);
+                    for (String userSpaceSwitch : USER_SPACE_SWITCHES) {
+                        controller.generateGraph(userSpaceSwitch);
+                    }
+                } else if (benchmark.equals("JNI Overhead")) {
+                    for (String jniCase : JNI_OVERHEAD_CASES) {
+                        controller.generateGraph(jniCase);
+                    }
+                } else if (benchmark.equals("False Sharing")) {
+                    for (String layout : FALSE_SHARING_LAYOUTS) {
+                        controller.generateGraph(layout);
+                    }
                 } else {
                     controller.generateGraph(benchmark);
                 }
@@ -481,6 +625,7 @@ public class MainGUI extends JFrame {
             @Override
             protected void process(java.util.List<Integer> chunks) {
                 for (int progress : chunks) {
+                    progressBar.setString(null);
                     progressBar.setValue(progress);
                     progressBar.setForeground(progress < 50 ? Color.YELLOW : Color.GREEN);
                 }
@@ -488,8 +633,9 @@ public class MainGUI extends JFrame {
 
             @Override
             protected void done() {
+                progressBar.setString(null);
                 progressBar.setValue(100);
-                logArea.append("Benchmarking Completed.\n");
+                logArea.append(isCancelRequested ? "Benchmarking Cancelled.\n" : "Benchmarking Completed.\n");
                 isBenchmarkInProgress = false;
             }
         };
@@ -497,6 +643,20 @@ public class MainGUI extends JFrame {
         worker.execute();
     }
 
+    private void showNativeProgress(int languageStep, int totalSteps, int numTests) {
+        int[] progress = controller.getNativeProgress();
+        int completedPoints = progress[3];
+        int totalPoints = progress[4];
+        if (totalPoints == 0 || completedPoints >= totalPoints) {
+            return;
+        }
+        double fraction = (completedPoints + (progress[2] + 1) / (double) numTests) / totalPoints;
+        int value = (int) ((languageStep + fraction) / totalSteps * 100);
+        progressBar.setValue(value);
+        progressBar.setString(String.format("C++ %d%% (point %d/%d, sample %d/%d)",
+                value, completedPoints + 1, totalPoints, progress[2] + 1, numTests));
+    }
+
 
     private void resetInputs() {
         if (!isBenchmarkInProgress) {
@@ -525,11 +685,23 @@ public class MainGUI extends JFrame {
                 return 6;
             case "Thread Migration":
                 return 7;
+            case "JNI Overhead":
+                return JNInterface.JNI_OVERHEAD;
+            case "False Sharing":
+                return JNInterface.FALSE_SHARING;
             default:
                 return -1;
         }
     }
 
+    // JNI overhead and false sharing only exist for the C++ library.
+    private String[] getLanguages(String benchmark) {
+        if (benchmark.equals("JNI Overhead") || benchmark.equals("False Sharing")) {
+            return new String[]{"C++"};
+        }
+        return new String[]{"C++", "C", "Java"};
+    }
+
     public static void main(String[] args) {
         SwingUtilities.invokeLater(() -> new MainGUI().setVisible(true));
 //        Controller controller = new Controller();
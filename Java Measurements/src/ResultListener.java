@@ -0,0 +1,5 @@
+// Receives each benchmark result as soon as it is saved. The C++ library calls
+// this from its result writer thread, so implementations must be thread-safe.
+public interface ResultListener {
+    void onResult(BenchmarkResult result);
+}
@@ -7,6 +7,9 @@
 #include <time.h>
 #include <sys/time.h>
 #include "BenchmarkEngine.h"
+
+static jlong migrationChecksum;
+
 JNIEXPORT jdouble JNICALL Java_BenchmarkEngine_measureThreadMigrationTime(JNIEnv *env, jobject obj, jint iterations) {
     cpu_set_t cpuset;
     CPU_ZERO(&cpuset);
@@ -35,12 +38,14 @@ JNIEXPORT jdouble JNICALL Java_BenchmarkEngine_measureThreadMigrationTime(JNIEnv
             //exit(EXIT_FAILURE);
         }
         struct timespec start, end;
+        jlong migrations = 0;
         clock_gettime(CLOCK_MONOTONIC, &start);
         for (int i = 0; i < iterations; i++)
         {
             CPU_ZERO(&cpuset);
             CPU_SET(i % 2, &cpuset);
             int s2 = pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+            migrations += s2 == 0;
             if (s2 != 0)
             {
                 perror("Failed to set affinity in iteration");
@@ -48,6 +53,7 @@ JNIEXPORT jdouble JNICALL Java_BenchmarkEngine_measureThreadMigrationTime(JNIEnv
             }
         }
         clock_gettime(CLOCK_MONOTONIC, &end);
+        migrationChecksum = migrations;
 
         if (pthread_join(thread, NULL) != 0)
         {
@@ -58,3 +64,7 @@ JNIEXPORT jdouble JNICALL Java_BenchmarkEngine_measureThreadMigrationTime(JNIEnv
         return time / iterations;
 
 }
+
+JNIEXPORT jlong JNICALL Java_BenchmarkEngine_getThreadMigrationChecksum(JNIEnv *env, jobject obj) {
+    return migrationChecksum;
+}